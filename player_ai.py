@@ -0,0 +1,62 @@
+import random
+
+import player_ai_c as player
+
+# Same strategy as src/player_ai_backend/player_ai_c.c.
+#
+# context['visibleMonsters'] is sorted by distance, nearest first, and each
+# monster carries its distance, bearing and relativeAngle to the ship's heading.
+# It also supports the buffer protocol: with numpy installed,
+# numpy.asarray(context['visibleMonsters']) is a float32 (count, 8) array of
+# x, y, size, health, invincible, distance, bearing, relativeAngle rows
+# (column indices player_ai_c.MONSTER_*), shared with the game without a copy.
+
+RANGE_ANGLE = 7.5
+MIN_DISTANCE = 250.0
+
+
+def clamp_angle(angle):
+    return angle % 360.0
+
+
+def nearest_monster(context, skip_invincible):
+    for monster in context['visibleMonsters']:
+        if not (skip_invincible and monster['invincible']):
+            return monster
+    return None
+
+
+def is_monster_on_the_way(monster):
+    return clamp_angle(monster['relativeAngle']) < 15.0
+
+
+def on_player_update(context):
+    target = nearest_monster(context, False)
+    if target is None:
+        vulnerable = nearest_monster(context, True)
+        if vulnerable is not None and is_monster_on_the_way(vulnerable):
+            player.shoot(random.randrange(3))
+            return
+        player.shoot(random.randrange(3))
+        player.set_thrusters(1.0, 1.0)
+        return
+
+    distance = target['distance']
+    angle_diff = clamp_angle(target['relativeAngle'])
+
+    if distance < MIN_DISTANCE:
+        player.shoot(player.SHOOT_FORWARD)
+        player.set_thrusters(-1.0, -1.0)
+    elif abs(angle_diff) > RANGE_ANGLE:
+        if is_monster_on_the_way(target):
+            player.set_thrusters(1.0, 0.0)
+            player.shoot(player.SHOOT_LEFT if angle_diff > 180.0 else player.SHOOT_RIGHT)
+        elif angle_diff > 180.0:
+            player.set_thrusters(1.0, 0.0)
+            player.shoot(player.SHOOT_LEFT)
+        else:
+            player.set_thrusters(0.0, 1.0)
+            player.shoot(player.SHOOT_RIGHT)
+    else:
+        player.set_thrusters(1.0, 1.0)
+        player.shoot(player.SHOOT_FORWARD)
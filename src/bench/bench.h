@@ -0,0 +1,42 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdbool.h>
+
+// Minimal micro-benchmark helpers shared by the bench target. Every measurement is printed
+// as one JSON object per line so results can be diffed and plotted by scripts.
+
+// Each measurement runs for at least this long, after one untimed warm-up round
+#define BENCH_MIN_SECONDS 0.25
+
+typedef struct BenchTiming
+{
+    long operations;
+    double seconds;
+    long allocations;   // Heap allocations made while timing, -1 where they cannot be counted
+} BenchTiming;
+
+typedef void (*BenchStep)(void* context);
+
+double BenchNow(void);
+// Total malloc, calloc and realloc calls so far, or -1 when the build does not count them
+long BenchAllocationCount(void);
+
+// Runs reset (untimed, may be NULL) then run (timed) until BENCH_MIN_SECONDS of run have been measured
+BenchTiming BenchMeasure(void* context, BenchStep reset, BenchStep run, long operationsPerRun);
+void BenchReport(const char* benchmark, const char* variant, int count, BenchTiming timing);
+
+// Whether a benchmark matches the filter given on the command line (all do without one)
+bool BenchSelected(const char* benchmark);
+
+// Keeps the optimizer from discarding a computed value
+void BenchConsume(long value);
+// Fixture layouts come from a seeded generator, so every run measures the same worlds
+void BenchSeedRandom(unsigned int seed);
+float BenchRandomRange(float min, float max);
+
+void RunCollisionBenchmarks(void);
+void RunSimulationBenchmarks(void);
+void RunEnvironmentBenchmarks(void);
+
+#endif // BENCH_H
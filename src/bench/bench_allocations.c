@@ -0,0 +1,40 @@
+#include "bench.h"
+#include <stddef.h>
+
+// Linux builds of the bench target link with --wrap for malloc, calloc and realloc, which sends every call made
+// by the game code (but not by libc itself) through the counters below. Other platforms report null.
+#ifdef BENCH_COUNT_ALLOCATIONS
+static long g_allocationCount = 0;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* pointer, size_t size);
+
+void* __wrap_malloc(const size_t size)
+{
+    g_allocationCount++;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(const size_t count, const size_t size)
+{
+    g_allocationCount++;
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* pointer, const size_t size)
+{
+    g_allocationCount++;
+    return __real_realloc(pointer, size);
+}
+
+long BenchAllocationCount(void)
+{
+    return g_allocationCount;
+}
+#else
+long BenchAllocationCount(void)
+{
+    return -1;
+}
+#endif
@@ -0,0 +1,155 @@
+#include "bench.h"
+#include "../game.h"
+#include "../collision_grid.h"
+#include "../config.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Projectile-vs-monster broadphase: linear scan over every monster against a uniform grid
+// rebuilt once per tick, as UpdateProjectiles does. The count is the number of monsters;
+// one operation is one projectile resolved, the grid cost includes its per-tick rebuild.
+// The crossovers depend on how many projectiles share a rebuild, so a sparse, a light and a
+// heavy projectile load are measured: with few projectiles the rebuild of a large grid costs
+// more than the scans it saves.
+
+#define COLLISION_BENCH_MAX_PROJECTILES 4096
+#define COLLISION_BENCH_PROJECTILES_PER_RUN (1 << 18)
+
+long ResolveBruteForce(const Rectangle* hitboxes, const int monsterCount, const Rectangle* projectiles, const int projectileCount)
+{
+    long hits = 0;
+    for (int p = 0; p < projectileCount; p++)
+    {
+        for (int m = 0; m < monsterCount; m++)
+        {
+            if (RectanglesOverlap(projectiles[p], hitboxes[m]))
+            {
+                hits += m;
+                break;
+            }
+        }
+    }
+    return hits;
+}
+
+long ResolveWithGrid(CollisionGrid* grid, const Rectangle* hitboxes, const Rectangle* paddedBoxes, const int* ids,
+                     const int monsterCount, const Rectangle* projectiles, const int projectileCount)
+{
+    BuildCollisionGrid(grid, paddedBoxes, ids, monsterCount);
+
+    long hits = 0;
+    for (int p = 0; p < projectileCount; p++)
+    {
+        const Vector2 center = { projectiles[p].x + PROJECTILE_SIZE / 2, projectiles[p].y + PROJECTILE_SIZE / 2 };
+        const int* candidates;
+        const int candidateCount = QueryCollisionGrid(grid, center, &candidates);
+        for (int c = 0; c < candidateCount; c++)
+        {
+            if (RectanglesOverlap(projectiles[p], hitboxes[candidates[c]]))
+            {
+                hits += candidates[c];
+                break;
+            }
+        }
+    }
+    return hits;
+}
+
+void RunBroadphaseSweep(const char* benchmark, const Rectangle* projectiles, const int projectileCount)
+{
+    static const int monsterCounts[] = { 1, 2, 4, 8, 16, 24, 32, 64, 128, 256, 1024, 4096 };
+    const int sweepLength = (int)(sizeof(monsterCounts) / sizeof(monsterCounts[0]));
+    const Rectangle arena = { -PROJECTILE_CULL_MARGIN, -PROJECTILE_CULL_MARGIN,
+                              SCREEN_WIDTH + 2 * PROJECTILE_CULL_MARGIN, SCREEN_HEIGHT + 2 * PROJECTILE_CULL_MARGIN };
+    const int ticks = COLLISION_BENCH_PROJECTILES_PER_RUN / projectileCount;
+    const long operations = (long)projectileCount * ticks;
+
+    int crossover = -1;
+    int fallback = -1;
+    int gateFirst = -1;
+    int gateLast = -1;
+    for (int s = 0; s < sweepLength; s++)
+    {
+        const int monsterCount = monsterCounts[s];
+        Rectangle* hitboxes = (Rectangle*)malloc(sizeof(Rectangle) * monsterCount);
+        Rectangle* paddedBoxes = (Rectangle*)malloc(sizeof(Rectangle) * monsterCount);
+        int* ids = (int*)malloc(sizeof(int) * monsterCount);
+        const float padding = PROJECTILE_SIZE / 2 + 1.0f;
+
+        for (int m = 0; m < monsterCount; m++)
+        {
+            const float size = BenchRandomRange(MONSTER_MIN_SIZE, MONSTER_MAX_SIZE);
+            const float x = BenchRandomRange(0, SCREEN_WIDTH);
+            const float y = BenchRandomRange(0, SCREEN_HEIGHT);
+            hitboxes[m] = (Rectangle){ x - size / 2, y - size / 2, size, size };
+            paddedBoxes[m] = (Rectangle){ hitboxes[m].x - padding, hitboxes[m].y - padding, size + 2 * padding, size + 2 * padding };
+            ids[m] = m;
+        }
+
+        CollisionGrid grid;
+        InitCollisionGrid(&grid, arena, COLLISION_GRID_CELL_SIZE);
+
+        long allocations = BenchAllocationCount();
+        double start = BenchNow();
+        for (int tick = 0; tick < ticks; tick++)
+        {
+            BenchConsume(ResolveBruteForce(hitboxes, monsterCount, projectiles, projectileCount));
+        }
+        const double bruteForceSeconds = BenchNow() - start;
+        allocations = allocations < 0 ? -1 : BenchAllocationCount() - allocations;
+        BenchReport(benchmark, "brute_force", monsterCount, (BenchTiming){ operations, bruteForceSeconds, allocations });
+
+        allocations = BenchAllocationCount();
+        start = BenchNow();
+        for (int tick = 0; tick < ticks; tick++)
+        {
+            BenchConsume(ResolveWithGrid(&grid, hitboxes, paddedBoxes, ids, monsterCount, projectiles, projectileCount));
+        }
+        const double gridSeconds = BenchNow() - start;
+        allocations = allocations < 0 ? -1 : BenchAllocationCount() - allocations;
+        BenchReport(benchmark, "uniform_grid", monsterCount, (BenchTiming){ operations, gridSeconds, allocations });
+
+        if (crossover < 0 && gridSeconds < bruteForceSeconds)
+            crossover = monsterCount;
+        else if (crossover >= 0 && fallback < 0 && gridSeconds >= bruteForceSeconds)
+            fallback = monsterCount;
+        if (ShouldUseCollisionGrid(monsterCount, projectileCount))
+        {
+            if (gateFirst < 0)
+                gateFirst = monsterCount;
+            gateLast = monsterCount;
+        }
+
+        FreeCollisionGrid(&grid);
+        free(ids);
+        free(paddedBoxes);
+        free(hitboxes);
+    }
+
+    // -1 when it never happens within the sweep
+    fprintf(stderr, "%s: grid faster from %d monsters, slower again from %d; UpdateProjectiles uses it from %d to %d\n",
+        benchmark, crossover, fallback, gateFirst, gateLast);
+}
+
+void RunCollisionBenchmarks(void)
+{
+    if (!BenchSelected("broadphase_8_projectiles") && !BenchSelected("broadphase_64_projectiles") &&
+        !BenchSelected("broadphase_4096_projectiles"))
+        return;
+
+    Rectangle* projectiles = (Rectangle*)malloc(sizeof(Rectangle) * COLLISION_BENCH_MAX_PROJECTILES);
+    BenchSeedRandom(1234);
+    for (int p = 0; p < COLLISION_BENCH_MAX_PROJECTILES; p++)
+    {
+        projectiles[p] = (Rectangle){ BenchRandomRange(0, SCREEN_WIDTH), BenchRandomRange(0, SCREEN_HEIGHT), PROJECTILE_SIZE, PROJECTILE_SIZE };
+    }
+
+    if (BenchSelected("broadphase_8_projectiles"))
+        RunBroadphaseSweep("broadphase_8_projectiles", projectiles, 8);
+    if (BenchSelected("broadphase_64_projectiles"))
+        RunBroadphaseSweep("broadphase_64_projectiles", projectiles, 64);
+    if (BenchSelected("broadphase_4096_projectiles"))
+        RunBroadphaseSweep("broadphase_4096_projectiles", projectiles, COLLISION_BENCH_MAX_PROJECTILES);
+
+    free(projectiles);
+}
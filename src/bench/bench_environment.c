@@ -0,0 +1,149 @@
+#include "bench.h"
+#include "../environment.h"
+#include "../game.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Many worlds stepped together, swept over environment counts: the lockstep batch, observations included, against
+// one GameState per environment fed the same commands through scriptedInput. One operation is one environment
+// advanced by one tick. Both restart the episodes that end, so resets are part of the measurement.
+
+#define ENVIRONMENT_BENCH_STEPS 64
+#define ENVIRONMENT_BENCH_SEED 1000
+
+static const int g_environmentCounts[] = { 1, 16, 256, 4096 };
+
+typedef struct EnvironmentFixture
+{
+    EnvironmentConfig config;
+    EnvironmentBatch batch;
+    GameState* games;
+    PlayerInput* actions;           // ENVIRONMENT_BENCH_STEPS rows of one action per environment
+    float* observations;
+    float* rewards;
+    unsigned char* statuses;
+    unsigned int nextSeed;
+    int count;
+} EnvironmentFixture;
+
+void FreeEnvironmentFixture(EnvironmentFixture* fixture)
+{
+    if (fixture->games)
+    {
+        for (int e = 0; e < fixture->count; e++)
+        {
+            CleanupGameState(&fixture->games[e]);
+        }
+    }
+    FreeEnvironmentBatch(&fixture->batch);
+    free(fixture->statuses);
+    free(fixture->rewards);
+    free(fixture->observations);
+    free(fixture->actions);
+    free(fixture->games);
+    memset(fixture, 0, sizeof(*fixture));
+}
+
+bool InitEnvironmentFixture(EnvironmentFixture* fixture, const int count, const bool withGameStates)
+{
+    memset(fixture, 0, sizeof(*fixture));
+    fixture->count = count;
+    InitDefaultEnvironmentConfig(&fixture->config);
+    fixture->config.environmentCount = count;
+    fixture->config.baseSeed = ENVIRONMENT_BENCH_SEED;
+
+    const size_t observationSize = ENVIRONMENT_SHIP_FEATURES + (size_t)fixture->config.observedMonsters * ENVIRONMENT_MONSTER_FEATURES;
+    fixture->actions = (PlayerInput*)malloc(sizeof(PlayerInput) * (size_t)count * ENVIRONMENT_BENCH_STEPS);
+    fixture->observations = (float*)malloc(sizeof(float) * observationSize * (size_t)count);
+    fixture->rewards = (float*)malloc(sizeof(float) * (size_t)count);
+    fixture->statuses = (unsigned char*)malloc((size_t)count);
+    if (!fixture->actions || !fixture->observations || !fixture->rewards || !fixture->statuses)
+        return false;
+
+    for (int a = 0; a < count * ENVIRONMENT_BENCH_STEPS; a++)
+    {
+        fixture->actions[a].leftThruster = BenchRandomRange(-1.0f, 1.0f);
+        fixture->actions[a].rightThruster = BenchRandomRange(-1.0f, 1.0f);
+        fixture->actions[a].shoot = BenchRandomRange(0.0f, 1.0f) < 0.5f;
+        fixture->actions[a].shootDirection = (ShootDirection)(a % SHOOT_DIRECTION_COUNT);
+    }
+
+    if (!withGameStates)
+        return InitEnvironmentBatch(&fixture->batch, &fixture->config, fixture->observations);
+
+    fixture->games = (GameState*)calloc((size_t)count, sizeof(GameState));
+    if (!fixture->games)
+        return false;
+    for (int e = 0; e < count; e++)
+    {
+        if (!InitGameState(&fixture->games[e], &fixture->config.scenario, fixture->config.baseSeed + (unsigned int)e))
+            return false;
+    }
+    fixture->nextSeed = fixture->config.baseSeed + (unsigned int)count;
+    return true;
+}
+
+void RunEnvironmentBatch(void* context)
+{
+    EnvironmentFixture* fixture = (EnvironmentFixture*)context;
+    for (int s = 0; s < ENVIRONMENT_BENCH_STEPS; s++)
+    {
+        StepEnvironmentBatch(&fixture->batch, &fixture->actions[s * fixture->count], fixture->observations,
+            fixture->rewards, fixture->statuses);
+    }
+    BenchConsume(fixture->batch.projectiles.count);
+}
+
+void RunEnvironmentGameStates(void* context)
+{
+    EnvironmentFixture* fixture = (EnvironmentFixture*)context;
+    const EnvironmentConfig* config = &fixture->config;
+    for (int s = 0; s < ENVIRONMENT_BENCH_STEPS; s++)
+    {
+        for (int e = 0; e < fixture->count; e++)
+        {
+            GameState* game = &fixture->games[e];
+            game->scriptedInput = &fixture->actions[s * fixture->count + e];
+            UpdateGameState(game, config->deltaTime);
+
+            if (IsPlayerDead(&game->player) || AreAllMonstersDead(game))
+            {
+                CleanupGameState(game);
+                if (!InitGameState(game, &config->scenario, fixture->nextSeed++))
+                    return;
+            }
+        }
+    }
+    BenchConsume(fixture->games[0].projectiles.count);
+}
+
+void RunEnvironmentBenchmarks(void)
+{
+    const int sweepLength = (int)(sizeof(g_environmentCounts) / sizeof(g_environmentCounts[0]));
+    static EnvironmentFixture fixture;
+    if (!BenchSelected("environment_step"))
+        return;
+    BenchSeedRandom(4321);
+
+    for (int variant = 0; variant < 2; variant++)
+    {
+        const bool withGameStates = variant == 1;
+
+        for (int s = 0; s < sweepLength; s++)
+        {
+            const int count = g_environmentCounts[s];
+            if (!InitEnvironmentFixture(&fixture, count, withGameStates))
+            {
+                fprintf(stderr, "environment_step: failed to set up %d environments\n", count);
+                FreeEnvironmentFixture(&fixture);
+                continue;
+            }
+
+            const BenchTiming timing = BenchMeasure(&fixture, NULL, withGameStates ? RunEnvironmentGameStates : RunEnvironmentBatch,
+                (long)count * ENVIRONMENT_BENCH_STEPS);
+            BenchReport("environment_step", withGameStates ? "scripted_game_states" : "lockstep_batch", count, timing);
+            FreeEnvironmentFixture(&fixture);
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#include "bench.h"
+#include "../random.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static volatile long g_benchSink = 0;
+static const char* g_benchFilter = NULL;
+static Random g_benchRandom;
+
+double BenchNow(void)
+{
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+BenchTiming BenchMeasure(void* context, const BenchStep reset, const BenchStep run, const long operationsPerRun)
+{
+    // The warm-up lets pools, arenas and stores grow to their steady-state size before anything is counted
+    if (reset)
+        reset(context);
+    run(context);
+
+    BenchTiming timing = { 0, 0.0, 0 };
+    const long allocationsBefore = BenchAllocationCount();
+    while (timing.seconds < BENCH_MIN_SECONDS)
+    {
+        if (reset)
+            reset(context);
+
+        const double start = BenchNow();
+        run(context);
+        timing.seconds += BenchNow() - start;
+        timing.operations += operationsPerRun;
+    }
+    timing.allocations = allocationsBefore < 0 ? -1 : BenchAllocationCount() - allocationsBefore;
+    return timing;
+}
+
+void BenchReport(const char* benchmark, const char* variant, const int count, const BenchTiming timing)
+{
+    const double nsPerOp = timing.operations > 0 ? timing.seconds * 1e9 / (double)timing.operations : 0.0;
+    const double opsPerSecond = timing.seconds > 0.0 ? (double)timing.operations / timing.seconds : 0.0;
+
+    char allocationsPerOp[32] = "null";
+    if (timing.allocations >= 0 && timing.operations > 0)
+        snprintf(allocationsPerOp, sizeof(allocationsPerOp), "%.4f", (double)timing.allocations / (double)timing.operations);
+
+    printf("{\"benchmark\":\"%s\",\"variant\":\"%s\",\"count\":%d,\"operations\":%ld,\"nsPerOp\":%.2f,\"allocationsPerOp\":%s,\"opsPerSecond\":%.0f}\n",
+        benchmark, variant, count, timing.operations, nsPerOp, allocationsPerOp, opsPerSecond);
+    fflush(stdout);
+}
+
+bool BenchSelected(const char* benchmark)
+{
+    return g_benchFilter == NULL || strstr(benchmark, g_benchFilter) != NULL;
+}
+
+void BenchConsume(const long value)
+{
+    g_benchSink += value;
+}
+
+void BenchSeedRandom(const unsigned int seed)
+{
+    SeedRandom(&g_benchRandom, seed, RANDOM_STREAM_WORLD);
+}
+
+float BenchRandomRange(const float min, const float max)
+{
+    return RandomRange(&g_benchRandom, min, max);
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 2 || (argc == 2 && argv[1][0] == '-'))
+    {
+        fprintf(stderr, "Usage: %s [benchmark name filter]\n", argv[0]);
+        return 1;
+    }
+    if (argc == 2)
+        g_benchFilter = argv[1];
+
+    RunCollisionBenchmarks();
+    RunSimulationBenchmarks();
+    RunEnvironmentBenchmarks();
+    return 0;
+}
@@ -0,0 +1,330 @@
+#include "bench.h"
+#include "../game.h"
+#include "../player_control.h"
+#include "../config.h"
+#include "../snapshot.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Steps of UpdateGameState timed one at a time, each swept over entity counts. The count is the number of
+// projectiles for projectile steps (fighting SIMULATION_BENCH_MONSTERS monsters) and the number of monsters
+// otherwise; one operation is one entity processed, except for is_position_safe where it is one query and the
+// snapshot and forecast benchmarks where it is one whole snapshot or rollout.
+// Worlds are laid out at random rather than by InitGameState, whose safe placement is quadratic in the monster
+// count. Whatever a step consumes (projectiles, monster health, pooled effects, arena space) is restored from a
+// template before every run, outside the timed region.
+
+#define SIMULATION_BENCH_MONSTERS 64
+#define SIMULATION_BENCH_QUERIES 64
+#define SIMULATION_BENCH_FORECAST_TICKS 120
+
+static const int g_entityCounts[] = { 10, 100, 1000, 10000, 100000 };
+
+typedef struct SimulationFixture
+{
+    GameState game;
+    Monster* monsterTemplate;
+    ProjectileStore projectileTemplate;
+    MonsterView* visibleMonsters;
+    MonsterView* sortScratch;
+    GameSnapshot snapshot;
+    PlayerControl control;
+    PlayerInput forecastInputs[SIMULATION_BENCH_FORECAST_TICKS];
+    Vector2 queries[SIMULATION_BENCH_QUERIES];
+    int count;
+} SimulationFixture;
+
+typedef struct SimulationBenchmark
+{
+    const char* name;
+    const char* variant;
+    bool countsProjectiles;
+    int operationsPerRun;   // 0 for one operation per entity
+    void (*prepare)(SimulationFixture* fixture);
+    BenchStep reset;
+    BenchStep run;
+} SimulationBenchmark;
+
+Vector2 RandomArenaPosition(const GameState* game)
+{
+    return (Vector2){ BenchRandomRange(0, game->scenario.arenaWidth), BenchRandomRange(0, game->scenario.arenaHeight) };
+}
+
+bool InitSimulationFixture(SimulationFixture* fixture, const int monsterCount, const int projectileCount)
+{
+    memset(fixture, 0, sizeof(*fixture));
+
+    Scenario scenario;
+    InitDefaultScenario(&scenario);
+    scenario.monsterCount = monsterCount;
+    if (!AllocateGameState(&fixture->game, &scenario))
+        return false;
+
+    GameState* game = &fixture->game;
+    for (int m = 0; m < monsterCount; m++)
+    {
+        InitMonster(&game->monsters[m], RandomArenaPosition(game), BenchRandomRange(MONSTER_MIN_SIZE, MONSTER_MAX_SIZE));
+    }
+    InitPlayer(&game->player, (Vector2){ scenario.arenaWidth / 2, scenario.arenaHeight / 2 }, PLAYER_SIZE);
+
+    fixture->monsterTemplate = (Monster*)malloc(sizeof(Monster) * (size_t)monsterCount);
+    fixture->visibleMonsters = (MonsterView*)malloc(sizeof(MonsterView) * (size_t)monsterCount);
+    fixture->sortScratch = (MonsterView*)malloc(sizeof(MonsterView) * (size_t)monsterCount);
+    if (!fixture->monsterTemplate || !fixture->visibleMonsters || !fixture->sortScratch ||
+        !InitProjectileStore(&fixture->projectileTemplate, projectileCount > 0 ? projectileCount : 1) ||
+        !ReserveProjectiles(&game->projectiles, projectileCount))
+        return false;
+    memcpy(fixture->monsterTemplate, game->monsters, sizeof(Monster) * (size_t)monsterCount);
+
+    for (int p = 0; p < projectileCount; p++)
+    {
+        const float angle = BenchRandomRange(0, 2 * PI);
+        const Vector2 velocity = { cosf(angle) * PROJECTILE_SPEED, sinf(angle) * PROJECTILE_SPEED };
+        const bool fromPlayer = p % 2 == 0;
+        AddProjectile(&fixture->projectileTemplate, RandomArenaPosition(game), velocity,
+            fromPlayer ? PROJECTILE_PLAYER : PROJECTILE_MONSTER, fromPlayer ? -1 : p % monsterCount);
+    }
+
+    for (int q = 0; q < SIMULATION_BENCH_QUERIES; q++)
+    {
+        fixture->queries[q] = RandomArenaPosition(game);
+    }
+    return true;
+}
+
+void FreeSimulationFixture(SimulationFixture* fixture)
+{
+    EndPlayerAI(&fixture->control);
+    FreeGameSnapshot(&fixture->snapshot);
+    FreeProjectileStore(&fixture->projectileTemplate);
+    free(fixture->sortScratch);
+    free(fixture->visibleMonsters);
+    free(fixture->monsterTemplate);
+    CleanupGameState(&fixture->game);
+}
+
+// Every eighth projectile is left for the kernel under test to remove
+void PlaceProjectilesOutOfBounds(SimulationFixture* fixture)
+{
+    ProjectileStore* store = &fixture->projectileTemplate;
+    for (int p = 0; p < store->count; p += 8)
+    {
+        store->x[p] = -PROJECTILE_CULL_MARGIN - PROJECTILE_SIZE;
+    }
+}
+
+void MarkProjectilesDead(SimulationFixture* fixture)
+{
+    ProjectileStore* store = &fixture->projectileTemplate;
+    for (int p = 0; p < store->count; p += 8)
+    {
+        store->owner[p] |= PROJECTILE_DEAD_FLAG;
+    }
+}
+
+void RestoreProjectiles(void* context)
+{
+    SimulationFixture* fixture = (SimulationFixture*)context;
+    const ProjectileStore* source = &fixture->projectileTemplate;
+    ProjectileStore* store = &fixture->game.projectiles;
+    const size_t count = (size_t)source->count;
+
+    memcpy(store->x, source->x, sizeof(float) * count);
+    memcpy(store->y, source->y, sizeof(float) * count);
+    memcpy(store->velocityX, source->velocityX, sizeof(float) * count);
+    memcpy(store->velocityY, source->velocityY, sizeof(float) * count);
+    memcpy(store->owner, source->owner, count);
+    memcpy(store->monsterIndex, source->monsterIndex, sizeof(int) * count);
+    store->count = source->count;
+    store->playerCount = source->playerCount;
+    store->snapshotId = 0;
+}
+
+void RestoreWorld(void* context)
+{
+    SimulationFixture* fixture = (SimulationFixture*)context;
+    GameState* game = &fixture->game;
+
+    memcpy(game->monsters, fixture->monsterTemplate, sizeof(Monster) * (size_t)game->scenario.monsterCount);
+    game->player.health = 1.0f;
+    game->player.shootTimer = 0.0f;
+    game->projectiles.count = 0;
+    game->projectiles.playerCount = 0;
+    ClearEffectPool(&game->hitEffects);
+    ResetFrameArena(&game->frameArena);
+}
+
+void RestoreWorldAndProjectiles(void* context)
+{
+    RestoreWorld(context);
+    RestoreProjectiles(context);
+}
+
+void RunUpdateProjectiles(void* context)
+{
+    SimulationFixture* fixture = (SimulationFixture*)context;
+    UpdateProjectiles(&fixture->game, SIMULATION_FIXED_DELTA_TIME);
+    BenchConsume(fixture->game.projectiles.count);
+}
+
+void RunCullProjectiles(void* context)
+{
+    SimulationFixture* fixture = (SimulationFixture*)context;
+    CullProjectilesOutOfBounds(&fixture->game.projectiles, GetProjectileBounds(&fixture->game));
+    BenchConsume(fixture->game.projectiles.count);
+}
+
+void RunRemoveDeadProjectiles(void* context)
+{
+    SimulationFixture* fixture = (SimulationFixture*)context;
+    RemoveDeadProjectiles(&fixture->game.projectiles);
+    BenchConsume(fixture->game.projectiles.count);
+}
+
+void RunBuildVisibleMonsters(void* context)
+{
+    SimulationFixture* fixture = (SimulationFixture*)context;
+    int visibleCount;
+    BuildVisibleMonstersArray(&fixture->game, fixture->visibleMonsters, fixture->sortScratch, &visibleCount);
+    BenchConsume(visibleCount);
+}
+
+void RunApplyProximityDamage(void* context)
+{
+    SimulationFixture* fixture = (SimulationFixture*)context;
+    ApplyProximityDamageToPlayer(&fixture->game, SIMULATION_FIXED_DELTA_TIME);
+    BenchConsume((long)(fixture->game.player.health * 1000.0f));
+}
+
+void RunPlayerAITick(void* context)
+{
+    SimulationFixture* fixture = (SimulationFixture*)context;
+    ProcessPlayerAIAndShooting(&fixture->game, SIMULATION_FIXED_DELTA_TIME);
+    BenchConsume(fixture->game.projectiles.count);
+}
+
+void RunCreateHitEffects(void* context)
+{
+    SimulationFixture* fixture = (SimulationFixture*)context;
+    for (int i = 0; i < fixture->count; i++)
+    {
+        CreateHitEffect(&fixture->game, fixture->queries[i % SIMULATION_BENCH_QUERIES], ORANGE);
+    }
+    BenchConsume(fixture->game.hitEffects.count);
+}
+
+void RunIsPositionSafe(void* context)
+{
+    SimulationFixture* fixture = (SimulationFixture*)context;
+    long safeCount = 0;
+    for (int q = 0; q < SIMULATION_BENCH_QUERIES; q++)
+    {
+        safeCount += IsPositionSafe(fixture->queries[q], fixture->game.monsters, fixture->game.scenario.monsterCount, PLAYER_SIZE * 3);
+    }
+    BenchConsume(safeCount);
+}
+
+void CaptureFixtureSnapshot(SimulationFixture* fixture)
+{
+    RestoreWorldAndProjectiles(fixture);
+    CaptureGameSnapshot(&fixture->snapshot, &fixture->game);
+}
+
+void MarkProjectilesChanged(void* context)
+{
+    SimulationFixture* fixture = (SimulationFixture*)context;
+    fixture->game.projectiles.snapshotId = 0;
+}
+
+void RunCaptureSnapshot(void* context)
+{
+    SimulationFixture* fixture = (SimulationFixture*)context;
+    CaptureGameSnapshot(&fixture->snapshot, &fixture->game);
+    BenchConsume((long)fixture->snapshot.size);
+}
+
+void RunRestoreSnapshot(void* context)
+{
+    SimulationFixture* fixture = (SimulationFixture*)context;
+    RestoreGameSnapshot(&fixture->snapshot, &fixture->game);
+    BenchConsume(fixture->game.projectiles.count);
+}
+
+// The world the forecasts play in is gathered once per tick, by the first one, so runs only time the rollouts
+void PrepareForecast(SimulationFixture* fixture)
+{
+    RestoreWorldAndProjectiles(fixture);
+    BeginPlayerAI(&fixture->control, &fixture->game, SIMULATION_FIXED_DELTA_TIME, NULL, 0);
+    for (int t = 0; t < SIMULATION_BENCH_FORECAST_TICKS; t++)
+    {
+        fixture->forecastInputs[t] = (PlayerInput){ 1.0f, 0.5f, true, (ShootDirection)(t % SHOOT_DIRECTION_COUNT) };
+    }
+
+    PlayerForecastResult forecast;
+    PlayerControlForecast(&fixture->control, fixture->forecastInputs, SIMULATION_BENCH_FORECAST_TICKS, &forecast);
+}
+
+void RunForecast(void* context)
+{
+    SimulationFixture* fixture = (SimulationFixture*)context;
+    PlayerForecastResult forecast;
+    PlayerControlForecast(&fixture->control, fixture->forecastInputs, SIMULATION_BENCH_FORECAST_TICKS, &forecast);
+    BenchConsume((long)(forecast.health * 1000.0f) + forecast.ticks);
+}
+
+// player_ai_tick stands in for the old JSON context serialization: it is the whole per-tick cost of handing the
+// world to the AI (visible monster list, context, linked C AI) and applying its commands.
+static const SimulationBenchmark g_simulationBenchmarks[] =
+{
+    { "update_projectiles", "64_monsters", true, 0, NULL, RestoreWorldAndProjectiles, RunUpdateProjectiles },
+    { "cull_projectiles_out_of_bounds", "one_in_8_removed", true, 0, PlaceProjectilesOutOfBounds, RestoreProjectiles, RunCullProjectiles },
+    { "remove_dead_projectiles", "one_in_8_removed", true, 0, MarkProjectilesDead, RestoreProjectiles, RunRemoveDeadProjectiles },
+    { "build_visible_monsters", "sorted", false, 0, NULL, NULL, RunBuildVisibleMonsters },
+    { "apply_proximity_damage", "linear", false, 0, NULL, RestoreWorld, RunApplyProximityDamage },
+    { "player_ai_tick", "c_ai", false, 0, NULL, RestoreWorld, RunPlayerAITick },
+    { "create_hit_effect", "pooled", false, 0, NULL, RestoreWorld, RunCreateHitEffects },
+    { "is_position_safe", "linear", false, SIMULATION_BENCH_QUERIES, NULL, NULL, RunIsPositionSafe },
+    { "snapshot_capture", "projectiles_changed", true, 1, NULL, RestoreWorldAndProjectiles, RunCaptureSnapshot },
+    { "snapshot_restore", "projectiles_changed", true, 1, CaptureFixtureSnapshot, MarkProjectilesChanged, RunRestoreSnapshot },
+    { "snapshot_restore", "projectiles_unchanged", true, 1, CaptureFixtureSnapshot, NULL, RunRestoreSnapshot },
+    { "player_forecast", "120_ticks", true, 1, PrepareForecast, NULL, RunForecast },
+};
+
+void RunSimulationBenchmarks(void)
+{
+    const int benchmarkCount = (int)(sizeof(g_simulationBenchmarks) / sizeof(g_simulationBenchmarks[0]));
+    const int sweepLength = (int)(sizeof(g_entityCounts) / sizeof(g_entityCounts[0]));
+    static SimulationFixture fixture;
+    BenchSeedRandom(1234);
+
+    for (int b = 0; b < benchmarkCount; b++)
+    {
+        const SimulationBenchmark* benchmark = &g_simulationBenchmarks[b];
+        if (!BenchSelected(benchmark->name))
+            continue;
+
+        for (int s = 0; s < sweepLength; s++)
+        {
+            const int count = g_entityCounts[s];
+            const int monsterCount = benchmark->countsProjectiles ? SIMULATION_BENCH_MONSTERS : count;
+            const int projectileCount = benchmark->countsProjectiles ? count : 0;
+            if (!InitSimulationFixture(&fixture, monsterCount, projectileCount))
+            {
+                fprintf(stderr, "%s: failed to set up %d entities\n", benchmark->name, count);
+                FreeSimulationFixture(&fixture);
+                continue;
+            }
+            fixture.count = count;
+            if (benchmark->prepare)
+                benchmark->prepare(&fixture);
+
+            const long operationsPerRun = benchmark->operationsPerRun > 0 ? benchmark->operationsPerRun : count;
+            const BenchTiming timing = BenchMeasure(&fixture, benchmark->reset, benchmark->run, operationsPerRun);
+            BenchReport(benchmark->name, benchmark->variant, count, timing);
+
+            FreeSimulationFixture(&fixture);
+        }
+    }
+}
@@ -0,0 +1,126 @@
+#include "collision_grid.h"
+#include "config.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+bool InitCollisionGrid(CollisionGrid* grid, const Rectangle bounds, const float cellSize)
+{
+    memset(grid, 0, sizeof(CollisionGrid));
+    grid->originX = bounds.x;
+    grid->originY = bounds.y;
+    grid->cellSize = cellSize;
+    grid->columns = (int)ceilf(bounds.width / cellSize);
+    grid->rows = (int)ceilf(bounds.height / cellSize);
+    if (grid->columns < 1)
+        grid->columns = 1;
+    if (grid->rows < 1)
+        grid->rows = 1;
+
+    grid->cellStart = (int*)calloc((size_t)(grid->columns * grid->rows + 1), sizeof(int));
+    grid->itemCapacity = 16;
+    grid->items = (int*)malloc(sizeof(int) * (size_t)grid->itemCapacity);
+    return grid->cellStart != NULL && grid->items != NULL;
+}
+
+void FreeCollisionGrid(CollisionGrid* grid)
+{
+    free(grid->cellStart);
+    free(grid->items);
+    memset(grid, 0, sizeof(CollisionGrid));
+}
+
+int GetCollisionGridColumn(const CollisionGrid* grid, const float x)
+{
+    const int column = (int)floorf((x - grid->originX) / grid->cellSize);
+    if (column < 0)
+        return 0;
+    if (column >= grid->columns)
+        return grid->columns - 1;
+    return column;
+}
+
+int GetCollisionGridRow(const CollisionGrid* grid, const float y)
+{
+    const int row = (int)floorf((y - grid->originY) / grid->cellSize);
+    if (row < 0)
+        return 0;
+    if (row >= grid->rows)
+        return grid->rows - 1;
+    return row;
+}
+
+bool ShouldUseCollisionGrid(const int monsterCount, const int projectileCount)
+{
+    return monsterCount >= COLLISION_GRID_MIN_MONSTERS && projectileCount >= COLLISION_GRID_MIN_PROJECTILES &&
+           monsterCount <= projectileCount * COLLISION_GRID_MAX_MONSTERS_PER_PROJECTILE;
+}
+
+bool BuildCollisionGrid(CollisionGrid* grid, const Rectangle* boxes, const int* ids, const int count)
+{
+    const int cellCount = grid->columns * grid->rows;
+    int* cellStart = grid->cellStart;
+    memset(cellStart, 0, sizeof(int) * (size_t)(cellCount + 1));
+
+    // Counting pass: cellStart[cell + 1] receives the number of boxes overlapping each cell
+    int itemCount = 0;
+    for (int i = 0; i < count; i++)
+    {
+        const int firstColumn = GetCollisionGridColumn(grid, boxes[i].x);
+        const int lastColumn = GetCollisionGridColumn(grid, boxes[i].x + boxes[i].width);
+        const int firstRow = GetCollisionGridRow(grid, boxes[i].y);
+        const int lastRow = GetCollisionGridRow(grid, boxes[i].y + boxes[i].height);
+
+        for (int row = firstRow; row <= lastRow; row++)
+        {
+            for (int column = firstColumn; column <= lastColumn; column++)
+            {
+                cellStart[row * grid->columns + column + 1]++;
+            }
+        }
+        itemCount += (lastColumn - firstColumn + 1) * (lastRow - firstRow + 1);
+    }
+
+    if (itemCount > grid->itemCapacity)
+    {
+        int* items = (int*)realloc(grid->items, sizeof(int) * (size_t)itemCount);
+        if (!items)
+            return false;
+        grid->items = items;
+        grid->itemCapacity = itemCount;
+    }
+
+    for (int cell = 0; cell < cellCount; cell++)
+    {
+        cellStart[cell + 1] += cellStart[cell];
+    }
+
+    // Filling pass: cellStart[cell] is used as the write cursor and ends up at the next cell's start,
+    // so shifting the array by one afterwards restores the offsets
+    for (int i = 0; i < count; i++)
+    {
+        const int firstColumn = GetCollisionGridColumn(grid, boxes[i].x);
+        const int lastColumn = GetCollisionGridColumn(grid, boxes[i].x + boxes[i].width);
+        const int firstRow = GetCollisionGridRow(grid, boxes[i].y);
+        const int lastRow = GetCollisionGridRow(grid, boxes[i].y + boxes[i].height);
+
+        for (int row = firstRow; row <= lastRow; row++)
+        {
+            for (int column = firstColumn; column <= lastColumn; column++)
+            {
+                grid->items[cellStart[row * grid->columns + column]++] = ids[i];
+            }
+        }
+    }
+
+    memmove(cellStart + 1, cellStart, sizeof(int) * (size_t)cellCount);
+    cellStart[0] = 0;
+    return true;
+}
+
+int QueryCollisionGrid(const CollisionGrid* grid, const Vector2 point, const int** outItems)
+{
+    const int cell = GetCollisionGridRow(grid, point.y) * grid->columns + GetCollisionGridColumn(grid, point.x);
+    *outItems = grid->items + grid->cellStart[cell];
+    return grid->cellStart[cell + 1] - grid->cellStart[cell];
+}
@@ -0,0 +1,34 @@
+#ifndef COLLISION_GRID_H
+#define COLLISION_GRID_H
+
+#include "raylib.h"
+
+// Uniform grid over the arena used as a broadphase. Boxes are registered in every cell they
+// overlap, so a point query only has to look at the single cell containing the point.
+// Items inside a cell keep the order they were given to BuildCollisionGrid.
+typedef struct CollisionGrid
+{
+    float originX;
+    float originY;
+    float cellSize;
+    int columns;
+    int rows;
+    int* cellStart;     // columns * rows + 1 offsets into items
+    int* items;
+    int itemCapacity;
+} CollisionGrid;
+
+bool InitCollisionGrid(CollisionGrid* grid, Rectangle bounds, float cellSize);
+void FreeCollisionGrid(CollisionGrid* grid);
+
+// Whether a grid rebuilt for monsterCount boxes pays off over a linear scan for projectileCount point queries
+bool ShouldUseCollisionGrid(int monsterCount, int projectileCount);
+
+// Rebuilds the grid from scratch; ids[i] is the value stored for boxes[i]
+bool BuildCollisionGrid(CollisionGrid* grid, const Rectangle* boxes, const int* ids, int count);
+
+// Returns the number of items registered in the cell containing point and points outItems at them.
+// Points outside the grid map to the nearest border cell.
+int QueryCollisionGrid(const CollisionGrid* grid, Vector2 point, const int** outItems);
+
+#endif // COLLISION_GRID_H
@@ -7,13 +7,20 @@
 #define SCREEN_WIDTH 1280
 #define SCREEN_HEIGHT 720
 
+// Simulation settings
+#define SIMULATION_TICK_RATE 120
+#define SIMULATION_FIXED_DELTA_TIME (1.0f / SIMULATION_TICK_RATE)
+#define SIMULATION_MAX_FRAME_TIME 0.25f     // Longest frame fed to the accumulator, avoids a spiral of death
+#define FRAME_ARENA_AI_CAPACITY (64 * 1024) // Per-tick scratch for AI code, on top of the engine's own needs
+
 // Player settings
 #define PLAYER_SIZE 60.0f
 #define PLAYER_THRUST_POWER 300.0f
 #define PLAYER_TURN_RATE 180.0f
 #define PLAYER_MAX_SPEED 200.0f
 #define PLAYER_SHOOT_COOLDOWN 0.2f
-#define PLAYER_DRAG 0.98f
+#define PLAYER_DRAG 0.98f                   // Fraction of velocity kept every 1/PLAYER_DRAG_REFERENCE_RATE seconds
+#define PLAYER_DRAG_REFERENCE_RATE 60.0f
 #define PLAYER_VISION_RADIUS 400.0f
 
 // Monster settings
@@ -38,10 +45,18 @@
 // Projectile settings
 #define PROJECTILE_SPEED 400.0f
 #define PROJECTILE_SIZE 10.0f
+#define PROJECTILE_CULL_MARGIN 50.0f        // Distance outside the arena at which projectiles are removed
+#define PROJECTILE_INITIAL_CAPACITY 64
 #define PROJECTILE_PLAYER_COLOR ORANGE
 #define PROJECTILE_MONSTER_COLOR PURPLE
 #define PROJECTILE_MONSTER_SPREAD_COLOR ((Color){0, 255, 255, 255})
 
+// Collision settings
+#define COLLISION_GRID_CELL_SIZE 128.0f
+#define COLLISION_GRID_MIN_MONSTERS 8      // Below this many hittable monsters a linear scan beats the grid (see bench)
+#define COLLISION_GRID_MIN_PROJECTILES 16  // Below this many player projectiles the rebuild costs more than the scans
+#define COLLISION_GRID_MAX_MONSTERS_PER_PROJECTILE 2 // Beyond this, too few projectiles share the rebuild to pay for it
+
 // Damage settings
 #define DAMAGE_PLAYER_PROJECTILE 0.05f      // 5% damage per player projectile hit
 #define DAMAGE_MONSTER_PROJECTILE 0.15f     // 15% damage per monster projectile hit
@@ -55,7 +70,7 @@
 #define EXPLOSION_FADE_DURATION 2.0f        // Duration of fade out
 
 // Hit effect settings
-#define HIT_EFFECT_MAX_COUNT 100
+#define HIT_EFFECT_INITIAL_CAPACITY 100  // The pool grows past this when needed
 #define HIT_EFFECT_DURATION 0.3f
 #define HIT_EFFECT_SIZE 15.0f
 #define HIT_EFFECT_PARTICLE_COUNT 8
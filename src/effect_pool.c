@@ -0,0 +1,73 @@
+#include "effect_pool.h"
+#include <stdlib.h>
+#include <string.h>
+
+bool InitEffectPool(EffectPool* pool, const int itemSize, const int capacity)
+{
+    memset(pool, 0, sizeof(EffectPool));
+    pool->itemSize = itemSize;
+    pool->items = (unsigned char*)malloc((size_t)itemSize * (size_t)capacity);
+    if (!pool->items)
+        return false;
+
+    pool->capacity = capacity;
+    return true;
+}
+
+void FreeEffectPool(EffectPool* pool)
+{
+    free(pool->items);
+    memset(pool, 0, sizeof(EffectPool));
+}
+
+bool GrowEffectPool(EffectPool* pool)
+{
+    const int capacity = pool->capacity > 0 ? pool->capacity * 2 : 16;
+    unsigned char* items = (unsigned char*)realloc(pool->items, (size_t)pool->itemSize * (size_t)capacity);
+    if (!items)
+        return false;
+
+    pool->items = items;
+    pool->capacity = capacity;
+    return true;
+}
+
+void* AcquireEffect(EffectPool* pool)
+{
+    if (pool->count == pool->capacity && !GrowEffectPool(pool))
+        return NULL;
+
+    void* item = GetEffect(pool, pool->count);
+    pool->count++;
+    if (pool->count > pool->highWaterMark)
+        pool->highWaterMark = pool->count;
+
+    return item;
+}
+
+void ReleaseEffect(EffectPool* pool, const int index)
+{
+    pool->count--;
+    if (index != pool->count)
+        memcpy(GetEffect(pool, index), GetEffect(pool, pool->count), (size_t)pool->itemSize);
+}
+
+bool AssignEffects(EffectPool* pool, const void* items, const int count)
+{
+    while (pool->capacity < count)
+    {
+        if (!GrowEffectPool(pool))
+            return false;
+    }
+
+    memcpy(pool->items, items, (size_t)pool->itemSize * (size_t)count);
+    pool->count = count;
+    if (count > pool->highWaterMark)
+        pool->highWaterMark = count;
+    return true;
+}
+
+void ClearEffectPool(EffectPool* pool)
+{
+    pool->count = 0;
+}
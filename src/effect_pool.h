@@ -0,0 +1,33 @@
+#ifndef EFFECT_POOL_H
+#define EFFECT_POOL_H
+
+#include <stdbool.h>
+
+// Pool of fixed-size, short-lived effect records. Live items are kept packed at the front of the
+// array, so acquiring and releasing are O(1) and iterating costs only what is alive. Releasing
+// moves the last live item into the freed slot: indices are not stable across a release.
+typedef struct EffectPool
+{
+    unsigned char* items;
+    int itemSize;
+    int count;          // Live items, stored in [0, count)
+    int capacity;
+    int highWaterMark;  // Largest count reached since the pool was created
+} EffectPool;
+
+bool InitEffectPool(EffectPool* pool, int itemSize, int capacity);
+void FreeEffectPool(EffectPool* pool);
+
+// Returns an uninitialized item, growing the pool if it is full, or NULL if growing failed
+void* AcquireEffect(EffectPool* pool);
+void ReleaseEffect(EffectPool* pool, int index);
+void ClearEffectPool(EffectPool* pool);
+// Replaces the live items with count items copied from items, growing the pool as needed
+bool AssignEffects(EffectPool* pool, const void* items, int count);
+
+static inline void* GetEffect(const EffectPool* pool, const int index)
+{
+    return pool->items + (long)index * pool->itemSize;
+}
+
+#endif // EFFECT_POOL_H
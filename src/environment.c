@@ -0,0 +1,951 @@
+#include "environment.h"
+#include "game.h"
+#include "monster.h"
+#include "player.h"
+#include "config.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define ENVIRONMENT_SIMD_AVX
+    #define ENVIRONMENT_SIMD_WIDTH 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define ENVIRONMENT_SIMD_SSE
+    #define ENVIRONMENT_SIMD_WIDTH 4
+#elif defined(__wasm_simd128__)
+    #include <wasm_simd128.h>
+    #define ENVIRONMENT_SIMD_WASM
+    #define ENVIRONMENT_SIMD_WIDTH 4
+#else
+    #define ENVIRONMENT_SIMD_WIDTH 1
+#endif
+
+// The kernels below run on vectors of environments through these operations. Each one rounds exactly like its
+// scalar counterpart, so every lane gets the bits the GameState code would compute. Arguments are evaluated more
+// than once: pass variables.
+#if defined(ENVIRONMENT_SIMD_AVX)
+typedef __m256 EnvironmentLanes;
+    #define LANES_LOAD(pointer) _mm256_loadu_ps(pointer)
+    #define LANES_STORE(pointer, a) _mm256_storeu_ps(pointer, a)
+    #define LANES_SPLAT(value) _mm256_set1_ps(value)
+    #define LANES_ADD(a, b) _mm256_add_ps(a, b)
+    #define LANES_SUBTRACT(a, b) _mm256_sub_ps(a, b)
+    #define LANES_MULTIPLY(a, b) _mm256_mul_ps(a, b)
+    #define LANES_DIVIDE(a, b) _mm256_div_ps(a, b)
+    #define LANES_SQRT(a) _mm256_sqrt_ps(a)
+    #define LANES_LESS(a, b) _mm256_cmp_ps(a, b, _CMP_LT_OQ)
+    #define LANES_LESS_EQUAL(a, b) _mm256_cmp_ps(a, b, _CMP_LE_OQ)
+    #define LANES_GREATER(a, b) _mm256_cmp_ps(a, b, _CMP_GT_OQ)
+    #define LANES_AND(a, b) _mm256_and_ps(a, b)
+    #define LANES_SELECT(mask, a, b) _mm256_blendv_ps(b, a, mask)
+    #define LANES_BITS(mask) _mm256_movemask_ps(mask)
+#elif defined(ENVIRONMENT_SIMD_SSE)
+typedef __m128 EnvironmentLanes;
+    #define LANES_LOAD(pointer) _mm_loadu_ps(pointer)
+    #define LANES_STORE(pointer, a) _mm_storeu_ps(pointer, a)
+    #define LANES_SPLAT(value) _mm_set1_ps(value)
+    #define LANES_ADD(a, b) _mm_add_ps(a, b)
+    #define LANES_SUBTRACT(a, b) _mm_sub_ps(a, b)
+    #define LANES_MULTIPLY(a, b) _mm_mul_ps(a, b)
+    #define LANES_DIVIDE(a, b) _mm_div_ps(a, b)
+    #define LANES_SQRT(a) _mm_sqrt_ps(a)
+    #define LANES_LESS(a, b) _mm_cmplt_ps(a, b)
+    #define LANES_LESS_EQUAL(a, b) _mm_cmple_ps(a, b)
+    #define LANES_GREATER(a, b) _mm_cmpgt_ps(a, b)
+    #define LANES_AND(a, b) _mm_and_ps(a, b)
+    #define LANES_SELECT(mask, a, b) _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b))
+    #define LANES_BITS(mask) _mm_movemask_ps(mask)
+#elif defined(ENVIRONMENT_SIMD_WASM)
+typedef v128_t EnvironmentLanes;
+    #define LANES_LOAD(pointer) wasm_v128_load(pointer)
+    #define LANES_STORE(pointer, a) wasm_v128_store(pointer, a)
+    #define LANES_SPLAT(value) wasm_f32x4_splat(value)
+    #define LANES_ADD(a, b) wasm_f32x4_add(a, b)
+    #define LANES_SUBTRACT(a, b) wasm_f32x4_sub(a, b)
+    #define LANES_MULTIPLY(a, b) wasm_f32x4_mul(a, b)
+    #define LANES_DIVIDE(a, b) wasm_f32x4_div(a, b)
+    #define LANES_SQRT(a) wasm_f32x4_sqrt(a)
+    #define LANES_LESS(a, b) wasm_f32x4_lt(a, b)
+    #define LANES_LESS_EQUAL(a, b) wasm_f32x4_le(a, b)
+    #define LANES_GREATER(a, b) wasm_f32x4_gt(a, b)
+    #define LANES_AND(a, b) wasm_v128_and(a, b)
+    #define LANES_SELECT(mask, a, b) wasm_v128_bitselect(a, b, mask)
+    #define LANES_BITS(mask) ((int)wasm_i32x4_bitmask(mask))
+#endif
+
+#define ENVIRONMENT_BLOCK_ALIGNMENT 32
+#define ENVIRONMENT_DEFAULT_MAX_GAME_TIME 300.0f
+
+void InitDefaultEnvironmentConfig(EnvironmentConfig* config)
+{
+    memset(config, 0, sizeof(*config));
+    InitDefaultScenario(&config->scenario);
+    config->environmentCount = 1;
+    config->baseSeed = 1;
+    config->deltaTime = SIMULATION_FIXED_DELTA_TIME;
+    config->maxGameTime = ENVIRONMENT_DEFAULT_MAX_GAME_TIME;
+    config->observedMonsters = config->scenario.monsterCount;
+    config->rewards.damageDealt = 1.0f;
+    config->rewards.damageTaken = 1.0f;
+    config->rewards.victory = 1.0f;
+    config->rewards.defeat = 1.0f;
+}
+
+static void* CarveEnvironmentBlock(unsigned char* block, size_t* offset, const size_t size)
+{
+    *offset = (*offset + ENVIRONMENT_BLOCK_ALIGNMENT - 1) / ENVIRONMENT_BLOCK_ALIGNMENT * ENVIRONMENT_BLOCK_ALIGNMENT;
+    void* pointer = block ? block + *offset : NULL;
+    *offset += size;
+    return pointer;
+}
+
+// Points the lanes into block and returns the block size they need.
+// Called with NULL first to measure, then with the allocated block.
+static size_t LayoutEnvironmentBlock(EnvironmentBatch* batch, unsigned char* block)
+{
+    const size_t count = (size_t)batch->count;
+    const size_t monsterLanes = count * (size_t)batch->config.scenario.monsterCount;
+    EnvironmentShips* ships = &batch->ships;
+    EnvironmentMonsters* monsters = &batch->monsters;
+    EnvironmentTargets* targets = &batch->targets;
+    size_t offset = 0;
+
+    ships->x = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * count);
+    ships->y = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * count);
+    ships->velocityX = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * count);
+    ships->velocityY = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * count);
+    ships->rotation = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * count);
+    ships->health = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * count);
+    ships->shootTimer = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * count);
+    ships->leftThruster = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * count);
+    ships->rightThruster = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * count);
+    ships->thrustCosine = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * count);
+    ships->thrustSine = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * count);
+    ships->isDead = (unsigned char*)CarveEnvironmentBlock(block, &offset, count);
+
+    monsters->x = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * monsterLanes);
+    monsters->y = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * monsterLanes);
+    monsters->size = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * monsterLanes);
+    monsters->health = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * monsterLanes);
+    monsters->invincibilityTimer = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * monsterLanes);
+    monsters->shootTimer = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * monsterLanes);
+    monsters->shootCooldown = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * monsterLanes);
+    monsters->spreadShotTimer = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * monsterLanes);
+    monsters->spreadShotCooldown = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * monsterLanes);
+    monsters->distance = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * monsterLanes);
+    monsters->canShoot = (unsigned char*)CarveEnvironmentBlock(block, &offset, monsterLanes);
+
+    const int monsterCount = batch->config.scenario.monsterCount;
+    targets->stride = (monsterCount + ENVIRONMENT_SIMD_WIDTH - 1) / ENVIRONMENT_SIMD_WIDTH * ENVIRONMENT_SIMD_WIDTH;
+    const size_t slots = count * (size_t)targets->stride;
+    targets->counts = (int*)CarveEnvironmentBlock(block, &offset, sizeof(int) * count);
+    targets->monsters = (int*)CarveEnvironmentBlock(block, &offset, sizeof(int) * slots);
+    targets->minX = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * slots);
+    targets->minY = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * slots);
+    targets->maxX = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * slots);
+    targets->maxY = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * slots);
+    targets->boundsMinX = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * count);
+    targets->boundsMinY = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * count);
+    targets->boundsMaxX = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * count);
+    targets->boundsMaxY = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * count);
+
+    batch->seeds = (unsigned int*)CarveEnvironmentBlock(block, &offset, sizeof(unsigned int) * count);
+    batch->ticks = (long*)CarveEnvironmentBlock(block, &offset, sizeof(long) * count);
+    batch->scores = (int*)CarveEnvironmentBlock(block, &offset, sizeof(int) * count);
+    batch->healthBefore = (float*)CarveEnvironmentBlock(block, &offset, sizeof(float) * count);
+    batch->views = (MonsterView*)CarveEnvironmentBlock(block, &offset, sizeof(MonsterView) * (size_t)monsterCount);
+    batch->viewScratch = (MonsterView*)CarveEnvironmentBlock(block, &offset, sizeof(MonsterView) * (size_t)monsterCount);
+
+    return offset;
+}
+
+// UpdatePlayer for the ships in [first, first + count). The rotation and its cosine and sine are computed one ship
+// at a time with the same libm calls; thrust, drag, the speed limit, movement and wrapping run on vectors of ships
+// with the same operations in the same order, so every ship ends up exactly where UpdatePlayer puts it. Ships
+// destroyed this tick go through the second part too: their environment is reset before their lanes are read.
+static void IntegrateShips(EnvironmentBatch* batch, const int first, const int count)
+{
+    EnvironmentShips* ships = &batch->ships;
+    const float deltaTime = batch->config.deltaTime;
+    const int end = first + count;
+
+    for (int i = first; i < end; i++)
+    {
+        if (ships->health[i] <= 0.0f)
+            ships->isDead[i] = 1;
+        if (ships->isDead[i])
+            continue;
+
+        if (ships->shootTimer[i] > 0.0f)
+            ships->shootTimer[i] -= deltaTime;
+
+        const float thrustDiff = ships->rightThruster[i] - ships->leftThruster[i];
+        ships->rotation[i] += thrustDiff * PLAYER_TURN_RATE * deltaTime;
+
+        const float thrustAngleRad = ships->rotation[i] * DEG2RAD;
+        ships->thrustCosine[i] = cosf(thrustAngleRad);
+        ships->thrustSine[i] = sinf(thrustAngleRad);
+    }
+
+    float* x = ships->x;
+    float* y = ships->y;
+    float* velocityX = ships->velocityX;
+    float* velocityY = ships->velocityY;
+    const float* leftThruster = ships->leftThruster;
+    const float* rightThruster = ships->rightThruster;
+    const float* thrustCosine = ships->thrustCosine;
+    const float* thrustSine = ships->thrustSine;
+    const float drag = powf(PLAYER_DRAG, deltaTime * PLAYER_DRAG_REFERENCE_RATE);
+    const float arenaWidth = batch->config.scenario.arenaWidth;
+    const float arenaHeight = batch->config.scenario.arenaHeight;
+    int i = first;
+
+#if ENVIRONMENT_SIMD_WIDTH > 1
+    const EnvironmentLanes dt = LANES_SPLAT(deltaTime);
+    const EnvironmentLanes half = LANES_SPLAT(0.5f);
+    const EnvironmentLanes power = LANES_SPLAT(PLAYER_THRUST_POWER);
+    const EnvironmentLanes dragFactor = LANES_SPLAT(drag);
+    const EnvironmentLanes maxSpeed = LANES_SPLAT(PLAYER_MAX_SPEED);
+    const EnvironmentLanes zero = LANES_SPLAT(0.0f);
+    const EnvironmentLanes width = LANES_SPLAT(arenaWidth);
+    const EnvironmentLanes height = LANES_SPLAT(arenaHeight);
+    for (; i + ENVIRONMENT_SIMD_WIDTH <= end; i += ENVIRONMENT_SIMD_WIDTH)
+    {
+        const EnvironmentLanes left = LANES_LOAD(leftThruster + i);
+        const EnvironmentLanes right = LANES_LOAD(rightThruster + i);
+        const EnvironmentLanes averageThrust = LANES_MULTIPLY(LANES_ADD(left, right), half);
+        const EnvironmentLanes cosine = LANES_LOAD(thrustCosine + i);
+        const EnvironmentLanes sine = LANES_LOAD(thrustSine + i);
+        const EnvironmentLanes thrustX = LANES_MULTIPLY(LANES_MULTIPLY(cosine, averageThrust), power);
+        const EnvironmentLanes thrustY = LANES_MULTIPLY(LANES_MULTIPLY(sine, averageThrust), power);
+        const EnvironmentLanes oldVelocityX = LANES_LOAD(velocityX + i);
+        const EnvironmentLanes oldVelocityY = LANES_LOAD(velocityY + i);
+        EnvironmentLanes vx = LANES_MULTIPLY(LANES_ADD(oldVelocityX, LANES_MULTIPLY(thrustX, dt)), dragFactor);
+        EnvironmentLanes vy = LANES_MULTIPLY(LANES_ADD(oldVelocityY, LANES_MULTIPLY(thrustY, dt)), dragFactor);
+
+        const EnvironmentLanes speed = LANES_SQRT(LANES_ADD(LANES_MULTIPLY(vx, vx), LANES_MULTIPLY(vy, vy)));
+        const EnvironmentLanes tooFast = LANES_GREATER(speed, maxSpeed);
+        const EnvironmentLanes limitedX = LANES_MULTIPLY(LANES_DIVIDE(vx, speed), maxSpeed);
+        const EnvironmentLanes limitedY = LANES_MULTIPLY(LANES_DIVIDE(vy, speed), maxSpeed);
+        vx = LANES_SELECT(tooFast, limitedX, vx);
+        vy = LANES_SELECT(tooFast, limitedY, vy);
+        LANES_STORE(velocityX + i, vx);
+        LANES_STORE(velocityY + i, vy);
+
+        const EnvironmentLanes oldX = LANES_LOAD(x + i);
+        const EnvironmentLanes oldY = LANES_LOAD(y + i);
+        EnvironmentLanes px = LANES_ADD(oldX, LANES_MULTIPLY(vx, dt));
+        EnvironmentLanes py = LANES_ADD(oldY, LANES_MULTIPLY(vy, dt));
+        const EnvironmentLanes belowX = LANES_LESS(px, zero);
+        const EnvironmentLanes belowY = LANES_LESS(py, zero);
+        const EnvironmentLanes aboveX = LANES_GREATER(px, width);
+        const EnvironmentLanes aboveY = LANES_GREATER(py, height);
+        px = LANES_SELECT(aboveX, zero, px);
+        py = LANES_SELECT(aboveY, zero, py);
+        px = LANES_SELECT(belowX, width, px);
+        py = LANES_SELECT(belowY, height, py);
+        LANES_STORE(x + i, px);
+        LANES_STORE(y + i, py);
+    }
+#endif
+
+    for (; i < end; i++)
+    {
+        const float averageThrust = (leftThruster[i] + rightThruster[i]) / 2.0f;
+        float vx = velocityX[i] + thrustCosine[i] * averageThrust * PLAYER_THRUST_POWER * deltaTime;
+        float vy = velocityY[i] + thrustSine[i] * averageThrust * PLAYER_THRUST_POWER * deltaTime;
+        vx *= drag;
+        vy *= drag;
+
+        const float speed = sqrtf(vx * vx + vy * vy);
+        if (speed > PLAYER_MAX_SPEED)
+        {
+            vx = (vx / speed) * PLAYER_MAX_SPEED;
+            vy = (vy / speed) * PLAYER_MAX_SPEED;
+        }
+        velocityX[i] = vx;
+        velocityY[i] = vy;
+
+        float px = x[i] + vx * deltaTime;
+        float py = y[i] + vy * deltaTime;
+        if (px < 0)
+            px = arenaWidth;
+        else if (px > arenaWidth)
+            px = 0;
+
+        if (py < 0)
+            py = arenaHeight;
+        else if (py > arenaHeight)
+            py = 0;
+        x[i] = px;
+        y[i] = py;
+    }
+}
+
+// The rest of the start of the tick of environments [first, first + count), up to where UpdateGameState runs the AI,
+// once IntegrateShips has moved their ships: UpdateMonster and ApplyProximityDamage, one monster index at a time
+// across environments. The proximity damage of a monster only reads that monster, so updating each one just before
+// is the same as updating them all first. A destroyed ship has no health left to lose, so it needs no mask.
+static void BeginEnvironmentTicks(EnvironmentBatch* batch, const int first, const int count)
+{
+    const int monsterCount = batch->config.scenario.monsterCount;
+    const float deltaTime = batch->config.deltaTime;
+    const float proximityDamage = batch->config.scenario.damageProximityPerSecond * deltaTime;
+    const EnvironmentMonsters* monsters = &batch->monsters;
+    const float* shipX = batch->ships.x;
+    const float* shipY = batch->ships.y;
+    float* shipHealth = batch->ships.health;
+    const int end = first + count;
+
+    for (int m = 0; m < monsterCount; m++)
+    {
+        const int lane = m * batch->count;
+        const float* x = monsters->x + lane;
+        const float* y = monsters->y + lane;
+        const float* size = monsters->size + lane;
+        const float* health = monsters->health + lane;
+        float* invincibilityTimer = monsters->invincibilityTimer + lane;
+        float* shootTimer = monsters->shootTimer + lane;
+        float* spreadShotTimer = monsters->spreadShotTimer + lane;
+        int e = first;
+
+#if ENVIRONMENT_SIMD_WIDTH > 1
+        const EnvironmentLanes zero = LANES_SPLAT(0.0f);
+        const EnvironmentLanes dt = LANES_SPLAT(deltaTime);
+        const EnvironmentLanes damage = LANES_SPLAT(proximityDamage);
+        for (; e + ENVIRONMENT_SIMD_WIDTH <= end; e += ENVIRONMENT_SIMD_WIDTH)
+        {
+            const EnvironmentLanes monsterHealth = LANES_LOAD(health + e);
+            const EnvironmentLanes alive = LANES_GREATER(monsterHealth, zero);
+
+            const EnvironmentLanes invincibility = LANES_LOAD(invincibilityTimer + e);
+            const EnvironmentLanes shoot = LANES_LOAD(shootTimer + e);
+            const EnvironmentLanes spreadShot = LANES_LOAD(spreadShotTimer + e);
+            const EnvironmentLanes invincibilityRunning = LANES_AND(alive, LANES_GREATER(invincibility, zero));
+            const EnvironmentLanes shootRunning = LANES_AND(alive, LANES_GREATER(shoot, zero));
+            const EnvironmentLanes spreadShotRunning = LANES_AND(alive, LANES_GREATER(spreadShot, zero));
+            const EnvironmentLanes invincibilityLeft = LANES_SUBTRACT(invincibility, dt);
+            const EnvironmentLanes shootLeft = LANES_SUBTRACT(shoot, dt);
+            const EnvironmentLanes spreadShotLeft = LANES_SUBTRACT(spreadShot, dt);
+            LANES_STORE(invincibilityTimer + e, LANES_SELECT(invincibilityRunning, invincibilityLeft, invincibility));
+            LANES_STORE(shootTimer + e, LANES_SELECT(shootRunning, shootLeft, shoot));
+            LANES_STORE(spreadShotTimer + e, LANES_SELECT(spreadShotRunning, spreadShotLeft, spreadShot));
+
+            const EnvironmentLanes dx = LANES_SUBTRACT(LANES_LOAD(shipX + e), LANES_LOAD(x + e));
+            const EnvironmentLanes dy = LANES_SUBTRACT(LANES_LOAD(shipY + e), LANES_LOAD(y + e));
+            const EnvironmentLanes distance = LANES_SQRT(LANES_ADD(LANES_MULTIPLY(dx, dx), LANES_MULTIPLY(dy, dy)));
+            const EnvironmentLanes inDangerZone = LANES_AND(alive, LANES_LESS(distance, LANES_LOAD(size + e)));
+            if (LANES_BITS(inDangerZone))
+            {
+                const EnvironmentLanes before = LANES_LOAD(shipHealth + e);
+                const EnvironmentLanes damaged = LANES_SUBTRACT(before, damage);
+                const EnvironmentLanes negative = LANES_LESS(damaged, zero);
+                const EnvironmentLanes after = LANES_SELECT(negative, zero, damaged);
+                LANES_STORE(shipHealth + e, LANES_SELECT(inDangerZone, after, before));
+            }
+        }
+#endif
+
+        for (; e < end; e++)
+        {
+            if (health[e] <= 0.0f)
+                continue;
+
+            if (invincibilityTimer[e] > 0.0f)
+                invincibilityTimer[e] -= deltaTime;
+            if (shootTimer[e] > 0.0f)
+                shootTimer[e] -= deltaTime;
+            if (spreadShotTimer[e] > 0.0f)
+                spreadShotTimer[e] -= deltaTime;
+
+            const float dx = shipX[e] - x[e];
+            const float dy = shipY[e] - y[e];
+            const float distance = sqrtf(dx * dx + dy * dy);
+            if (distance < size[e])
+            {
+                shipHealth[e] -= proximityDamage;
+                if (shipHealth[e] < 0.0f)
+                    shipHealth[e] = 0.0f;
+            }
+        }
+    }
+
+    for (int e = first; e < end; e++)
+    {
+        batch->ticks[e]++;
+    }
+}
+
+static int CountShootingMonsters(const EnvironmentBatch* batch, const int e)
+{
+    int shooting = 0;
+    for (int m = 0; m < batch->config.scenario.monsterCount; m++)
+    {
+        if (batch->monsters.canShoot[m * batch->count + e])
+            shooting++;
+    }
+    return shooting;
+}
+
+// Starts the next episode of environment e, generated exactly as InitGameState would for its seed. Its projectiles
+// are left for the caller to remove.
+static void ResetEnvironment(EnvironmentBatch* batch, const int e)
+{
+    const int monsterCount = batch->config.scenario.monsterCount;
+    GameState* generator = &batch->generator;
+    EnvironmentShips* ships = &batch->ships;
+    EnvironmentMonsters* monsters = &batch->monsters;
+
+    const unsigned int seed = batch->nextSeed++;
+    GenerateWorld(generator, seed);
+
+    batch->shootingMonsters -= CountShootingMonsters(batch, e);
+    for (int m = 0; m < monsterCount; m++)
+    {
+        const Monster* monster = &generator->monsters[m];
+        const int lane = m * batch->count + e;
+        monsters->x[lane] = monster->position.x;
+        monsters->y[lane] = monster->position.y;
+        monsters->size[lane] = monster->size;
+        monsters->health[lane] = monster->health;
+        monsters->invincibilityTimer[lane] = monster->invincibilityTimer;
+        monsters->shootTimer[lane] = monster->shootTimer;
+        monsters->shootCooldown[lane] = monster->shootCooldown;
+        monsters->spreadShotTimer[lane] = monster->spreadShotTimer;
+        monsters->spreadShotCooldown[lane] = monster->spreadShotCooldown;
+        monsters->canShoot[lane] = monster->canShoot;
+    }
+    batch->shootingMonsters += CountShootingMonsters(batch, e);
+
+    const Player* player = &generator->player;
+    ships->x[e] = player->position.x;
+    ships->y[e] = player->position.y;
+    ships->velocityX[e] = player->velocity.x;
+    ships->velocityY[e] = player->velocity.y;
+    ships->rotation[e] = player->rotation;
+    ships->health[e] = player->health;
+    ships->shootTimer[e] = player->shootTimer;
+    ships->leftThruster[e] = player->leftThruster;
+    ships->rightThruster[e] = player->rightThruster;
+    ships->isDead[e] = player->isDead;
+
+    batch->seeds[e] = seed;
+    batch->ticks[e] = 0;
+    batch->scores[e] = 0;
+}
+
+// IsMonsterVisibleFrom for a monster lane
+static bool IsEnvironmentMonsterVisible(const EnvironmentBatch* batch, const int lane, const int e)
+{
+    const float dx = batch->monsters.x[lane] - batch->ships.x[e];
+    const float dy = batch->monsters.y[lane] - batch->ships.y[e];
+    const float radius = PLAYER_VISION_RADIUS + batch->monsters.size[lane];
+    const float squaredDistance = dx * dx + dy * dy;
+    if (squaredDistance < radius * radius * 0.99f)
+        return true;
+    if (squaredDistance > radius * radius * 1.01f)
+        return false;
+    return hypotf(dx, dy) <= radius;
+}
+
+static void AddEnvironmentTarget(EnvironmentBatch* batch, const int e, const int m)
+{
+    EnvironmentTargets* targets = &batch->targets;
+    const int lane = m * batch->count + e;
+    const float size = batch->monsters.size[lane];
+    const float minX = batch->monsters.x[lane] - size / 2;
+    const float minY = batch->monsters.y[lane] - size / 2;
+    const float maxX = minX + size;
+    const float maxY = minY + size;
+
+    const int slot = e * targets->stride + targets->counts[e]++;
+    targets->monsters[slot] = m;
+    targets->minX[slot] = minX;
+    targets->minY[slot] = minY;
+    targets->maxX[slot] = maxX;
+    targets->maxY[slot] = maxY;
+    if (minX < targets->boundsMinX[e])
+        targets->boundsMinX[e] = minX;
+    if (minY < targets->boundsMinY[e])
+        targets->boundsMinY[e] = minY;
+    if (maxX > targets->boundsMaxX[e])
+        targets->boundsMaxX[e] = maxX;
+    if (maxY > targets->boundsMaxY[e])
+        targets->boundsMaxY[e] = maxY;
+}
+
+// From the ships of environments [first, first + count): the distance to each monster in sight, as
+// BuildVisibleMonstersArray measures it, and the targets, as GatherHittableMonsters picks them. The tests run one
+// monster index at a time across environments; the monsters that pass are then added one by one. Lanes too close to
+// the edge of vision for the squared distance to settle it go through hypotf like IsMonsterVisibleFrom.
+static void GatherEnvironmentTargets(EnvironmentBatch* batch, const int first, const int count)
+{
+    const int monsterCount = batch->config.scenario.monsterCount;
+    const EnvironmentMonsters* monsters = &batch->monsters;
+    EnvironmentTargets* targets = &batch->targets;
+    const float* shipX = batch->ships.x;
+    const float* shipY = batch->ships.y;
+    const int end = first + count;
+
+    for (int e = first; e < end; e++)
+    {
+        targets->counts[e] = 0;
+        targets->boundsMinX[e] = INFINITY;
+        targets->boundsMinY[e] = INFINITY;
+        targets->boundsMaxX[e] = -INFINITY;
+        targets->boundsMaxY[e] = -INFINITY;
+    }
+
+    for (int m = 0; m < monsterCount; m++)
+    {
+        const int lane = m * batch->count;
+        const float* x = monsters->x + lane;
+        const float* y = monsters->y + lane;
+        const float* health = monsters->health + lane;
+        const float* invincibilityTimer = monsters->invincibilityTimer + lane;
+        float* distance = monsters->distance + lane;
+        int e = first;
+
+#if ENVIRONMENT_SIMD_WIDTH > 1
+        const EnvironmentLanes zero = LANES_SPLAT(0.0f);
+        const EnvironmentLanes infinity = LANES_SPLAT(INFINITY);
+        const EnvironmentLanes visionRadius = LANES_SPLAT(PLAYER_VISION_RADIUS);
+        const EnvironmentLanes nearEdge = LANES_SPLAT(0.99f);
+        const EnvironmentLanes farEdge = LANES_SPLAT(1.01f);
+        for (; e + ENVIRONMENT_SIMD_WIDTH <= end; e += ENVIRONMENT_SIMD_WIDTH)
+        {
+            const EnvironmentLanes monsterSize = LANES_LOAD(monsters->size + lane + e);
+            const EnvironmentLanes alive = LANES_GREATER(LANES_LOAD(health + e), zero);
+            const EnvironmentLanes dx = LANES_SUBTRACT(LANES_LOAD(x + e), LANES_LOAD(shipX + e));
+            const EnvironmentLanes dy = LANES_SUBTRACT(LANES_LOAD(y + e), LANES_LOAD(shipY + e));
+            const EnvironmentLanes squaredDistance = LANES_ADD(LANES_MULTIPLY(dx, dx), LANES_MULTIPLY(dy, dy));
+
+            const EnvironmentLanes monsterDistance = LANES_SQRT(squaredDistance);
+            const EnvironmentLanes inSight = LANES_AND(alive, LANES_LESS_EQUAL(monsterDistance, visionRadius));
+            LANES_STORE(distance + e, LANES_SELECT(inSight, monsterDistance, infinity));
+
+            const EnvironmentLanes radius = LANES_ADD(visionRadius, monsterSize);
+            const EnvironmentLanes squaredRadius = LANES_MULTIPLY(radius, radius);
+            const EnvironmentLanes inside = LANES_MULTIPLY(squaredRadius, nearEdge);
+            const EnvironmentLanes outside = LANES_MULTIPLY(squaredRadius, farEdge);
+            const EnvironmentLanes vulnerable = LANES_AND(alive, LANES_LESS_EQUAL(LANES_LOAD(invincibilityTimer + e), zero));
+            const EnvironmentLanes edge = LANES_AND(LANES_LESS_EQUAL(inside, squaredDistance), LANES_LESS_EQUAL(squaredDistance, outside));
+            const int visibleBits = LANES_BITS(LANES_AND(vulnerable, LANES_LESS(squaredDistance, inside)));
+            const int edgeBits = LANES_BITS(LANES_AND(vulnerable, edge));
+
+            for (int bits = visibleBits | edgeBits, bit = 0; bits != 0; bits >>= 1, bit++)
+            {
+                if ((bits & 1) && ((visibleBits >> bit) & 1 || IsEnvironmentMonsterVisible(batch, lane + e + bit, e + bit)))
+                    AddEnvironmentTarget(batch, e + bit, m);
+            }
+        }
+#endif
+
+        for (; e < end; e++)
+        {
+            const float dx = x[e] - shipX[e];
+            const float dy = y[e] - shipY[e];
+            const float monsterDistance = sqrtf(dx * dx + dy * dy);
+            const bool alive = health[e] > 0.0f;
+            distance[e] = alive && monsterDistance <= PLAYER_VISION_RADIUS ? monsterDistance : INFINITY;
+
+            if (alive && invincibilityTimer[e] <= 0.0f && IsEnvironmentMonsterVisible(batch, lane + e, e))
+                AddEnvironmentTarget(batch, e, m);
+        }
+    }
+}
+
+// Views of the monsters in sight of environment e's ship, which GatherEnvironmentTargets measured, as
+// BuildVisibleMonstersArray builds them
+static void ObserveEnvironment(EnvironmentBatch* batch, const int e, float* out)
+{
+    const int monsterCount = batch->config.scenario.monsterCount;
+    const EnvironmentShips* ships = &batch->ships;
+    const EnvironmentMonsters* monsters = &batch->monsters;
+    const Vector2 position = { ships->x[e], ships->y[e] };
+    MonsterView* views = batch->views;
+
+    int visibleCount = 0;
+    for (int m = 0; m < monsterCount; m++)
+    {
+        const int lane = m * batch->count + e;
+        if (monsters->distance[lane] <= PLAYER_VISION_RADIUS)
+        {
+            views[visibleCount].position = (Vector2){ monsters->x[lane], monsters->y[lane] };
+            views[visibleCount].size = monsters->size[lane];
+            views[visibleCount].health = monsters->health[lane];
+            views[visibleCount].invincible = monsters->invincibilityTimer[lane] > 0.0f;
+            views[visibleCount].distance = monsters->distance[lane];
+            visibleCount++;
+        }
+    }
+    OrientMonsterViews(views, batch->viewScratch, visibleCount, position, ships->rotation[e]);
+
+    out[ENVIRONMENT_SHIP_X] = ships->x[e];
+    out[ENVIRONMENT_SHIP_Y] = ships->y[e];
+    out[ENVIRONMENT_SHIP_VELOCITY_X] = ships->velocityX[e];
+    out[ENVIRONMENT_SHIP_VELOCITY_Y] = ships->velocityY[e];
+    out[ENVIRONMENT_SHIP_ROTATION] = ships->rotation[e];
+    out[ENVIRONMENT_SHIP_HEALTH] = ships->health[e];
+    out[ENVIRONMENT_SHIP_SHOOT_TIMER] = ships->shootTimer[e];
+    out[ENVIRONMENT_SHIP_VISIBLE_MONSTERS] = (float)visibleCount;
+
+    const int observedMonsters = batch->config.observedMonsters;
+    float* row = out + ENVIRONMENT_SHIP_FEATURES;
+    for (int v = 0; v < observedMonsters; v++, row += ENVIRONMENT_MONSTER_FEATURES)
+    {
+        if (v >= visibleCount)
+        {
+            memset(row, 0, sizeof(float) * ENVIRONMENT_MONSTER_FEATURES);
+            continue;
+        }
+
+        row[ENVIRONMENT_MONSTER_X] = views[v].position.x;
+        row[ENVIRONMENT_MONSTER_Y] = views[v].position.y;
+        row[ENVIRONMENT_MONSTER_SIZE] = views[v].size;
+        row[ENVIRONMENT_MONSTER_HEALTH] = views[v].health;
+        row[ENVIRONMENT_MONSTER_INVINCIBLE] = views[v].invincible ? 1.0f : 0.0f;
+        row[ENVIRONMENT_MONSTER_DISTANCE] = views[v].distance;
+        row[ENVIRONMENT_MONSTER_BEARING] = views[v].bearing;
+        row[ENVIRONMENT_MONSTER_RELATIVE_ANGLE] = views[v].relativeAngle;
+    }
+}
+
+void ObserveEnvironmentBatch(EnvironmentBatch* batch, float* outObservations)
+{
+    for (int e = 0; e < batch->count; e++)
+    {
+        ObserveEnvironment(batch, e, outObservations + (size_t)e * (size_t)batch->observationSize);
+    }
+}
+
+bool InitEnvironmentBatch(EnvironmentBatch* batch, const EnvironmentConfig* config, float* outObservations)
+{
+    memset(batch, 0, sizeof(*batch));
+    if (config->environmentCount <= 0 || config->deltaTime <= 0.0f || config->maxGameTime <= 0.0f || config->observedMonsters < 0 ||
+        !IsScenarioValid(&config->scenario))
+        return false;
+
+    batch->config = *config;
+    batch->count = config->environmentCount;
+    batch->observationSize = ENVIRONMENT_SHIP_FEATURES + config->observedMonsters * ENVIRONMENT_MONSTER_FEATURES;
+    batch->maxTicks = (long)(config->maxGameTime / config->deltaTime);
+    batch->nextSeed = config->baseSeed;
+
+    const size_t size = LayoutEnvironmentBlock(batch, NULL);
+    unsigned char* block = (unsigned char*)calloc(1, size);
+    if (!block)
+        return false;
+    LayoutEnvironmentBlock(batch, block);
+    batch->block = block;
+
+    const int spawnsPerTick = 1 + config->scenario.monsterCount * (1 + MONSTER_SPREAD_SHOT_COUNT);
+    if (!AllocateGameState(&batch->generator, &config->scenario) ||
+        !InitProjectileStore(&batch->projectiles, batch->count * spawnsPerTick))
+    {
+        FreeEnvironmentBatch(batch);
+        return false;
+    }
+
+    for (int e = 0; e < batch->count; e++)
+    {
+        ResetEnvironment(batch, e);
+    }
+    IntegrateShips(batch, 0, batch->count);
+    BeginEnvironmentTicks(batch, 0, batch->count);
+    GatherEnvironmentTargets(batch, 0, batch->count);
+
+    if (outObservations)
+        ObserveEnvironmentBatch(batch, outObservations);
+    return true;
+}
+
+void FreeEnvironmentBatch(EnvironmentBatch* batch)
+{
+    FreeProjectileStore(&batch->projectiles);
+    CleanupGameState(&batch->generator);
+    free(batch->block);
+    memset(batch, 0, sizeof(*batch));
+}
+
+static float ClampThruster(float power)
+{
+    if (power < -1.0f)
+        power = -1.0f;
+    if (power > 1.0f)
+        power = 1.0f;
+    return power;
+}
+
+// FireMonsterShots for a monster lane, with the projectiles tagged with environment e
+static void FireEnvironmentMonsterShots(EnvironmentBatch* batch, const int lane, const int e, const Vector2 target)
+{
+    EnvironmentMonsters* monsters = &batch->monsters;
+    const Vector2 position = { monsters->x[lane], monsters->y[lane] };
+
+    if (monsters->shootTimer[lane] <= 0.0f)
+    {
+        const float dx = target.x - position.x;
+        const float dy = target.y - position.y;
+        const float angleToPlayer = atan2f(dy, dx) * RAD2DEG;
+
+        FireProjectile(&batch->projectiles, angleToPlayer, position, PROJECTILE_MONSTER, e);
+        monsters->shootTimer[lane] = monsters->shootCooldown[lane];
+    }
+
+    if (monsters->spreadShotTimer[lane] <= 0.0f)
+    {
+        for (int i = 0; i < MONSTER_SPREAD_SHOT_COUNT; i++)
+        {
+            const float angle = (360.0f / MONSTER_SPREAD_SHOT_COUNT) * i;
+            FireProjectile(&batch->projectiles, angle, position, PROJECTILE_MONSTER_SPREAD, e);
+        }
+        monsters->spreadShotTimer[lane] = monsters->spreadShotCooldown[lane];
+    }
+}
+
+#if ENVIRONMENT_SIMD_WIDTH > 1
+static int LowestSetBit(int bits)
+{
+    int bit = 0;
+    while (!(bits & 1))
+    {
+        bits >>= 1;
+        bit++;
+    }
+    return bit;
+}
+#endif
+
+// Slot of the first of environment e's targets whose hitbox overlaps the box, in monster index order, -1 if none.
+// Slots are padded to whole vectors, so the last vector reads past the targets and ignores those lanes.
+static int FindEnvironmentTargetHit(const EnvironmentTargets* targets, const int e, const float left, const float top,
+    const float right, const float bottom)
+{
+    const int first = e * targets->stride;
+    const int count = targets->counts[e];
+    const float* minX = targets->minX + first;
+    const float* minY = targets->minY + first;
+    const float* maxX = targets->maxX + first;
+    const float* maxY = targets->maxY + first;
+
+#if ENVIRONMENT_SIMD_WIDTH > 1
+    const EnvironmentLanes boxLeft = LANES_SPLAT(left);
+    const EnvironmentLanes boxTop = LANES_SPLAT(top);
+    const EnvironmentLanes boxRight = LANES_SPLAT(right);
+    const EnvironmentLanes boxBottom = LANES_SPLAT(bottom);
+    for (int h = 0; h < count; h += ENVIRONMENT_SIMD_WIDTH)
+    {
+        const EnvironmentLanes targetMinX = LANES_LOAD(minX + h);
+        const EnvironmentLanes targetMinY = LANES_LOAD(minY + h);
+        const EnvironmentLanes targetMaxX = LANES_LOAD(maxX + h);
+        const EnvironmentLanes targetMaxY = LANES_LOAD(maxY + h);
+        const EnvironmentLanes overlapX = LANES_AND(LANES_LESS(boxLeft, targetMaxX), LANES_GREATER(boxRight, targetMinX));
+        const EnvironmentLanes overlapY = LANES_AND(LANES_LESS(boxTop, targetMaxY), LANES_GREATER(boxBottom, targetMinY));
+        int hits = LANES_BITS(LANES_AND(overlapX, overlapY));
+        if (count - h < ENVIRONMENT_SIMD_WIDTH)
+            hits &= (1 << (count - h)) - 1;
+        if (hits)
+            return first + h + LowestSetBit(hits);
+    }
+#else
+    for (int h = 0; h < count; h++)
+    {
+        if (left < maxX[h] && right > minX[h] && top < maxY[h] && bottom > minY[h])
+            return first + h;
+    }
+#endif
+    return -1;
+}
+
+// UpdateProjectiles for every environment at once, without the effects. Each projectile only meets its own
+// environment's ship and monsters. The overlap tests are RectanglesOverlap's with the box edges computed once.
+static void UpdateEnvironmentProjectiles(EnvironmentBatch* batch, float* rewards)
+{
+    const Scenario* scenario = &batch->config.scenario;
+    const EnvironmentRewards* weights = &batch->config.rewards;
+    EnvironmentShips* ships = &batch->ships;
+    EnvironmentMonsters* monsters = &batch->monsters;
+    EnvironmentTargets* targets = &batch->targets;
+    ProjectileStore* store = &batch->projectiles;
+
+    IntegrateProjectiles(store, batch->config.deltaTime);
+    CullProjectilesOutOfBounds(store, GetProjectileBounds(&batch->generator));
+
+    int hitCount = 0;
+    for (int i = 0; i < store->count; i++)
+    {
+        const int e = store->monsterIndex[i];
+        const float left = store->x[i] - PROJECTILE_SIZE / 2;
+        const float top = store->y[i] - PROJECTILE_SIZE / 2;
+        const float right = left + PROJECTILE_SIZE;
+        const float bottom = top + PROJECTILE_SIZE;
+        const ProjectileOwner owner = (ProjectileOwner)store->owner[i];
+
+        if (owner == PROJECTILE_PLAYER)
+        {
+            if (!(left < targets->boundsMaxX[e] && right > targets->boundsMinX[e] &&
+                  top < targets->boundsMaxY[e] && bottom > targets->boundsMinY[e]))
+                continue;
+
+            const int slot = FindEnvironmentTargetHit(targets, e, left, top, right, bottom);
+            if (slot < 0)
+                continue;
+
+            store->owner[i] |= PROJECTILE_DEAD_FLAG;
+            hitCount++;
+            batch->scores[e]++;
+
+            // DamageMonster: targets are alive and not invincible
+            const int lane = targets->monsters[slot] * batch->count + e;
+            const float health = monsters->health[lane];
+            float damaged = health - scenario->damagePlayerProjectile;
+            if (damaged < 0.0f)
+                damaged = 0.0f;
+            monsters->health[lane] = damaged;
+            monsters->invincibilityTimer[lane] = MONSTER_INVINCIBILITY_DURATION;
+            rewards[e] += (health - damaged) * weights->damageDealt;
+
+            // Now invincible, so out of reach for the rest of the pass: nothing overlaps an empty box
+            targets->maxX[slot] = -INFINITY;
+        }
+        else if (owner == PROJECTILE_MONSTER || owner == PROJECTILE_MONSTER_SPREAD)
+        {
+            const float shipLeft = ships->x[e] - PLAYER_SIZE / 2;
+            const float shipTop = ships->y[e] - PLAYER_SIZE / 2;
+            if (!ships->isDead[e] && left < shipLeft + PLAYER_SIZE && right > shipLeft &&
+                top < shipTop + PLAYER_SIZE && bottom > shipTop)
+            {
+                store->owner[i] |= PROJECTILE_DEAD_FLAG;
+                hitCount++;
+
+                const float damage = (owner == PROJECTILE_MONSTER_SPREAD) ? scenario->damageMonsterSpreadShot : scenario->damageMonsterProjectile;
+                ships->health[e] -= damage;
+                if (ships->health[e] < 0.0f)
+                    ships->health[e] = 0.0f;
+            }
+        }
+    }
+
+    if (hitCount > 0)
+        RemoveDeadProjectiles(store);
+}
+
+static EnvironmentStatus GetEnvironmentStatus(const EnvironmentBatch* batch, const int e)
+{
+    const float* health = batch->monsters.health;
+
+    bool allMonstersDead = true;
+    for (int m = 0; m < batch->config.scenario.monsterCount && allMonstersDead; m++)
+    {
+        allMonstersDead = health[m * batch->count + e] <= 0.0f;
+    }
+
+    if (allMonstersDead)
+        return ENVIRONMENT_VICTORY;
+    if (batch->ships.isDead[e])
+        return ENVIRONMENT_DEFEAT;
+    return ENVIRONMENT_RUNNING;
+}
+
+void StepEnvironmentBatch(EnvironmentBatch* batch, const PlayerInput* actions, float* outObservations,
+    float* outRewards, unsigned char* outStatuses)
+{
+    const int count = batch->count;
+    const int monsterCount = batch->config.scenario.monsterCount;
+    const EnvironmentRewards* weights = &batch->config.rewards;
+    EnvironmentShips* ships = &batch->ships;
+    const EnvironmentMonsters* monsters = &batch->monsters;
+    ProjectileStore* store = &batch->projectiles;
+
+    // As in UpdateGameState, the store grows before anything is fired, and AddProjectile tries again should it fail
+    ReserveProjectiles(store, store->count + count + batch->shootingMonsters * (1 + MONSTER_SPREAD_SHOT_COUNT));
+
+    // The rest of the current tick: the actions, the monsters' shots and the projectiles
+    for (int e = 0; e < count; e++)
+    {
+        outRewards[e] = 0.0f;
+        outStatuses[e] = ENVIRONMENT_RUNNING;
+        batch->healthBefore[e] = ships->health[e];
+
+        ships->leftThruster[e] = ClampThruster(actions[e].leftThruster);
+        ships->rightThruster[e] = ClampThruster(actions[e].rightThruster);
+        if (actions[e].shoot && ships->shootTimer[e] <= 0.0f)
+        {
+            ships->shootTimer[e] = PLAYER_SHOOT_COOLDOWN;
+            const Vector2 position = { ships->x[e], ships->y[e] };
+            FireProjectile(store, GetShootAngle(ships->rotation[e], actions[e].shootDirection), position, PROJECTILE_PLAYER, e);
+        }
+    }
+
+    if (batch->shootingMonsters > 0)
+    {
+        for (int e = 0; e < count; e++)
+        {
+            const Vector2 target = { ships->x[e], ships->y[e] };
+            for (int m = 0; m < monsterCount; m++)
+            {
+                const int lane = m * count + e;
+                if (monsters->health[lane] > 0.0f && monsters->canShoot[lane])
+                    FireEnvironmentMonsterShots(batch, lane, e, target);
+            }
+        }
+    }
+
+    UpdateEnvironmentProjectiles(batch, outRewards);
+
+    // The next tick up to the next action. Environments out of ticks end before it; their lanes go through it with
+    // the others but are reset before anything reads them.
+    IntegrateShips(batch, 0, count);
+    for (int e = 0; e < count; e++)
+    {
+        if (batch->ticks[e] >= batch->maxTicks)
+        {
+            outStatuses[e] = ENVIRONMENT_TIMEOUT;
+            outRewards[e] -= (batch->healthBefore[e] - ships->health[e]) * weights->damageTaken;
+        }
+    }
+    BeginEnvironmentTicks(batch, 0, count);
+
+    int ended = 0;
+    for (int e = 0; e < count; e++)
+    {
+        if (outStatuses[e] == ENVIRONMENT_RUNNING)
+        {
+            const EnvironmentStatus status = GetEnvironmentStatus(batch, e);
+            if (status == ENVIRONMENT_VICTORY)
+                outRewards[e] += weights->victory;
+            else if (status == ENVIRONMENT_DEFEAT)
+                outRewards[e] -= weights->defeat;
+            outRewards[e] -= (batch->healthBefore[e] - ships->health[e]) * weights->damageTaken;
+            outStatuses[e] = (unsigned char)status;
+        }
+
+        if (outStatuses[e] != ENVIRONMENT_RUNNING)
+        {
+            ended++;
+            ResetEnvironment(batch, e);
+            IntegrateShips(batch, e, 1);
+            BeginEnvironmentTicks(batch, e, 1);
+        }
+    }
+
+    GatherEnvironmentTargets(batch, 0, count);
+    if (outObservations)
+        ObserveEnvironmentBatch(batch, outObservations);
+
+    // The projectiles of the environments that started over go with their old world
+    if (ended > 0)
+    {
+        for (int i = 0; i < store->count; i++)
+        {
+            if (outStatuses[store->monsterIndex[i]] != ENVIRONMENT_RUNNING)
+                store->owner[i] |= PROJECTILE_DEAD_FLAG;
+        }
+        store->snapshotId = 0;
+        RemoveDeadProjectiles(store);
+    }
+}
@@ -0,0 +1,166 @@
+#ifndef ENVIRONMENT_H
+#define ENVIRONMENT_H
+
+#include "main.h"
+
+// Many independent worlds stepped in lockstep, for training agents with reinforcement learning.
+//
+// Each environment plays the same rules as a GameState driven by an AI: one step applies an action where the AI
+// would run, finishes that tick, plays the next one up to where the AI would run again and observes the world
+// from there. An environment whose episode ends is reset to the next seed within the same step, so every step
+// returns the first observation of the new episode along with the reward and status of the one that ended.
+//
+// Ships and monsters are stored as lanes across environments, monster m of environment e at m * count + e, so the
+// ship physics, the monster timers, the proximity damage and the vision tests run on vectors of environments with
+// the same operations as player.c and monster.c. The projectiles of every environment share a single
+// ProjectileStore, and each environment keeps its targets in a row of slots tested a vector at a time. Nothing is
+// allocated after InitEnvironmentBatch but for the projectile store, which only grows when more projectiles are in
+// flight than ever before. A batch is meant for one thread; run one per core.
+
+// Observation of one environment: ENVIRONMENT_SHIP_FEATURES values for the ship, then observedMonsters rows of
+// ENVIRONMENT_MONSTER_FEATURES values for the nearest monsters in vision range as BuildVisibleMonstersArray
+// reports them, zero past the visible ones
+typedef enum EnvironmentShipFeature
+{
+    ENVIRONMENT_SHIP_X,
+    ENVIRONMENT_SHIP_Y,
+    ENVIRONMENT_SHIP_VELOCITY_X,
+    ENVIRONMENT_SHIP_VELOCITY_Y,
+    ENVIRONMENT_SHIP_ROTATION,
+    ENVIRONMENT_SHIP_HEALTH,
+    ENVIRONMENT_SHIP_SHOOT_TIMER,
+    ENVIRONMENT_SHIP_VISIBLE_MONSTERS,
+    ENVIRONMENT_SHIP_FEATURES
+} EnvironmentShipFeature;
+
+typedef enum EnvironmentMonsterFeature
+{
+    ENVIRONMENT_MONSTER_X,
+    ENVIRONMENT_MONSTER_Y,
+    ENVIRONMENT_MONSTER_SIZE,
+    ENVIRONMENT_MONSTER_HEALTH,
+    ENVIRONMENT_MONSTER_INVINCIBLE,
+    ENVIRONMENT_MONSTER_DISTANCE,
+    ENVIRONMENT_MONSTER_BEARING,
+    ENVIRONMENT_MONSTER_RELATIVE_ANGLE,
+    ENVIRONMENT_MONSTER_FEATURES
+} EnvironmentMonsterFeature;
+
+typedef enum EnvironmentStatus
+{
+    ENVIRONMENT_RUNNING,
+    ENVIRONMENT_VICTORY,    // Every monster destroyed
+    ENVIRONMENT_DEFEAT,     // Ship destroyed
+    ENVIRONMENT_TIMEOUT     // maxGameTime played; the episode was cut short rather than lost
+} EnvironmentStatus;
+
+typedef struct EnvironmentRewards // weights of the reward of a step
+{
+    float damageDealt;      // Per unit of monster health taken off
+    float damageTaken;      // Per unit of ship health lost, subtracted
+    float victory;
+    float defeat;           // Subtracted
+} EnvironmentRewards;
+
+typedef struct EnvironmentConfig
+{
+    int environmentCount;
+    unsigned int baseSeed;  // Environment i starts with seed baseSeed + i, later episodes continue the sequence
+    float deltaTime;
+    float maxGameTime;
+    int observedMonsters;   // Monster rows in an observation
+    Scenario scenario;
+    EnvironmentRewards rewards;
+} EnvironmentConfig;
+
+// Ship state, one lane per environment
+typedef struct EnvironmentShips
+{
+    float* x;
+    float* y;
+    float* velocityX;
+    float* velocityY;
+    float* rotation;
+    float* health;
+    float* shootTimer;
+    float* leftThruster;
+    float* rightThruster;
+    float* thrustCosine;            // Scratch of IntegrateShips
+    float* thrustSine;
+    unsigned char* isDead;
+} EnvironmentShips;
+
+// Monster state, one lane per monster of every environment: monster m of environment e is at m * count + e, so each
+// monster index is a run of lanes across environments. A monster is dead once its health is 0, which is when
+// UpdateMonster would mark it. Sprites, colors and the explosion animation are left out: nothing in a step reads them.
+typedef struct EnvironmentMonsters
+{
+    float* x;
+    float* y;
+    float* size;
+    float* health;
+    float* invincibilityTimer;
+    float* shootTimer;
+    float* shootCooldown;
+    float* spreadShotTimer;
+    float* spreadShotCooldown;
+    float* distance;                // From the ship for the observations, infinity when out of sight
+    unsigned char* canShoot;
+} EnvironmentMonsters;
+
+// What the ship's projectiles can hit, per environment: counts[e] hitboxes in monster index order from slot
+// e * stride, and the box around them, which rejects most projectiles at once. Nothing changes it between the end
+// of a step and the next projectile pass, so it is gathered along with the observations.
+typedef struct EnvironmentTargets
+{
+    int stride;                     // Monster count rounded up to whole vectors
+    int* counts;
+    int* monsters;
+    float* minX;
+    float* minY;
+    float* maxX;
+    float* maxY;
+    float* boundsMinX;              // One per environment
+    float* boundsMinY;
+    float* boundsMaxX;
+    float* boundsMaxY;
+} EnvironmentTargets;
+
+typedef struct EnvironmentBatch
+{
+    EnvironmentConfig config;
+    int count;
+    int observationSize;            // Floats per environment in an observation
+    long maxTicks;
+    unsigned int nextSeed;
+
+    EnvironmentShips ships;
+    EnvironmentMonsters monsters;
+    EnvironmentTargets targets;
+    unsigned int* seeds;            // Seed of each environment's current episode
+    long* ticks;                    // Ticks played in each environment's current episode
+    int* scores;                    // Hits scored in each environment's current episode
+    float* healthBefore;            // Scratch of StepEnvironmentBatch
+    MonsterView* views;             // Observation scratch, one environment at a time
+    MonsterView* viewScratch;
+    int shootingMonsters;           // Monsters that can shoot across all environments, to bound each tick's spawns
+
+    ProjectileStore projectiles;    // Every environment's projectiles; monsterIndex holds the environment instead
+    GameState generator;            // Worlds are generated here and copied into the lanes
+    void* block;                    // Single allocation holding every lane above
+} EnvironmentBatch;
+
+void InitDefaultEnvironmentConfig(EnvironmentConfig* config);
+
+// Generates the first episode of every environment. outObservations receives count * observationSize floats.
+bool InitEnvironmentBatch(EnvironmentBatch* batch, const EnvironmentConfig* config, float* outObservations);
+void FreeEnvironmentBatch(EnvironmentBatch* batch);
+
+// Applies one action per environment (thrusters clamped to [-1, 1], shots subject to the cooldown) and advances
+// every environment by one tick. outRewards and outStatuses receive one value per environment (EnvironmentStatus
+// values); outObservations the observations to act on next, of the new episode for the environments that ended.
+void StepEnvironmentBatch(EnvironmentBatch* batch, const PlayerInput* actions, float* outObservations,
+    float* outRewards, unsigned char* outStatuses);
+void ObserveEnvironmentBatch(EnvironmentBatch* batch, float* outObservations);
+
+#endif // ENVIRONMENT_H
@@ -0,0 +1,291 @@
+#include "game.h"
+#include "monster.h"
+#include "player.h"
+#include "player_control.h"
+#include "config.h"
+#include <math.h>
+#include <string.h>
+
+// What the ship knows at the start of the tick, gathered by the first forecast. Every rollout copies it into the
+// scratch below and plays on the copy, so the tick's forecasts only pay for gathering once.
+struct PlayerForecastWorld
+{
+    Monster* monsters;                  // The monsters handed to the AI, with their timers
+    int monsterCount;
+    ProjectileStore projectiles;        // The projectiles within its vision radius
+    Monster* rolloutMonsters;
+    int* hittableMonsters;              // Scratch for the projectile pass
+    ProjectileStore rolloutProjectiles; // Frame arena block, replaced by a larger one when a rollout fills it
+};
+
+// Same test as BuildVisibleMonstersArray
+static bool IsMonsterInView(const Monster* monster, const Player* player)
+{
+    const float dx = player->position.x - monster->position.x;
+    const float dy = player->position.y - monster->position.y;
+    return !IsMonsterDead(monster) && sqrtf(dx * dx + dy * dy) <= PLAYER_VISION_RADIUS;
+}
+
+static bool IsProjectileInView(const ProjectileStore* projectiles, const int index, const Player* player)
+{
+    const float dx = player->position.x - projectiles->x[index];
+    const float dy = player->position.y - projectiles->y[index];
+    return sqrtf(dx * dx + dy * dy) <= PLAYER_VISION_RADIUS;
+}
+
+static int GetForecastSpawnsPerTick(const PlayerForecastWorld* world)
+{
+    return 1 + world->monsterCount * (1 + MONSTER_SPREAD_SHOT_COUNT);
+}
+
+static PlayerForecastWorld* PrepareForecastWorld(PlayerControl* control)
+{
+    if (control->forecastWorld)
+        return control->forecastWorld;
+
+    const GameState* game = control->game;
+    const Player* player = control->player;
+    FrameArena* arena = control->frameArena;
+
+    int monsterCount = 0;
+    for (int m = 0; m < game->scenario.monsterCount; m++)
+    {
+        if (IsMonsterInView(&game->monsters[m], player))
+            monsterCount++;
+    }
+
+    int projectileCount = 0;
+    for (int i = 0; i < game->projectiles.count; i++)
+    {
+        if (IsProjectileInView(&game->projectiles, i, player))
+            projectileCount++;
+    }
+
+    PlayerForecastWorld* world = (PlayerForecastWorld*)FrameArenaAlloc(arena, sizeof(PlayerForecastWorld));
+    if (!world)
+        return NULL;
+    world->monsterCount = monsterCount;
+    world->monsters = FRAME_ARENA_ALLOC_ARRAY(arena, Monster, monsterCount);
+    world->rolloutMonsters = FRAME_ARENA_ALLOC_ARRAY(arena, Monster, monsterCount);
+    world->hittableMonsters = FRAME_ARENA_ALLOC_ARRAY(arena, int, monsterCount);
+    void* block = FrameArenaAlloc(arena, GetProjectileBlockSize(projectileCount));
+    const int rolloutCapacity = projectileCount + GetForecastSpawnsPerTick(world);
+    void* rolloutBlock = FrameArenaAlloc(arena, GetProjectileBlockSize(rolloutCapacity));
+    if (!world->monsters || !world->rolloutMonsters || !world->hittableMonsters || !block || !rolloutBlock)
+        return NULL;
+
+    int count = 0;
+    for (int m = 0; m < game->scenario.monsterCount; m++)
+    {
+        if (IsMonsterInView(&game->monsters[m], player))
+            world->monsters[count++] = game->monsters[m];
+    }
+
+    InitProjectileStoreInBlock(&world->projectiles, block, projectileCount);
+    for (int i = 0; i < game->projectiles.count; i++)
+    {
+        if (IsProjectileInView(&game->projectiles, i, player))
+        {
+            const Vector2 position = { game->projectiles.x[i], game->projectiles.y[i] };
+            const Vector2 velocity = { game->projectiles.velocityX[i], game->projectiles.velocityY[i] };
+            AddProjectile(&world->projectiles, position, velocity, (ProjectileOwner)game->projectiles.owner[i], game->projectiles.monsterIndex[i]);
+        }
+    }
+
+    InitProjectileStoreInBlock(&world->rolloutProjectiles, rolloutBlock, rolloutCapacity);
+    control->forecastWorld = world;
+    return world;
+}
+
+static bool ReserveForecastProjectiles(PlayerControl* control, ProjectileStore* store, int capacity)
+{
+    if (capacity <= store->capacity)
+        return true;
+
+    if (capacity < store->capacity * 2)
+        capacity = store->capacity * 2;
+
+    void* block = FrameArenaAlloc(control->frameArena, GetProjectileBlockSize(capacity));
+    if (!block)
+        return false;
+
+    ProjectileStore grown;
+    InitProjectileStoreInBlock(&grown, block, capacity);
+    CopyProjectiles(&grown, store);
+    *store = grown;
+    return true;
+}
+
+// The monsters the ship's projectiles can hit this tick, as in UpdateProjectiles: death and visibility are settled
+// before the pass and invincibility is checked on every test. Their bounding box rejects most projectiles at once.
+static int GatherForecastTargets(PlayerForecastWorld* world, const Player* player, Rectangle* outBounds)
+{
+    int count = 0;
+    float left = 0.0f;
+    float top = 0.0f;
+    float right = 0.0f;
+    float bottom = 0.0f;
+    for (int m = 0; m < world->monsterCount; m++)
+    {
+        const Monster* monster = &world->rolloutMonsters[m];
+        if (IsMonsterDead(monster) || monster->invincibilityTimer > 0.0f || !IsMonsterVisible(monster, player))
+            continue;
+
+        const Rectangle hitbox = GetMonsterHitbox(monster);
+        if (count == 0 || hitbox.x < left)
+            left = hitbox.x;
+        if (count == 0 || hitbox.y < top)
+            top = hitbox.y;
+        if (count == 0 || hitbox.x + hitbox.width > right)
+            right = hitbox.x + hitbox.width;
+        if (count == 0 || hitbox.y + hitbox.height > bottom)
+            bottom = hitbox.y + hitbox.height;
+        world->hittableMonsters[count++] = m;
+    }
+
+    *outBounds = (Rectangle){ left, top, right - left, bottom - top };
+    return count;
+}
+
+// UpdateProjectiles without the effects, the score and the broadphase, which do not pay off for a handful of monsters
+static void UpdateForecastProjectiles(const GameState* game, PlayerForecastWorld* world, Player* player, const float deltaTime, PlayerForecastResult* result)
+{
+    ProjectileStore* store = &world->rolloutProjectiles;
+
+    IntegrateProjectiles(store, deltaTime);
+    CullProjectilesOutOfBounds(store, GetProjectileBounds(game));
+
+    const Rectangle playerHitbox = GetPlayerHitbox(player);
+    int hitCount = 0;
+
+    // Gathered on the first of the ship's projectiles, so ticks without any in flight skip it
+    int hittableCount = -1;
+    Rectangle hittableBounds = { 0 };
+
+    for (int i = 0; i < store->count; i++)
+    {
+        const Rectangle projectileRect =
+        {
+            store->x[i] - PROJECTILE_SIZE / 2,
+            store->y[i] - PROJECTILE_SIZE / 2,
+            PROJECTILE_SIZE,
+            PROJECTILE_SIZE
+        };
+        const ProjectileOwner owner = (ProjectileOwner)store->owner[i];
+
+        if (owner == PROJECTILE_PLAYER)
+        {
+            if (hittableCount < 0)
+                hittableCount = GatherForecastTargets(world, player, &hittableBounds);
+            if (hittableCount == 0 || !RectanglesOverlap(projectileRect, hittableBounds))
+                continue;
+
+            for (int h = 0; h < hittableCount; h++)
+            {
+                Monster* monster = &world->rolloutMonsters[world->hittableMonsters[h]];
+                if (monster->invincibilityTimer > 0.0f || !RectanglesOverlap(projectileRect, GetMonsterHitbox(monster)))
+                    continue;
+
+                store->owner[i] |= PROJECTILE_DEAD_FLAG;
+                hitCount++;
+
+                const float health = monster->health;
+                DamageMonster(monster, game->scenario.damagePlayerProjectile);
+                result->damageDealt += health - monster->health;
+                if (monster->health <= 0.0f)
+                    result->monstersDestroyed++;
+                break;
+            }
+        }
+        else if (owner == PROJECTILE_MONSTER || owner == PROJECTILE_MONSTER_SPREAD)
+        {
+            if (!IsPlayerDead(player) && RectanglesOverlap(projectileRect, playerHitbox))
+            {
+                store->owner[i] |= PROJECTILE_DEAD_FLAG;
+                hitCount++;
+
+                const float damage = (owner == PROJECTILE_MONSTER_SPREAD) ? game->scenario.damageMonsterSpreadShot : game->scenario.damageMonsterProjectile;
+                player->health -= damage;
+                if (player->health < 0.0f)
+                    player->health = 0.0f;
+            }
+        }
+    }
+
+    if (hitCount > 0)
+        RemoveDeadProjectiles(store);
+}
+
+bool PlayerControlForecast(PlayerControl* control, const PlayerInput* inputs, const int tickCount, PlayerForecastResult* outForecast)
+{
+    if (control == NULL || control->game == NULL || control->player == NULL || inputs == NULL || outForecast == NULL || tickCount < 0)
+        return false;
+
+    PlayerForecastWorld* world = PrepareForecastWorld(control);
+    if (!world)
+        return false;
+
+    const GameState* game = control->game;
+    const float deltaTime = control->deltaTime;
+    const Vector2 arenaSize = { game->scenario.arenaWidth, game->scenario.arenaHeight };
+    Monster* monsters = world->rolloutMonsters;
+    memcpy(monsters, world->monsters, sizeof(Monster) * (size_t)world->monsterCount);
+    CopyProjectiles(&world->rolloutProjectiles, &world->projectiles);
+
+    // The commands go through a control of the copied ship, so they follow the cooldown and clamping rules of
+    // the real ones. A shot already requested this tick is fired at tick 0 along with inputs[0].
+    Player player = *control->player;
+    PlayerControl shipControl;
+    memset(&shipControl, 0, sizeof(shipControl));
+    shipControl.player = &player;
+
+    PlayerForecastResult result;
+    memset(&result, 0, sizeof(result));
+
+    int tick = 0;
+    for (; tick < tickCount; tick++)
+    {
+        // The current tick has played up to the AI call already
+        if (tick > 0)
+        {
+            for (int m = 0; m < world->monsterCount; m++)
+            {
+                UpdateMonster(&monsters[m], deltaTime);
+            }
+
+            UpdatePlayer(&player, deltaTime, arenaSize);
+            if (IsPlayerDead(&player))
+                break;
+            ApplyProximityDamage(player.position, &player.health, monsters, world->monsterCount, game->scenario.damageProximityPerSecond, deltaTime);
+        }
+
+        if (!ReserveForecastProjectiles(control, &world->rolloutProjectiles, world->rolloutProjectiles.count + GetForecastSpawnsPerTick(world)))
+            return false;
+
+        shipControl.shootRequested = tick == 0 && control->shootRequested;
+        shipControl.shootDirection = control->shootDirection;
+        PlayerControlSetThrusters(&shipControl, inputs[tick].leftThruster, inputs[tick].rightThruster);
+        if (inputs[tick].shoot)
+            PlayerControlShoot(&shipControl, inputs[tick].shootDirection);
+
+        ShootDirection direction;
+        if (PlayerDidShoot(&shipControl, &direction))
+            FireProjectile(&world->rolloutProjectiles, GetShootAngle(player.rotation, direction), player.position, PROJECTILE_PLAYER, -1);
+
+        for (int m = 0; m < world->monsterCount; m++)
+        {
+            if (!IsMonsterDead(&monsters[m]) && monsters[m].canShoot)
+                FireMonsterShots(&world->rolloutProjectiles, &monsters[m], m, player.position);
+        }
+
+        UpdateForecastProjectiles(game, world, &player, deltaTime, &result);
+    }
+
+    result.position = player.position;
+    result.velocity = player.velocity;
+    result.rotation = player.rotation;
+    result.health = player.health;
+    result.ticks = tick;
+    *outForecast = result;
+    return true;
+}
@@ -0,0 +1,104 @@
+#include "frame_arena.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+struct FrameArenaChunk // Header of an overflow chunk, followed by its aligned data
+{
+    FrameArenaChunk* next;
+};
+
+static size_t AlignFrameArenaSize(const size_t size)
+{
+    return (size + FRAME_ARENA_ALIGNMENT - 1) / FRAME_ARENA_ALIGNMENT * FRAME_ARENA_ALIGNMENT;
+}
+
+// malloc only guarantees alignment for the platform's basic types, so blocks are over-allocated and aligned by hand
+static unsigned char* AlignFrameArenaPointer(unsigned char* pointer)
+{
+    return (unsigned char*)AlignFrameArenaSize((size_t)(uintptr_t)pointer);
+}
+
+static void FreeOverflowChunks(FrameArena* arena)
+{
+    FrameArenaChunk* chunk = arena->overflow;
+    while (chunk)
+    {
+        FrameArenaChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    arena->overflow = NULL;
+    arena->overflowUsed = 0;
+}
+
+static bool AllocateFrameArenaBlock(FrameArena* arena, const size_t capacity)
+{
+    unsigned char* allocation = (unsigned char*)malloc(capacity + FRAME_ARENA_ALIGNMENT - 1);
+    if (!allocation)
+        return false;
+
+    free(arena->allocation);
+    arena->allocation = allocation;
+    arena->block = AlignFrameArenaPointer(allocation);
+    arena->capacity = capacity;
+    return true;
+}
+
+bool InitFrameArena(FrameArena* arena, const size_t capacity)
+{
+    arena->allocation = NULL;
+    arena->block = NULL;
+    arena->capacity = 0;
+    arena->used = 0;
+    arena->overflow = NULL;
+    arena->overflowUsed = 0;
+    arena->highWaterMark = 0;
+    return AllocateFrameArenaBlock(arena, AlignFrameArenaSize(capacity));
+}
+
+void FreeFrameArena(FrameArena* arena)
+{
+    FreeOverflowChunks(arena);
+    free(arena->allocation);
+    arena->allocation = NULL;
+    arena->block = NULL;
+    arena->capacity = 0;
+    arena->used = 0;
+}
+
+void ResetFrameArena(FrameArena* arena)
+{
+    const size_t tickUsage = arena->used + arena->overflowUsed;
+    if (tickUsage > arena->highWaterMark)
+        arena->highWaterMark = tickUsage;
+
+    if (arena->overflow)
+    {
+        FreeOverflowChunks(arena);
+
+        // If growing fails the old block stays and the next busy tick overflows again
+        AllocateFrameArenaBlock(arena, AlignFrameArenaSize(arena->highWaterMark + arena->highWaterMark / 2));
+    }
+
+    arena->used = 0;
+}
+
+void* FrameArenaAlloc(FrameArena* arena, const size_t size)
+{
+    const size_t alignedSize = AlignFrameArenaSize(size);
+    if (arena->block && arena->used + alignedSize <= arena->capacity)
+    {
+        void* pointer = arena->block + arena->used;
+        arena->used += alignedSize;
+        return pointer;
+    }
+
+    FrameArenaChunk* chunk = (FrameArenaChunk*)malloc(sizeof(FrameArenaChunk) + FRAME_ARENA_ALIGNMENT - 1 + alignedSize);
+    if (!chunk)
+        return NULL;
+
+    chunk->next = arena->overflow;
+    arena->overflow = chunk;
+    arena->overflowUsed += alignedSize;
+    return AlignFrameArenaPointer((unsigned char*)(chunk + 1));
+}
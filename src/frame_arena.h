@@ -0,0 +1,37 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define FRAME_ARENA_ALIGNMENT 16
+
+typedef struct FrameArenaChunk FrameArenaChunk;
+
+// Bump allocator for memory that only lives until the end of a simulation tick. Allocating is a pointer
+// increment and everything is released at once by ResetFrameArena. When a tick needs more than the block
+// holds, overflow chunks are taken from the heap, and the next reset grows the block to cover that tick,
+// so steady-state ticks never touch the heap.
+typedef struct FrameArena
+{
+    unsigned char* allocation;  // What malloc returned; block is aligned within it
+    unsigned char* block;
+    size_t capacity;
+    size_t used;
+    FrameArenaChunk* overflow;  // Chunks allocated this tick once the block was full
+    size_t overflowUsed;        // Bytes handed out from overflow chunks this tick
+    size_t highWaterMark;       // Most bytes used by one tick since the arena was created
+} FrameArena;
+
+bool InitFrameArena(FrameArena* arena, size_t capacity);
+void FreeFrameArena(FrameArena* arena);
+
+// Invalidates every allocation made since the previous reset
+void ResetFrameArena(FrameArena* arena);
+
+// Returns FRAME_ARENA_ALIGNMENT-aligned memory valid until the next reset, or NULL if the heap is exhausted
+void* FrameArenaAlloc(FrameArena* arena, size_t size);
+
+#define FRAME_ARENA_ALLOC_ARRAY(arena, type, count) ((type*)FrameArenaAlloc((arena), sizeof(type) * (size_t)(count)))
+
+#endif // FRAME_ARENA_H
@@ -0,0 +1,699 @@
+#include "game.h"
+#include "monster.h"
+#include "player.h"
+#include "player_control.h"
+#include "config.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WORLD_BLOCK_ALIGNMENT 16
+
+// Same test as raylib's CheckCollisionRecs, kept here so the simulation does not need to link raylib
+bool RectanglesOverlap(const Rectangle a, const Rectangle b)
+{
+    return a.x < b.x + b.width && a.x + a.width > b.x &&
+           a.y < b.y + b.height && a.y + a.height > b.y;
+}
+
+bool IsPositionSafe(const Vector2 pos, const Monster* monsters, const int monsterCount, const float minDistance)
+{
+    for (int i = 0; i < monsterCount; i++) 
+    {
+        const float dx = pos.x - monsters[i].position.x;
+        const float dy = pos.y - monsters[i].position.y;
+        const float dist = sqrtf(dx * dx + dy * dy);
+        if (dist < minDistance + monsters[i].size)
+            return false;
+    }
+
+    return true;
+}
+
+Rectangle GetProjectileBounds(const GameState* game)
+{
+    return (Rectangle){
+        -PROJECTILE_CULL_MARGIN,
+        -PROJECTILE_CULL_MARGIN,
+        game->scenario.arenaWidth + 2 * PROJECTILE_CULL_MARGIN,
+        game->scenario.arenaHeight + 2 * PROJECTILE_CULL_MARGIN
+    };
+}
+
+void* CarveWorldBlock(unsigned char* block, size_t* offset, const size_t size)
+{
+    *offset = (*offset + WORLD_BLOCK_ALIGNMENT - 1) / WORLD_BLOCK_ALIGNMENT * WORLD_BLOCK_ALIGNMENT;
+    void* pointer = block ? block + *offset : NULL;
+    *offset += size;
+    return pointer;
+}
+
+// Points the scenario-sized arrays into block and returns the block size they need.
+// Called with NULL first to measure, then with the allocated block.
+size_t LayoutWorldBlock(GameState* game, unsigned char* block)
+{
+    const size_t monsterCount = (size_t)game->scenario.monsterCount;
+    size_t offset = 0;
+
+    game->monsters = (Monster*)CarveWorldBlock(block, &offset, sizeof(Monster) * monsterCount);
+    game->stars = (Star*)CarveWorldBlock(block, &offset, sizeof(Star) * (size_t)game->scenario.starCount);
+
+    return offset;
+}
+
+// Per-tick scratch the engine takes from the frame arena: visible monster views and their sort buffer,
+// hittable monster indices and their grown hitboxes. Sizing the arena for it up front keeps even the first
+// ticks off the heap.
+size_t GetEngineFrameArenaSize(const Scenario* scenario)
+{
+    const size_t monsterCount = (size_t)scenario->monsterCount;
+    return 2 * sizeof(MonsterView) * monsterCount + sizeof(int) * monsterCount + sizeof(Rectangle) * monsterCount +
+           4 * FRAME_ARENA_ALIGNMENT;
+}
+
+// Worst case of projectiles fired in one tick: the player, plus every monster firing and spreading at once
+int GetMaxProjectileSpawnsPerTick(const GameState* game)
+{
+    return 1 + game->scenario.monsterCount * (1 + MONSTER_SPREAD_SHOT_COUNT);
+}
+
+bool AllocateWorldBlock(GameState* game)
+{
+    const size_t size = LayoutWorldBlock(game, NULL);
+    unsigned char* block = (unsigned char*)calloc(1, size);
+    if (!block)
+        return false;
+
+    LayoutWorldBlock(game, block);
+    game->worldBlock = block;
+    return true;
+}
+
+void InitializeMonsters(GameState* game)
+{
+    const float arenaWidth = game->scenario.arenaWidth;
+    const float arenaHeight = game->scenario.arenaHeight;
+
+    for (int i = 0; i < game->scenario.monsterCount; i++)
+    {
+        const float size = RandomRange(&game->worldRandom, MONSTER_MIN_SIZE, MONSTER_MAX_SIZE);
+        
+        Vector2 monsterPos;
+        int attempts = 0;
+        do
+        {
+            monsterPos.x = RandomRange(&game->worldRandom, size, arenaWidth - size);
+            monsterPos.y = RandomRange(&game->worldRandom, size, arenaHeight - size);
+            attempts++;
+        } while (attempts < 100 && !IsPositionSafe(monsterPos, game->monsters, i, size * 2));
+        
+        InitMonster(&game->monsters[i], monsterPos, size);
+    }
+}
+
+void InitializePlayerAtSafePosition(GameState* game)
+{
+    const float arenaWidth = game->scenario.arenaWidth;
+    const float arenaHeight = game->scenario.arenaHeight;
+
+    Vector2 playerPos;
+    int attempts = 0;
+    do
+    {
+        playerPos.x = RandomRange(&game->worldRandom, PLAYER_SIZE, arenaWidth - PLAYER_SIZE);
+        playerPos.y = RandomRange(&game->worldRandom, PLAYER_SIZE, arenaHeight - PLAYER_SIZE);
+        attempts++;
+    } while (attempts < 100 && !IsPositionSafe(playerPos, game->monsters, game->scenario.monsterCount, PLAYER_SIZE * 3));
+    
+    InitPlayer(&game->player, playerPos, PLAYER_SIZE);
+}
+
+bool AllocateGameState(GameState* game, const Scenario* scenario)
+{
+    memset(game, 0, sizeof(GameState));
+    game->scenario = *scenario;
+
+    if (!AllocateWorldBlock(game) ||
+        !InitFrameArena(&game->frameArena, GetEngineFrameArenaSize(scenario) + FRAME_ARENA_AI_CAPACITY) ||
+        !InitProjectileStore(&game->projectiles, PROJECTILE_INITIAL_CAPACITY) ||
+        !InitCollisionGrid(&game->monsterGrid, GetProjectileBounds(game), COLLISION_GRID_CELL_SIZE) ||
+        !InitEffectPool(&game->hitEffects, sizeof(HitEffect), game->scenario.hitEffectCapacity) ||
+        !InitEffectPool(&game->deathExplosions, sizeof(DeathExplosion), game->scenario.monsterCount + 1))
+    {
+        CleanupGameState(game);
+        return false;
+    }
+    return true;
+}
+
+bool InitGameState(GameState* game, const Scenario* scenario, const unsigned int seed)
+{
+    if (!AllocateGameState(game, scenario))
+        return false;
+
+    GenerateWorld(game, seed);
+    return true;
+}
+
+void GenerateWorld(GameState* game, const unsigned int seed)
+{
+    SeedRandom(&game->worldRandom, seed, RANDOM_STREAM_WORLD);
+    SeedRandom(&game->aiRandom, seed, RANDOM_STREAM_AI);
+
+    InitializeMonsters(game);
+    InitializePlayerAtSafePosition(game);
+    
+    for (int i = 0; i < game->scenario.starCount; i++)
+    {
+        game->stars[i].position = (Vector2){
+            (float)RandomInt(&game->worldRandom, 0, (int)game->scenario.arenaWidth),
+            (float)RandomInt(&game->worldRandom, 0, (int)game->scenario.arenaHeight)
+        };
+        game->stars[i].size = RandomInt(&game->worldRandom, STAR_MIN_SIZE, STAR_MAX_SIZE);
+        game->stars[i].phase = (float)RandomInt(&game->worldRandom, 0, 628) / 100.0f;
+    }
+    
+    game->score = 0;
+    game->gameTime = 0.0f;
+    game->newProjectileCount = 0;
+}
+
+void CreateHitEffect(GameState* game, Vector2 position, Color color)
+{
+    HitEffect* effect = (HitEffect*)AcquireEffect(&game->hitEffects);
+    if (!effect)
+        return;
+
+    effect->position = position;
+    effect->timer = HIT_EFFECT_DURATION;
+    effect->color = color;
+}
+
+void UpdateHitEffects(GameState* game, const float deltaTime)
+{
+    // Walk backwards so the item moved into a released slot has already been updated
+    for (int i = game->hitEffects.count - 1; i >= 0; i--)
+    {
+        HitEffect* effect = (HitEffect*)GetEffect(&game->hitEffects, i);
+        effect->timer -= deltaTime;
+        if (effect->timer <= 0.0f)
+            ReleaseEffect(&game->hitEffects, i);
+    }
+}
+
+void CreateDeathExplosion(GameState* game, Vector2 position, Color color, float size)
+{
+    DeathExplosion* explosion = (DeathExplosion*)AcquireEffect(&game->deathExplosions);
+    if (!explosion)
+        return;
+
+    explosion->position = position;
+    explosion->timer = DEATH_EXPLOSION_DURATION;
+    explosion->color = color;
+    explosion->size = size;
+}
+
+void UpdateDeathExplosions(GameState* game, float deltaTime)
+{
+    for (int i = game->deathExplosions.count - 1; i >= 0; i--)
+    {
+        DeathExplosion* explosion = (DeathExplosion*)GetEffect(&game->deathExplosions, i);
+        explosion->timer -= deltaTime;
+        if (explosion->timer <= 0.0f)
+            ReleaseEffect(&game->deathExplosions, i);
+    }
+}
+
+void ShootProjectile(GameState* game, float angleInDegrees, Vector2 position, ProjectileOwner owner, int monsterIndex)
+{
+    FireProjectile(&game->projectiles, angleInDegrees, position, owner, monsterIndex);
+}
+
+// Monsters player projectiles can hit this tick, in index order. Death and visibility cannot change
+// during the projectile pass, but invincibility can start, so it is checked again on every test.
+int GatherHittableMonsters(const GameState* game, int* outMonsters)
+{
+    int count = 0;
+    for (int m = 0; m < game->scenario.monsterCount; m++)
+    {
+        if (!IsMonsterDead(&game->monsters[m]) && game->monsters[m].invincibilityTimer <= 0.0f && IsMonsterVisible(&game->monsters[m], &game->player))
+        {
+            outMonsters[count++] = m;
+        }
+    }
+    return count;
+}
+
+// Registers the hittable monsters in the grid. Hitboxes are grown by half a projectile (plus a pixel for
+// rounding) so that any projectile overlapping a monster has its center in one of that monster's cells.
+bool BuildMonsterCollisionGrid(GameState* game, const int* monsters, const int count)
+{
+    Rectangle* boxes = FRAME_ARENA_ALLOC_ARRAY(&game->frameArena, Rectangle, count);
+    if (!boxes)
+        return false;
+    const float padding = PROJECTILE_SIZE / 2 + 1.0f;
+    for (int i = 0; i < count; i++)
+    {
+        const Rectangle hitbox = GetMonsterHitbox(&game->monsters[monsters[i]]);
+        boxes[i] = (Rectangle){
+            hitbox.x - padding,
+            hitbox.y - padding,
+            hitbox.width + 2 * padding,
+            hitbox.height + 2 * padding
+        };
+    }
+    return BuildCollisionGrid(&game->monsterGrid, boxes, monsters, count);
+}
+
+int FindMonsterHitByProjectile(const GameState* game, const Rectangle projectileRect, const int* candidates, const int candidateCount)
+{
+    for (int c = 0; c < candidateCount; c++)
+    {
+        const Monster* monster = &game->monsters[candidates[c]];
+        if (monster->invincibilityTimer <= 0.0f && RectanglesOverlap(projectileRect, GetMonsterHitbox(monster)))
+            return candidates[c];
+    }
+    return -1;
+}
+
+// Same as gathering the hittable monsters and searching them, for when there is no memory to gather them into
+int FindAnyMonsterHitByProjectile(const GameState* game, const Rectangle projectileRect)
+{
+    for (int m = 0; m < game->scenario.monsterCount; m++)
+    {
+        const Monster* monster = &game->monsters[m];
+        if (!IsMonsterDead(monster) && monster->invincibilityTimer <= 0.0f && IsMonsterVisible(monster, &game->player) &&
+            RectanglesOverlap(projectileRect, GetMonsterHitbox(monster)))
+            return m;
+    }
+    return -1;
+}
+
+void UpdateProjectiles(GameState* game, float deltaTime)
+{
+    ProjectileStore* store = &game->projectiles;
+
+    IntegrateProjectiles(store, deltaTime);
+    CullProjectilesOutOfBounds(store, GetProjectileBounds(game));
+    // Culling keeps the order, so the projectiles fired this tick are still the last ones
+    if (game->newProjectileCount > store->count)
+        game->newProjectileCount = store->count;
+
+    const Rectangle playerHitbox = GetPlayerHitbox(&game->player);
+    int hitCount = 0;
+
+    int* hittableMonsters = FRAME_ARENA_ALLOC_ARRAY(&game->frameArena, int, game->scenario.monsterCount);
+    const int hittableCount = hittableMonsters ? GatherHittableMonsters(game, hittableMonsters) : 0;
+    const bool useGrid = ShouldUseCollisionGrid(hittableCount, store->playerCount) &&
+                         BuildMonsterCollisionGrid(game, hittableMonsters, hittableCount);
+
+    for (int i = 0; i < store->count; i++)
+    {
+        const Vector2 position = { store->x[i], store->y[i] };
+        const Rectangle projectileRect =
+        {
+            position.x - PROJECTILE_SIZE / 2,
+            position.y - PROJECTILE_SIZE / 2,
+            PROJECTILE_SIZE,
+            PROJECTILE_SIZE
+        };
+        const ProjectileOwner owner = (ProjectileOwner)store->owner[i];
+        
+        if (owner == PROJECTILE_PLAYER)
+        {
+            const int* candidates = hittableMonsters;
+            int candidateCount = hittableCount;
+            if (useGrid)
+                candidateCount = QueryCollisionGrid(&game->monsterGrid, position, &candidates);
+
+            const int m = hittableMonsters ? FindMonsterHitByProjectile(game, projectileRect, candidates, candidateCount)
+                                           : FindAnyMonsterHitByProjectile(game, projectileRect);
+            if (m >= 0)
+            {
+                store->owner[i] |= PROJECTILE_DEAD_FLAG;
+                store->snapshotId = 0;
+                hitCount++;
+                game->score++;
+                DamageMonster(&game->monsters[m], game->scenario.damagePlayerProjectile);
+                CreateHitEffect(game, position, ORANGE);
+            }
+        }
+        else if (owner == PROJECTILE_MONSTER || owner == PROJECTILE_MONSTER_SPREAD)
+        {
+            if (!IsPlayerDead(&game->player) && RectanglesOverlap(projectileRect, playerHitbox))
+            {
+                store->owner[i] |= PROJECTILE_DEAD_FLAG;
+                store->snapshotId = 0;
+                hitCount++;
+
+                const float damage = (owner == PROJECTILE_MONSTER_SPREAD) ? game->scenario.damageMonsterSpreadShot : game->scenario.damageMonsterProjectile;
+                game->player.health -= damage;
+                if (game->player.health < 0.0f)
+                    game->player.health = 0.0f;
+            }
+        }
+    }
+    
+    if (hitCount > 0)
+    {
+        const int newCount = game->newProjectileCount;
+        for (int i = store->count - newCount; i < store->count; i++)
+        {
+            if (store->owner[i] & PROJECTILE_DEAD_FLAG)
+                game->newProjectileCount--;
+        }
+        RemoveDeadProjectiles(store);
+    }
+}
+
+bool AreAllMonstersDead(GameState* game)
+{
+    for (int i = 0; i < game->scenario.monsterCount; i++)
+    {
+        if (!IsMonsterDead(&game->monsters[i]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void UpdateAllMonsters(GameState* game, const float deltaTime)
+{
+    for (int i = 0; i < game->scenario.monsterCount; i++) 
+    {
+        const bool wasAlive = !IsMonsterDead(&game->monsters[i]);
+        UpdateMonster(&game->monsters[i], deltaTime);
+        const bool isNowDead = IsMonsterDead(&game->monsters[i]);
+        
+        if (wasAlive && isNowDead)
+            CreateDeathExplosion(game, game->monsters[i].position, RED, game->monsters[i].size * 1.5f);
+    }
+}
+
+void ApplyProximityDamage(const Vector2 position, float* health, const Monster* monsters, const int monsterCount, const float damagePerSecond, const float deltaTime)
+{
+    for (int i = 0; i < monsterCount; i++)
+    {
+        if (!IsMonsterDead(&monsters[i]))
+        {
+            const float dx = position.x - monsters[i].position.x;
+            const float dy = position.y - monsters[i].position.y;
+            const float distance = sqrtf(dx * dx + dy * dy);
+            const float dangerZone = monsters[i].size;
+            
+            if (distance < dangerZone)
+            {
+                *health -= damagePerSecond * deltaTime;
+                if (*health < 0.0f)
+                    *health = 0.0f;
+            }
+        }
+    }
+}
+
+void ApplyProximityDamageToPlayer(GameState* game, float deltaTime)
+{
+    ApplyProximityDamage(game->player.position, &game->player.health, game->monsters, game->scenario.monsterCount, game->scenario.damageProximityPerSecond, deltaTime);
+}
+
+float WrapRelativeAngle(const float angle)
+{
+    // Within two turns fmodf comes down to one subtraction, which is exact there
+    float wrapped = angle + 180.0f;
+    if (wrapped >= 360.0f && wrapped < 720.0f)
+        wrapped -= 360.0f;
+    else if (wrapped <= -360.0f && wrapped > -720.0f)
+        wrapped += 360.0f;
+    else if (wrapped >= 720.0f || wrapped <= -720.0f)
+        wrapped = fmodf(wrapped, 360.0f);
+    if (wrapped < 0.0f)
+        wrapped += 360.0f;
+    return wrapped - 180.0f;
+}
+
+#define MONSTER_VIEW_SORT_RUN 16
+
+// Stable merge sort on distance, so monsters at equal distances keep their index order. scratch holds count views.
+// (qsort is not stable and may allocate.)
+void SortMonsterViewsByDistance(MonsterView* views, MonsterView* scratch, const int count)
+{
+    for (int start = 0; start < count; start += MONSTER_VIEW_SORT_RUN)
+    {
+        const int end = start + MONSTER_VIEW_SORT_RUN < count ? start + MONSTER_VIEW_SORT_RUN : count;
+        for (int i = start + 1; i < end; i++)
+        {
+            const MonsterView view = views[i];
+            int j = i;
+            while (j > start && views[j - 1].distance > view.distance)
+            {
+                views[j] = views[j - 1];
+                j--;
+            }
+            views[j] = view;
+        }
+    }
+
+    MonsterView* source = views;
+    MonsterView* target = scratch;
+    for (int width = MONSTER_VIEW_SORT_RUN; width < count; width *= 2)
+    {
+        for (int left = 0; left < count; left += 2 * width)
+        {
+            const int middle = left + width < count ? left + width : count;
+            const int right = left + 2 * width < count ? left + 2 * width : count;
+            int a = left;
+            int b = middle;
+            for (int k = left; k < right; k++)
+            {
+                if (a < middle && (b >= right || source[a].distance <= source[b].distance))
+                    target[k] = source[a++];
+                else
+                    target[k] = source[b++];
+            }
+        }
+        MonsterView* swap = source;
+        source = target;
+        target = swap;
+    }
+
+    if (source != views)
+        memcpy(views, source, sizeof(MonsterView) * (size_t)count);
+}
+
+// Fills visibleMonsters with the monsters in vision range, nearest first, with their distance, bearing and angle
+// relative to the ship's heading computed once here rather than by every AI
+void BuildVisibleMonstersArray(const GameState* game, MonsterView* visibleMonsters, MonsterView* scratch, int* outCount)
+{
+    int visibleCount = 0;
+    
+    for (int i = 0; i < game->scenario.monsterCount; i++)
+    {
+        if (!IsMonsterDead(&game->monsters[i]))
+        {
+            const float dx = game->player.position.x - game->monsters[i].position.x;
+            const float dy = game->player.position.y - game->monsters[i].position.y;
+            const float distance = sqrtf(dx * dx + dy * dy);
+            
+            if (distance <= PLAYER_VISION_RADIUS)
+            {
+                visibleMonsters[visibleCount].position = game->monsters[i].position;
+                visibleMonsters[visibleCount].size = game->monsters[i].size;
+                visibleMonsters[visibleCount].health = game->monsters[i].health;
+                visibleMonsters[visibleCount].invincible = game->monsters[i].invincibilityTimer > 0.0f;
+                visibleMonsters[visibleCount].distance = distance;
+                visibleCount++;
+            }
+        }
+    }
+
+    OrientMonsterViews(visibleMonsters, scratch, visibleCount, game->player.position, game->player.rotation);
+    *outCount = visibleCount;
+}
+
+void OrientMonsterViews(MonsterView* views, MonsterView* scratch, const int count, const Vector2 playerPosition, const float playerRotation)
+{
+    for (int i = 0; i < count; i++)
+    {
+        MonsterView* view = &views[i];
+        float bearing = atan2f(view->position.y - playerPosition.y, view->position.x - playerPosition.x) * RAD2DEG;
+        if (bearing < 0.0f)
+            bearing += 360.0f;
+        if (bearing >= 360.0f)
+            bearing -= 360.0f;
+        view->bearing = bearing;
+        view->relativeAngle = WrapRelativeAngle(bearing - playerRotation);
+    }
+
+    SortMonsterViewsByDistance(views, scratch, count);
+}
+
+void ProcessPlayerAIAndShooting(GameState* game, const float deltaTime)
+{
+    PlayerControl control;
+    if (game->scriptedInput)
+    {
+        // Replays feed back the recorded commands: the AI and the world view built for it are skipped
+        BeginPlayerAI(&control, game, deltaTime, NULL, 0);
+        PlayerControlSetThrusters(&control, game->scriptedInput->leftThruster, game->scriptedInput->rightThruster);
+        if (game->scriptedInput->shoot)
+            PlayerControlShoot(&control, game->scriptedInput->shootDirection);
+    }
+    else
+    {
+        MonsterView* visibleMonsters = FRAME_ARENA_ALLOC_ARRAY(&game->frameArena, MonsterView, game->scenario.monsterCount);
+        MonsterView* sortScratch = FRAME_ARENA_ALLOC_ARRAY(&game->frameArena, MonsterView, game->scenario.monsterCount);
+        if (!visibleMonsters || !sortScratch)
+            return;
+        int visibleCount;
+        
+        BeginProfilerPhase(game->profiler, PROFILE_VISIBLE_MONSTERS);
+        BuildVisibleMonstersArray(game, visibleMonsters, sortScratch, &visibleCount);
+        EndProfilerPhase(game->profiler, PROFILE_VISIBLE_MONSTERS);
+        
+        BeginPlayerAI(&control, game, deltaTime, visibleMonsters, visibleCount);
+        
+        PlayerContext context;
+        context.playerPosition = game->player.position;
+        context.playerVelocity = game->player.velocity;
+        context.playerRotation = game->player.rotation;
+        context.visibleMonsters = visibleMonsters;
+        context.visibleMonsterCount = visibleCount;
+        context.deltaTime = deltaTime;
+        context.control = &control;
+        
+        BeginProfilerPhase(game->profiler, PROFILE_PLAYER_AI);
+        if (game->playerUpdate)
+            game->playerUpdate(context);
+        else
+            OnPlayerUpdate(context);
+        EndProfilerPhase(game->profiler, PROFILE_PLAYER_AI);
+    }
+
+    ShootDirection shootDir;
+    if (PlayerDidShoot(&control, &shootDir))
+    {
+        const float shootAngle = GetShootAngle(game->player.rotation, shootDir);
+        ShootProjectile(game, shootAngle, game->player.position, PROJECTILE_PLAYER, -1);
+        game->lastInput.shoot = true;
+        game->lastInput.shootDirection = shootDir;
+    }
+
+    EndPlayerAI(&control);
+}
+
+void FireMonsterShots(ProjectileStore* store, Monster* monster, const int monsterIndex, const Vector2 target)
+{
+    if (monster->shootTimer <= 0.0f)
+    {
+        const float dx = target.x - monster->position.x;
+        const float dy = target.y - monster->position.y;
+        const float angleToPlayer = atan2f(dy, dx) * RAD2DEG;
+        
+        FireProjectile(store, angleToPlayer, monster->position, PROJECTILE_MONSTER, monsterIndex);
+        monster->shootTimer = monster->shootCooldown;
+    }
+    
+    if (monster->spreadShotTimer <= 0.0f)
+    {
+        for (int i = 0; i < MONSTER_SPREAD_SHOT_COUNT; i++)
+        {
+            const float angle = (360.0f / MONSTER_SPREAD_SHOT_COUNT) * i;
+            FireProjectile(store, angle, monster->position, PROJECTILE_MONSTER_SPREAD, monsterIndex);
+        }
+        monster->spreadShotTimer = monster->spreadShotCooldown;
+    }
+}
+
+void ProcessMonsterShooting(GameState* game)
+{
+    for (int m = 0; m < game->scenario.monsterCount; m++)
+    {
+        if (!IsMonsterDead(&game->monsters[m]) && !IsPlayerDead(&game->player) && game->monsters[m].canShoot)
+        {
+            FireMonsterShots(&game->projectiles, &game->monsters[m], m, game->player.position);
+        }
+    }
+}
+
+void UpdateGameState(GameState* game, const float deltaTime)
+{
+    ResetFrameArena(&game->frameArena);
+    game->lastInput.shoot = false;
+
+    // Growing the projectile store here rather than while firing keeps reallocation out of the tick.
+    // Should it fail, AddProjectile tries again for each shot.
+    ReserveProjectiles(&game->projectiles, game->projectiles.count + GetMaxProjectileSpawnsPerTick(game));
+    const int projectilesBeforeFiring = game->projectiles.count;
+
+    const bool allMonstersDead = AreAllMonstersDead(game);
+    
+    if (!IsPlayerDead(&game->player) && !allMonstersDead)
+    {
+        game->gameTime += deltaTime;
+    }
+    
+    CountProfilerTick(game->profiler);
+
+    BeginProfilerPhase(game->profiler, PROFILE_UPDATE_MONSTERS);
+    UpdateAllMonsters(game, deltaTime);
+    EndProfilerPhase(game->profiler, PROFILE_UPDATE_MONSTERS);
+    
+    const bool wasPlayerAlive = !IsPlayerDead(&game->player);
+    BeginProfilerPhase(game->profiler, PROFILE_UPDATE_PLAYER);
+    UpdatePlayer(&game->player, deltaTime, (Vector2){ game->scenario.arenaWidth, game->scenario.arenaHeight });
+    EndProfilerPhase(game->profiler, PROFILE_UPDATE_PLAYER);
+    const bool isPlayerNowDead = IsPlayerDead(&game->player);
+    
+    if (wasPlayerAlive && isPlayerNowDead)
+    {
+        CreateDeathExplosion(game, game->player.position, BLUE, PLAYER_SIZE * 1.5f);
+    }
+    
+    if (!IsPlayerDead(&game->player) && !allMonstersDead)
+    {
+        BeginProfilerPhase(game->profiler, PROFILE_PROXIMITY_DAMAGE);
+        ApplyProximityDamageToPlayer(game, deltaTime);
+        EndProfilerPhase(game->profiler, PROFILE_PROXIMITY_DAMAGE);
+        ProcessPlayerAIAndShooting(game, deltaTime);
+    }
+    
+    BeginProfilerPhase(game->profiler, PROFILE_MONSTER_SHOOTING);
+    ProcessMonsterShooting(game);
+    EndProfilerPhase(game->profiler, PROFILE_MONSTER_SHOOTING);
+
+    BeginProfilerPhase(game->profiler, PROFILE_PROJECTILES);
+    game->newProjectileCount = game->projectiles.count - projectilesBeforeFiring;
+    UpdateProjectiles(game, deltaTime);
+    EndProfilerPhase(game->profiler, PROFILE_PROJECTILES);
+
+    BeginProfilerPhase(game->profiler, PROFILE_EFFECTS);
+    UpdateHitEffects(game, deltaTime);
+    UpdateDeathExplosions(game, deltaTime);
+    EndProfilerPhase(game->profiler, PROFILE_EFFECTS);
+
+    game->lastInput.leftThruster = game->player.leftThruster;
+    game->lastInput.rightThruster = game->player.rightThruster;
+}
+
+void CleanupGameState(GameState* game)
+{
+    if (game->monsters)
+    {
+        for (int i = 0; i < game->scenario.monsterCount; i++)
+        {
+            CleanupMonster(&game->monsters[i]);
+        }
+    }
+
+    FreeProjectileStore(&game->projectiles);
+    FreeCollisionGrid(&game->monsterGrid);
+    FreeEffectPool(&game->hitEffects);
+    FreeEffectPool(&game->deathExplosions);
+    FreeFrameArena(&game->frameArena);
+
+    free(game->worldBlock);
+    game->worldBlock = NULL;
+    LayoutWorldBlock(game, NULL);
+}
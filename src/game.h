@@ -0,0 +1,38 @@
+#ifndef GAME_H
+#define GAME_H
+
+#include "main.h"
+
+// Simulation entry points. Nothing in here touches the window, the GPU or
+// raylib's global state, so the same code runs in the headless build.
+// The seed alone decides the world: two calls with the same seed and scenario build identical worlds
+bool InitGameState(GameState* game, const Scenario* scenario, unsigned int seed);
+// Allocates everything InitGameState does but leaves the monsters and the player zeroed, for callers that place them
+bool AllocateGameState(GameState* game, const Scenario* scenario);
+// Seeds the generators and lays out the monsters, the player and the stars: InitGameState without the allocation.
+// Meant for a GameState fresh from AllocateGameState; projectiles and effects are left as they are.
+void GenerateWorld(GameState* game, unsigned int seed);
+void UpdateGameState(GameState* game, float deltaTime);
+void CleanupGameState(GameState* game);
+bool AreAllMonstersDead(GameState* game);
+
+bool RectanglesOverlap(Rectangle a, Rectangle b);
+
+// Individual steps of UpdateGameState, for benchmarks and tools that drive them one at a time
+bool IsPositionSafe(Vector2 pos, const Monster* monsters, int monsterCount, float minDistance);
+void UpdateAllMonsters(GameState* game, float deltaTime);
+void ApplyProximityDamageToPlayer(GameState* game, float deltaTime);
+void ApplyProximityDamage(Vector2 position, float* health, const Monster* monsters, int monsterCount, float damagePerSecond, float deltaTime);
+void BuildVisibleMonstersArray(const GameState* game, MonsterView* visibleMonsters, MonsterView* scratch, int* outCount);
+// Fills in the bearing and relative angle of views whose position, size, health and distance are set, then sorts
+// them nearest first. scratch holds count views.
+void OrientMonsterViews(MonsterView* views, MonsterView* scratch, int count, Vector2 playerPosition, float playerRotation);
+void ProcessPlayerAIAndShooting(GameState* game, float deltaTime);
+void ProcessMonsterShooting(GameState* game);
+// The shots of one living monster whose timers are up, aimed at target
+void FireMonsterShots(ProjectileStore* store, Monster* monster, int monsterIndex, Vector2 target);
+void UpdateProjectiles(GameState* game, float deltaTime);
+void CreateHitEffect(GameState* game, Vector2 position, Color color);
+Rectangle GetProjectileBounds(const GameState* game);
+
+#endif // GAME_H
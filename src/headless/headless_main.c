@@ -0,0 +1,287 @@
+#include "tournament.h"
+#include "../config.h"
+#include "../player_ai_library.h"
+#include "../game.h"
+#include "../replay.h"
+#ifdef USE_PYTHON_AI
+#include "../player_ai_backend/player_ai.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// Command-line front end for the headless simulation: plays a batch of games
+// with the linked player AI as fast as the CPU allows, spread over all cores,
+// and writes one CSV row per episode.
+
+#define HEADLESS_DEFAULT_DELTA_TIME SIMULATION_FIXED_DELTA_TIME
+#define HEADLESS_DEFAULT_MAX_GAME_TIME 300.0f
+#define HEADLESS_MAX_REPLAYS 256
+
+typedef struct HeadlessOptions
+{
+    TournamentConfig tournament;
+    const char* outputPath;
+    const char* scriptPath;
+    const char* aiLibraryPaths[PLAYER_AI_LIBRARY_MAX_LOADED];
+    int aiLibraryCount;
+    const char* recordDirectory;
+    const char* replayPaths[HEADLESS_MAX_REPLAYS];
+    int replayCount;
+} HeadlessOptions;
+
+void PrintUsage(const char* program)
+{
+    fprintf(stderr,
+        "Usage: %s [options]\n"
+        "  --seed <n>       Seed of the first episode (default: current time)\n"
+        "  --episodes <n>   Number of games to play (default: 1)\n"
+        "  --threads <n>    Worker threads (default: one per online CPU)\n"
+        "  --dt <seconds>   Simulation step (default: %.4f)\n"
+        "  --max-time <s>   Stop a game after this much game time (default: %.0f)\n"
+        "  --scenario <f>   Load world size, monster count and damage values from a scenario file\n"
+        "  --out <path>     Write the per-episode CSV there instead of stdout\n"
+        "  --ai <library>   Play with an AI library instead of the linked AI; repeat to have several\n"
+        "                   libraries play the same seeds (up to %d)\n"
+        "  --record <dir>   Save a replay of every episode in dir (seed-<seed>.replay, prefixed with\n"
+        "                   the library number when there are several)\n"
+        "  --replay <file>  Re-simulate a replay instead of playing episodes, as fast as possible;\n"
+        "                   repeat to play several (up to %d)\n"
+#ifdef USE_PYTHON_AI
+        "  --script <path>  Python AI script (default: player_ai.py)\n"
+#endif
+        ,
+        program, HEADLESS_DEFAULT_DELTA_TIME, HEADLESS_DEFAULT_MAX_GAME_TIME, PLAYER_AI_LIBRARY_MAX_LOADED, HEADLESS_MAX_REPLAYS);
+}
+
+int GetOnlineProcessorCount(void)
+{
+    const long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+}
+
+bool ParseOptions(int argc, char** argv, HeadlessOptions* options)
+{
+    options->tournament.episodeCount = 1;
+    options->tournament.threadCount = GetOnlineProcessorCount();
+    options->tournament.baseSeed = (unsigned int)time(NULL);
+    options->tournament.deltaTime = HEADLESS_DEFAULT_DELTA_TIME;
+    options->tournament.maxGameTime = HEADLESS_DEFAULT_MAX_GAME_TIME;
+    InitDefaultScenario(&options->tournament.scenario);
+    options->tournament.playerUpdate = NULL;
+    options->tournament.playerAI = NULL;
+    options->outputPath = NULL;
+    options->scriptPath = "player_ai.py";
+    options->aiLibraryCount = 0;
+    options->tournament.replayPrefix = NULL;
+    options->recordDirectory = NULL;
+    options->replayCount = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--seed") == 0 && hasValue)
+            options->tournament.baseSeed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--episodes") == 0 && hasValue)
+            options->tournament.episodeCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && hasValue)
+            options->tournament.threadCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--dt") == 0 && hasValue)
+            options->tournament.deltaTime = strtof(argv[++i], NULL);
+        else if (strcmp(argv[i], "--max-time") == 0 && hasValue)
+            options->tournament.maxGameTime = strtof(argv[++i], NULL);
+        else if (strcmp(argv[i], "--scenario") == 0 && hasValue)
+        {
+            if (!LoadScenarioFile(&options->tournament.scenario, argv[++i]))
+                return false;
+        }
+        else if (strcmp(argv[i], "--out") == 0 && hasValue)
+            options->outputPath = argv[++i];
+        else if (strcmp(argv[i], "--ai") == 0 && hasValue && options->aiLibraryCount < PLAYER_AI_LIBRARY_MAX_LOADED)
+            options->aiLibraryPaths[options->aiLibraryCount++] = argv[++i];
+        else if (strcmp(argv[i], "--record") == 0 && hasValue)
+            options->recordDirectory = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && hasValue && options->replayCount < HEADLESS_MAX_REPLAYS)
+            options->replayPaths[options->replayCount++] = argv[++i];
+#ifdef USE_PYTHON_AI
+        else if (strcmp(argv[i], "--script") == 0 && hasValue)
+            options->scriptPath = argv[++i];
+#endif
+        else
+            return false;
+    }
+
+    return options->tournament.episodeCount > 0 &&
+           options->tournament.deltaTime > 0.0f &&
+           options->tournament.maxGameTime > 0.0f;
+}
+
+double GetWallTime(void)
+{
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+// Re-simulates each replay from its seed and recorded commands, without the AI, and writes one CSV row per replay.
+// Replays that fail to load or stop matching their keyframes make the run fail.
+bool PlayReplays(const HeadlessOptions* options, FILE* output)
+{
+    static GameState game;
+    bool allMatched = true;
+    long totalTicks = 0;
+    double totalSeconds = 0.0;
+
+    fprintf(output, "replay,seed,ticks,outcome,score,gameTime,playerHealth,divergedTick,seconds,ticksPerSecond\n");
+    for (int i = 0; i < options->replayCount; i++)
+    {
+        const char* path = options->replayPaths[i];
+        Replay replay;
+        ReplayPlayer player;
+        if (!LoadReplay(&replay, path))
+        {
+            allMatched = false;
+            continue;
+        }
+        if (!StartReplayPlayback(&player, &replay, &game))
+        {
+            fprintf(stderr, "Error: failed to allocate the world of %s\n", path);
+            FreeReplay(&replay);
+            allMatched = false;
+            continue;
+        }
+
+        const double startTime = GetWallTime();
+        while (StepReplay(&player, &game))
+        {
+        }
+        const double seconds = GetWallTime() - startTime;
+
+        const char* outcome = AreAllMonstersDead(&game) ? "victory" : IsPlayerDead(&game.player) ? "defeat" : "timeout";
+        fprintf(output, "%s,%u,%ld,%s,%d,%.4f,%.4f,%ld,%.6f,%.0f\n",
+            path, replay.seed, player.tick, outcome, game.score, game.gameTime, game.player.health,
+            player.divergedTick, seconds, seconds > 0.0 ? (double)player.tick / seconds : 0.0);
+        if (player.divergedTick >= 0)
+        {
+            fprintf(stderr, "Warning: %s diverged from its recording at tick %ld\n", path, player.divergedTick);
+            allMatched = false;
+        }
+
+        totalTicks += player.tick;
+        totalSeconds += seconds;
+        CleanupGameState(&game);
+        FreeReplay(&replay);
+    }
+
+    fprintf(stderr, "%d replays in %.3f s (%.0f ticks/s)\n", options->replayCount, totalSeconds,
+        totalSeconds > 0.0 ? (double)totalTicks / totalSeconds : 0.0);
+    return allMatched;
+}
+
+FILE* OpenOutput(const char* path)
+{
+    if (!path)
+        return stdout;
+    FILE* output = fopen(path, "w");
+    if (!output)
+        fprintf(stderr, "Error: cannot open %s for writing\n", path);
+    return output;
+}
+
+int main(int argc, char** argv)
+{
+    HeadlessOptions options;
+    if (!ParseOptions(argc, argv, &options))
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    if (options.replayCount > 0)
+    {
+        FILE* output = OpenOutput(options.outputPath);
+        if (!output)
+            return 1;
+        const bool matched = PlayReplays(&options, output);
+        if (output != stdout)
+            fclose(output);
+        return matched ? 0 : 1;
+    }
+
+#ifdef USE_PYTHON_AI
+    // Workers share one interpreter; only one of them runs Python at a time
+    if (!InitPythonAI(options.scriptPath))
+        return 1;
+#endif
+
+    static PlayerAILibrary libraries[PLAYER_AI_LIBRARY_MAX_LOADED];
+    for (int i = 0; i < options.aiLibraryCount; i++)
+    {
+        if (!LoadPlayerAILibrary(&libraries[i], options.aiLibraryPaths[i]))
+            return 1;
+    }
+
+    // Each AI library plays the same seeds, one after the other
+    const int runCount = options.aiLibraryCount > 0 ? options.aiLibraryCount : 1;
+    const int episodeCount = options.tournament.episodeCount;
+    const int resultCount = episodeCount * runCount;
+    EpisodeResult* results = (EpisodeResult*)calloc((size_t)resultCount, sizeof(EpisodeResult));
+    if (!results)
+        return 1;
+
+    const double startTime = GetWallTime();
+    bool completed = true;
+    char replayPrefix[1024];
+    for (int run = 0; run < runCount; run++)
+    {
+        if (options.aiLibraryCount > 0)
+        {
+            options.tournament.playerUpdate = libraries[run].update;
+            options.tournament.playerAI = libraries[run].path;
+        }
+        if (options.recordDirectory)
+        {
+            if (runCount > 1)
+                snprintf(replayPrefix, sizeof(replayPrefix), "%s/%d-", options.recordDirectory, run + 1);
+            else
+                snprintf(replayPrefix, sizeof(replayPrefix), "%s/", options.recordDirectory);
+            options.tournament.replayPrefix = replayPrefix;
+        }
+        completed = RunTournament(&options.tournament, results + (size_t)run * episodeCount) && completed;
+    }
+    const double elapsed = GetWallTime() - startTime;
+
+    FILE* output = OpenOutput(options.outputPath);
+    if (!output)
+    {
+        free(results);
+        return 1;
+    }
+
+    WriteEpisodeResultsCSV(output, results, resultCount);
+    if (output != stdout)
+        fclose(output);
+
+    long totalTicks = 0;
+    for (int i = 0; i < resultCount; i++)
+    {
+        totalTicks += results[i].ticks;
+    }
+
+    fprintf(stderr, "%d episodes on %d threads in %.3f s (%.1f episodes/s, %.0f ticks/s)\n",
+        resultCount, options.tournament.threadCount, elapsed,
+        elapsed > 0.0 ? resultCount / elapsed : 0.0,
+        elapsed > 0.0 ? (double)totalTicks / elapsed : 0.0);
+
+    free(results);
+    for (int i = 0; i < options.aiLibraryCount; i++)
+    {
+        UnloadPlayerAILibrary(&libraries[i]);
+    }
+#ifdef USE_PYTHON_AI
+    CleanupPythonAI();
+#endif
+    return completed ? 0 : 1;
+}
@@ -0,0 +1,65 @@
+#ifndef HEADLESS_RAYLIB_H
+#define HEADLESS_RAYLIB_H
+
+// Stand-in for raylib.h used by the headless build. The simulation only needs
+// raylib's plain value types and a few macros, so this header provides them
+// with the same layout and lets the game code build without a window, a GL
+// context or the raylib library itself. Anything that draws is compiled out
+// with HEADLESS.
+
+#include <stdbool.h>
+
+#ifndef PI
+    #define PI 3.14159265358979323846f
+#endif
+#ifndef DEG2RAD
+    #define DEG2RAD (PI/180.0f)
+#endif
+#ifndef RAD2DEG
+    #define RAD2DEG (180.0f/PI)
+#endif
+
+#define CLITERAL(type) (type)
+
+typedef struct Vector2
+{
+    float x;
+    float y;
+} Vector2;
+
+typedef struct Color
+{
+    unsigned char r;
+    unsigned char g;
+    unsigned char b;
+    unsigned char a;
+} Color;
+
+typedef struct Rectangle
+{
+    float x;
+    float y;
+    float width;
+    float height;
+} Rectangle;
+
+typedef struct Texture
+{
+    unsigned int id;
+    int width;
+    int height;
+    int mipmaps;
+    int format;
+} Texture;
+
+typedef Texture Texture2D;
+
+#define YELLOW     CLITERAL(Color){ 253, 249, 0, 255 }
+#define ORANGE     CLITERAL(Color){ 255, 161, 0, 255 }
+#define RED        CLITERAL(Color){ 230, 41, 55, 255 }
+#define GREEN      CLITERAL(Color){ 0, 228, 48, 255 }
+#define BLUE       CLITERAL(Color){ 0, 121, 241, 255 }
+#define PURPLE     CLITERAL(Color){ 200, 122, 255, 255 }
+#define WHITE      CLITERAL(Color){ 255, 255, 255, 255 }
+
+#endif // HEADLESS_RAYLIB_H
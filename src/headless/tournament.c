@@ -0,0 +1,166 @@
+#include "tournament.h"
+#include "../game.h"
+#include "../player.h"
+#include "../replay.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+typedef struct TournamentWorker
+{
+    pthread_t thread;
+    const TournamentConfig* config;
+    EpisodeResult* results;
+    atomic_int* nextEpisode;
+    atomic_int* failedEpisodes;
+} TournamentWorker;
+
+bool PlayEpisode(GameState* game, const TournamentConfig* config, const int episode, EpisodeResult* result)
+{
+    const unsigned int seed = config->baseSeed + (unsigned int)episode;
+    if (!InitGameState(game, &config->scenario, seed))
+        return false;
+    game->playerUpdate = config->playerUpdate;
+
+    char replayPath[1024];
+    ReplayRecorder recorder = { 0 };
+    if (config->replayPrefix)
+    {
+        snprintf(replayPath, sizeof(replayPath), "%sseed-%u.replay", config->replayPrefix, seed);
+        if (!BeginReplayRecording(&recorder, replayPath, seed, game, REPLAY_DEFAULT_KEYFRAME_INTERVAL))
+            fprintf(stderr, "Warning: cannot record episode %d to %s\n", episode, replayPath);
+    }
+
+    const long maxTicks = (long)(config->maxGameTime / config->deltaTime);
+    long ticks = 0;
+
+    while (ticks < maxTicks && !IsPlayerDead(&game->player) && !AreAllMonstersDead(game))
+    {
+        UpdateGameState(game, config->deltaTime);
+        RecordReplayTick(&recorder, game, config->deltaTime);
+        ticks++;
+    }
+
+    if (recorder.file && !EndReplayRecording(&recorder))
+        fprintf(stderr, "Warning: failed to write %s\n", replayPath);
+
+    result->episode = episode;
+    result->seed = seed;
+    result->outcome = EPISODE_TIMEOUT;
+    if (AreAllMonstersDead(game))
+        result->outcome = EPISODE_VICTORY;
+    else if (IsPlayerDead(&game->player))
+        result->outcome = EPISODE_DEFEAT;
+    result->score = game->score;
+    result->gameTime = game->gameTime;
+    result->ticks = ticks;
+    result->playerHealth = game->player.health;
+    result->playerAI = config->playerAI;
+
+    CleanupGameState(game);
+    return true;
+}
+
+void* TournamentWorkerMain(void* argument)
+{
+    TournamentWorker* worker = (TournamentWorker*)argument;
+
+    GameState* game = (GameState*)malloc(sizeof(GameState));
+    if (!game)
+        return NULL;
+
+    for (;;)
+    {
+        const int episode = atomic_fetch_add(worker->nextEpisode, 1);
+        if (episode >= worker->config->episodeCount)
+            break;
+
+        if (!PlayEpisode(game, worker->config, episode, &worker->results[episode]))
+            atomic_fetch_add(worker->failedEpisodes, 1);
+    }
+
+    free(game);
+    return NULL;
+}
+
+bool RunTournament(const TournamentConfig* config, EpisodeResult* results)
+{
+    int threadCount = config->threadCount;
+    if (threadCount < 1)
+        threadCount = 1;
+    if (threadCount > config->episodeCount)
+        threadCount = config->episodeCount;
+
+    TournamentWorker* workers = (TournamentWorker*)malloc(sizeof(TournamentWorker) * threadCount);
+    if (!workers)
+        return false;
+
+    // Overwritten by every episode that gets played
+    for (int episode = 0; episode < config->episodeCount; episode++)
+    {
+        results[episode] = (EpisodeResult){ 0 };
+        results[episode].episode = episode;
+        results[episode].seed = config->baseSeed + (unsigned int)episode;
+        results[episode].outcome = EPISODE_FAILED;
+        results[episode].playerAI = config->playerAI;
+    }
+
+    atomic_int nextEpisode;
+    atomic_init(&nextEpisode, 0);
+    atomic_int failedEpisodes;
+    atomic_init(&failedEpisodes, 0);
+
+    int startedCount = 0;
+    for (int i = 0; i < threadCount; i++)
+    {
+        workers[i].config = config;
+        workers[i].results = results;
+        workers[i].nextEpisode = &nextEpisode;
+        workers[i].failedEpisodes = &failedEpisodes;
+        if (pthread_create(&workers[i].thread, NULL, TournamentWorkerMain, &workers[i]) != 0)
+            break;
+        startedCount++;
+    }
+
+    // If no thread could be started, play everything on the calling thread
+    if (startedCount == 0)
+        TournamentWorkerMain(&workers[0]);
+
+    for (int i = 0; i < startedCount; i++)
+    {
+        pthread_join(workers[i].thread, NULL);
+    }
+
+    free(workers);
+    return atomic_load(&nextEpisode) >= config->episodeCount && atomic_load(&failedEpisodes) == 0;
+}
+
+const char* GetEpisodeOutcomeName(const EpisodeOutcome outcome)
+{
+    switch (outcome)
+    {
+        case EPISODE_VICTORY: return "victory";
+        case EPISODE_DEFEAT: return "defeat";
+        case EPISODE_FAILED: return "failed";
+        default: return "timeout";
+    }
+}
+
+void WriteEpisodeResultsCSV(FILE* file, const EpisodeResult* results, const int count)
+{
+    const bool hasPlayerAI = count > 0 && results[0].playerAI;
+    fprintf(file, "episode,seed,outcome,score,gameTime,ticks,playerHealth%s\n", hasPlayerAI ? ",ai" : "");
+    for (int i = 0; i < count; i++)
+    {
+        const EpisodeResult* result = &results[i];
+        if (result->outcome == EPISODE_FAILED)
+            fprintf(file, "%d,%u,%s,,,,", result->episode, result->seed, GetEpisodeOutcomeName(result->outcome));
+        else
+            fprintf(file, "%d,%u,%s,%d,%.4f,%ld,%.4f",
+                result->episode, result->seed, GetEpisodeOutcomeName(result->outcome),
+                result->score, result->gameTime, result->ticks, result->playerHealth);
+        if (hasPlayerAI)
+            fprintf(file, ",%s", result->playerAI ? result->playerAI : "");
+        fputc('\n', file);
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include <stdbool.h>
+#include <stdio.h>
+#include "../scenario.h"
+#include "../player.h"
+
+typedef enum EpisodeOutcome
+{
+    EPISODE_TIMEOUT,
+    EPISODE_VICTORY,
+    EPISODE_DEFEAT,
+    EPISODE_FAILED      // The episode could not be set up; only its episode and seed are meaningful
+} EpisodeOutcome;
+
+typedef struct EpisodeResult
+{
+    int episode;
+    unsigned int seed;
+    EpisodeOutcome outcome;
+    int score;
+    float gameTime;
+    long ticks;
+    float playerHealth;
+    const char* playerAI;   // Name of the AI library that played, or NULL for the linked AI
+} EpisodeResult;
+
+typedef struct TournamentConfig
+{
+    int episodeCount;
+    int threadCount;
+    unsigned int baseSeed;  // Episode i is played with seed baseSeed + i
+    float deltaTime;
+    float maxGameTime;
+    Scenario scenario;
+    PlayerUpdateFunction playerUpdate;  // NULL plays the linked OnPlayerUpdate
+    const char* playerAI;               // Copied into each EpisodeResult
+    const char* replayPrefix;           // When set, episodes are recorded to <replayPrefix>seed-<seed>.replay
+} TournamentConfig;
+
+// Plays every episode on a pool of worker threads, each owning its own GameState.
+// results must hold config->episodeCount entries and is indexed by episode; episodes that could not be played are
+// left as EPISODE_FAILED.
+bool RunTournament(const TournamentConfig* config, EpisodeResult* results);
+
+const char* GetEpisodeOutcomeName(EpisodeOutcome outcome);
+// Adds an ai column when the results come from AI libraries. Failed episodes leave the measurements empty.
+void WriteEpisodeResultsCSV(FILE* file, const EpisodeResult* results, int count);
+
+#endif // TOURNAMENT_H
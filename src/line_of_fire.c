@@ -0,0 +1,187 @@
+#include "line_of_fire.h"
+#include "config.h"
+#include <float.h>
+#include <math.h>
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define LINE_OF_FIRE_SIMD_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define LINE_OF_FIRE_SIMD_SSE
+#elif defined(__wasm_simd128__)
+    #include <wasm_simd128.h>
+    #define LINE_OF_FIRE_SIMD_WASM
+#endif
+
+// Keeps the slab test free of infinities (and of the NaN that 0 * inf gives) for axis-aligned rays
+#define LINE_OF_FIRE_MIN_DIRECTION 1e-12f
+
+bool InitLineOfFireTargets(LineOfFireTargets* targets, FrameArena* arena, const int capacity)
+{
+    targets->count = 0;
+    targets->minX = FRAME_ARENA_ALLOC_ARRAY(arena, float, capacity);
+    targets->minY = FRAME_ARENA_ALLOC_ARRAY(arena, float, capacity);
+    targets->maxX = FRAME_ARENA_ALLOC_ARRAY(arena, float, capacity);
+    targets->maxY = FRAME_ARENA_ALLOC_ARRAY(arena, float, capacity);
+    targets->ids = FRAME_ARENA_ALLOC_ARRAY(arena, int, capacity);
+    return targets->minX && targets->minY && targets->maxX && targets->maxY && targets->ids;
+}
+
+void AddLineOfFireTarget(LineOfFireTargets* targets, const Rectangle hitbox, const int id)
+{
+    const float padding = PROJECTILE_SIZE / 2;
+    const int i = targets->count++;
+    targets->minX[i] = hitbox.x - padding;
+    targets->minY[i] = hitbox.y - padding;
+    targets->maxX[i] = hitbox.x + hitbox.width + padding;
+    targets->maxY[i] = hitbox.y + hitbox.height + padding;
+    targets->ids[i] = id;
+}
+
+static float SafeInverse(const float value)
+{
+    if (fabsf(value) < LINE_OF_FIRE_MIN_DIRECTION)
+        return value < 0.0f ? -1.0f / LINE_OF_FIRE_MIN_DIRECTION : 1.0f / LINE_OF_FIRE_MIN_DIRECTION;
+    return 1.0f / value;
+}
+
+int CastLineOfFire(const LineOfFireTargets* targets, const Vector2 origin, const Vector2 direction, float* outDistance)
+{
+    const float inverseX = SafeInverse(direction.x);
+    const float inverseY = SafeInverse(direction.y);
+    const float* minX = targets->minX;
+    const float* minY = targets->minY;
+    const float* maxX = targets->maxX;
+    const float* maxY = targets->maxY;
+    const int count = targets->count;
+
+    // Slab test: the ray is inside the box between the latest entry and the earliest exit over both axes.
+    // Every lane keeps the nearest box it has seen, lanes are merged at the end.
+    float bestDistance = FLT_MAX;
+    int best = -1;
+    int i = 0;
+
+#if defined(LINE_OF_FIRE_SIMD_AVX)
+    const __m256 ox = _mm256_set1_ps(origin.x);
+    const __m256 oy = _mm256_set1_ps(origin.y);
+    const __m256 ix = _mm256_set1_ps(inverseX);
+    const __m256 iy = _mm256_set1_ps(inverseY);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 step = _mm256_set1_ps(8.0f);
+    __m256 laneIndex = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+    __m256 laneBestDistance = _mm256_set1_ps(FLT_MAX);
+    __m256 laneBest = _mm256_set1_ps(-1.0f);
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256 x1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(minX + i), ox), ix);
+        const __m256 x2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(maxX + i), ox), ix);
+        const __m256 y1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(minY + i), oy), iy);
+        const __m256 y2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(maxY + i), oy), iy);
+        const __m256 entry = _mm256_max_ps(_mm256_max_ps(_mm256_min_ps(x1, x2), _mm256_min_ps(y1, y2)), zero);
+        const __m256 exitDistance = _mm256_min_ps(_mm256_max_ps(x1, x2), _mm256_max_ps(y1, y2));
+        const __m256 better = _mm256_and_ps(_mm256_cmp_ps(entry, exitDistance, _CMP_LE_OQ), _mm256_cmp_ps(entry, laneBestDistance, _CMP_LT_OQ));
+        laneBestDistance = _mm256_blendv_ps(laneBestDistance, entry, better);
+        laneBest = _mm256_blendv_ps(laneBest, laneIndex, better);
+        laneIndex = _mm256_add_ps(laneIndex, step);
+    }
+    float distances[8];
+    float indices[8];
+    _mm256_storeu_ps(distances, laneBestDistance);
+    _mm256_storeu_ps(indices, laneBest);
+    const int laneCount = 8;
+#elif defined(LINE_OF_FIRE_SIMD_SSE)
+    const __m128 ox = _mm_set1_ps(origin.x);
+    const __m128 oy = _mm_set1_ps(origin.y);
+    const __m128 ix = _mm_set1_ps(inverseX);
+    const __m128 iy = _mm_set1_ps(inverseY);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 step = _mm_set1_ps(4.0f);
+    __m128 laneIndex = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    __m128 laneBestDistance = _mm_set1_ps(FLT_MAX);
+    __m128 laneBest = _mm_set1_ps(-1.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 x1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(minX + i), ox), ix);
+        const __m128 x2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(maxX + i), ox), ix);
+        const __m128 y1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(minY + i), oy), iy);
+        const __m128 y2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(maxY + i), oy), iy);
+        const __m128 entry = _mm_max_ps(_mm_max_ps(_mm_min_ps(x1, x2), _mm_min_ps(y1, y2)), zero);
+        const __m128 exitDistance = _mm_min_ps(_mm_max_ps(x1, x2), _mm_max_ps(y1, y2));
+        const __m128 better = _mm_and_ps(_mm_cmple_ps(entry, exitDistance), _mm_cmplt_ps(entry, laneBestDistance));
+        laneBestDistance = _mm_or_ps(_mm_and_ps(better, entry), _mm_andnot_ps(better, laneBestDistance));
+        laneBest = _mm_or_ps(_mm_and_ps(better, laneIndex), _mm_andnot_ps(better, laneBest));
+        laneIndex = _mm_add_ps(laneIndex, step);
+    }
+    float distances[4];
+    float indices[4];
+    _mm_storeu_ps(distances, laneBestDistance);
+    _mm_storeu_ps(indices, laneBest);
+    const int laneCount = 4;
+#elif defined(LINE_OF_FIRE_SIMD_WASM)
+    const v128_t ox = wasm_f32x4_splat(origin.x);
+    const v128_t oy = wasm_f32x4_splat(origin.y);
+    const v128_t ix = wasm_f32x4_splat(inverseX);
+    const v128_t iy = wasm_f32x4_splat(inverseY);
+    const v128_t zero = wasm_f32x4_splat(0.0f);
+    const v128_t step = wasm_f32x4_splat(4.0f);
+    v128_t laneIndex = wasm_f32x4_make(0.0f, 1.0f, 2.0f, 3.0f);
+    v128_t laneBestDistance = wasm_f32x4_splat(FLT_MAX);
+    v128_t laneBest = wasm_f32x4_splat(-1.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        const v128_t x1 = wasm_f32x4_mul(wasm_f32x4_sub(wasm_v128_load(minX + i), ox), ix);
+        const v128_t x2 = wasm_f32x4_mul(wasm_f32x4_sub(wasm_v128_load(maxX + i), ox), ix);
+        const v128_t y1 = wasm_f32x4_mul(wasm_f32x4_sub(wasm_v128_load(minY + i), oy), iy);
+        const v128_t y2 = wasm_f32x4_mul(wasm_f32x4_sub(wasm_v128_load(maxY + i), oy), iy);
+        const v128_t entry = wasm_f32x4_pmax(wasm_f32x4_pmax(wasm_f32x4_pmin(x1, x2), wasm_f32x4_pmin(y1, y2)), zero);
+        const v128_t exitDistance = wasm_f32x4_pmin(wasm_f32x4_pmax(x1, x2), wasm_f32x4_pmax(y1, y2));
+        const v128_t better = wasm_v128_and(wasm_f32x4_le(entry, exitDistance), wasm_f32x4_lt(entry, laneBestDistance));
+        laneBestDistance = wasm_v128_bitselect(entry, laneBestDistance, better);
+        laneBest = wasm_v128_bitselect(laneIndex, laneBest, better);
+        laneIndex = wasm_f32x4_add(laneIndex, step);
+    }
+    float distances[4];
+    float indices[4];
+    wasm_v128_store(distances, laneBestDistance);
+    wasm_v128_store(indices, laneBest);
+    const int laneCount = 4;
+#else
+    float distances[1] = { FLT_MAX };
+    float indices[1] = { -1.0f };
+    const int laneCount = 1;
+#endif
+
+    // Ties go to the lower index, which is what the scalar loop alone would pick
+    for (int lane = 0; lane < laneCount; lane++)
+    {
+        const int index = (int)indices[lane];
+        if (index >= 0 && (distances[lane] < bestDistance || (distances[lane] == bestDistance && index < best)))
+        {
+            bestDistance = distances[lane];
+            best = index;
+        }
+    }
+
+    for (; i < count; i++)
+    {
+        const float x1 = (minX[i] - origin.x) * inverseX;
+        const float x2 = (maxX[i] - origin.x) * inverseX;
+        const float y1 = (minY[i] - origin.y) * inverseY;
+        const float y2 = (maxY[i] - origin.y) * inverseY;
+        const float entry = fmaxf(fmaxf(fminf(x1, x2), fminf(y1, y2)), 0.0f);
+        const float exitDistance = fminf(fmaxf(x1, x2), fmaxf(y1, y2));
+        if (entry <= exitDistance && entry < bestDistance)
+        {
+            bestDistance = entry;
+            best = i;
+        }
+    }
+
+    if (best < 0)
+        return -1;
+
+    if (outDistance)
+        *outDistance = bestDistance;
+    return targets->ids[best];
+}
@@ -0,0 +1,28 @@
+#ifndef LINE_OF_FIRE_H
+#define LINE_OF_FIRE_H
+
+#include "raylib.h"
+#include "frame_arena.h"
+
+// Hitboxes a projectile can hit, stored as lanes for the ray kernel. Each box is the monster's hitbox grown by
+// half a projectile, so a ray traced by the projectile's center enters it exactly when the projectile starts to
+// overlap the monster. Invincible monsters are left out: projectiles pass through them.
+typedef struct LineOfFireTargets
+{
+    float* minX;
+    float* minY;
+    float* maxX;
+    float* maxY;
+    int* ids;       // Value reported for each box, e.g. its index in the visible monster list
+    int count;
+} LineOfFireTargets;
+
+// Lanes come from the arena; count is the number of boxes that will be added
+bool InitLineOfFireTargets(LineOfFireTargets* targets, FrameArena* arena, int capacity);
+void AddLineOfFireTarget(LineOfFireTargets* targets, Rectangle hitbox, int id);
+
+// Traces a ray from origin along direction (a unit vector) and returns the id of the first box it enters, or -1.
+// *outDistance receives the distance travelled to that box (0 when origin is already inside it).
+int CastLineOfFire(const LineOfFireTargets* targets, Vector2 origin, Vector2 direction, float* outDistance);
+
+#endif // LINE_OF_FIRE_H
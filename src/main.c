@@ -1,600 +1,330 @@
 #include "raylib.h"
 #include "main.h"
+#include "game.h"
 #include "monster.h"
 #include "player.h"
 #include "config.h"
 #include "ui.h"
+#include "scenario.h"
+#include "particle_renderer.h"
+#include "star_field.h"
+#include "sprite_batch.h"
+#include "player_ai_library.h"
+#include "replay.h"
 #include <math.h>
 #include <stdlib.h>
 #include <time.h>
 #include <stdio.h>
+#include <string.h>
 
-bool IsPositionSafe(const Vector2 pos, const Monster* monsters, const int monsterCount, const float minDistance)
+float InterpolateWrapped(const float previous, const float current, const float alpha, const float span)
 {
-    for (int i = 0; i < monsterCount; i++) 
-    {
-        const float dx = pos.x - monsters[i].position.x;
-        const float dy = pos.y - monsters[i].position.y;
-        const float dist = sqrtf(dx * dx + dy * dy);
-        if (dist < minDistance + monsters[i].size)
-            return false;
-    }
-
-    return true;
+    // A jump of more than half the arena means the player wrapped around the edge this tick
+    if (fabsf(current - previous) > span / 2.0f)
+        return current;
+    return previous + (current - previous) * alpha;
 }
 
-void LoadSharedTextures(GameState* game)
+Player InterpolatePlayer(const Player* player, const float alpha, const Scenario* scenario)
 {
-    game->sharedMonsterTexture = LoadTexture("resources/boss.png");
+    Player interpolated = *player;
+    interpolated.position.x = InterpolateWrapped(player->previousPosition.x, player->position.x, alpha, scenario->arenaWidth);
+    interpolated.position.y = InterpolateWrapped(player->previousPosition.y, player->position.y, alpha, scenario->arenaHeight);
+    interpolated.rotation = player->previousRotation + (player->rotation - player->previousRotation) * alpha;
+    return interpolated;
 }
 
-void InitializeMonsters(GameState* game)
+// GPU resources built once at startup and used every frame
+typedef struct RenderResources
 {
-    for (int i = 0; i < MONSTER_COUNT; i++)
-    {
-        const float size = MONSTER_MIN_SIZE + (rand() / (float)RAND_MAX) * (MONSTER_MAX_SIZE - MONSTER_MIN_SIZE);
-        
-        Vector2 monsterPos;
-        int attempts = 0;
-        do
-        {
-            monsterPos.x = size + (rand() / (float)RAND_MAX) * (SCREEN_WIDTH - 2 * size);
-            monsterPos.y = size + (rand() / (float)RAND_MAX) * (SCREEN_HEIGHT - 2 * size);
-            attempts++;
-        } while (attempts < 100 && !IsPositionSafe(monsterPos, game->monsters, i, size * 2));
-        
-        InitMonster(&game->monsters[i], monsterPos, size);
-        game->monsters[i].texture = game->sharedMonsterTexture;
-    }
-}
+    StarField stars;
+    SpriteAtlas atlas;
+    SpriteBatch sprites;
+    ParticleRenderer particles;
+} RenderResources;
 
-void InitializePlayerAtSafePosition(GameState* game)
+void LoadRenderResources(RenderResources* resources, GameState* game)
 {
-    Vector2 playerPos;
-    int attempts = 0;
-    do
-    {
-        playerPos.x = PLAYER_SIZE + (rand() / (float)RAND_MAX) * (SCREEN_WIDTH - 2 * PLAYER_SIZE);
-        playerPos.y = PLAYER_SIZE + (rand() / (float)RAND_MAX) * (SCREEN_HEIGHT - 2 * PLAYER_SIZE);
-        attempts++;
-    } while (attempts < 100 && !IsPositionSafe(playerPos, game->monsters, MONSTER_COUNT, PLAYER_SIZE * 3));
-    
-    InitPlayer(&game->player, playerPos, PLAYER_SIZE);
-}
+    LoadStarField(&resources->stars, game);
+    LoadParticleRenderer(&resources->particles);
 
-void InitializeProjectileArray(GameState* game)
-{
-    game->projectileCapacity = 10;
-    game->projectiles = (Projectile*)malloc(sizeof(Projectile) * game->projectileCapacity);
-    game->projectileCount = 0;
-}
+    // Entities missing their image fall back to flat rectangles, still drawn from the atlas
+    if (!LoadSpriteAtlas(&resources->atlas, "resources/player.png", "resources/boss.png"))
+        fprintf(stderr, "Warning: Failed to build the sprite atlas\n");
+    InitSpriteBatch(&resources->sprites, &resources->atlas, game->scenario.monsterCount + PROJECTILE_INITIAL_CAPACITY + 1);
 
-void InitGameState(GameState* game) 
-{
-    LoadSharedTextures(game);
-    InitializeMonsters(game);
-    InitializePlayerAtSafePosition(game);
-    InitializeProjectileArray(game);
-    
-    for (int i = 0; i < STAR_COUNT; i++)
-    {
-        game->stars[i].position = (Vector2){
-            (float)GetRandomValue(0, SCREEN_WIDTH),
-            (float)GetRandomValue(0, SCREEN_HEIGHT)
-        };
-        game->stars[i].size = GetRandomValue(STAR_MIN_SIZE, STAR_MAX_SIZE);
-        game->stars[i].phase = (float)GetRandomValue(0, 628) / 100.0f;
-    }
-    
-    for (int i = 0; i < HIT_EFFECT_MAX_COUNT; i++)
-    {
-        game->hitEffects[i].active = false;
-    }
-    
-    for (int i = 0; i < MONSTER_COUNT + 1; i++)
+    for (int i = 0; i < game->scenario.monsterCount; i++)
     {
-        game->deathExplosions[i].active = false;
+        game->monsters[i].sprite = resources->atlas.monster;
     }
-    
-    game->score = 0;
-    game->gameTime = 0.0f;
+    game->player.sprite = resources->atlas.player;
 }
 
-void ExpandProjectileArrayIfNeeded(GameState* game)
+void UnloadRenderResources(RenderResources* resources)
 {
-    if (game->projectileCount >= game->projectileCapacity)
-    {
-        game->projectileCapacity *= 2;
-        game->projectiles = (Projectile*)realloc(game->projectiles, 
-            sizeof(Projectile) * game->projectileCapacity);
-    }
+    FreeSpriteBatch(&resources->sprites);
+    UnloadSpriteAtlas(&resources->atlas);
+    UnloadParticleRenderer(&resources->particles);
+    UnloadStarField(&resources->stars);
 }
 
-void CreateHitEffect(GameState* game, Vector2 position, Color color)
+// alpha is how far the render time is between the last two simulation ticks (0 = previous, 1 = current)
+void DrawGameState(GameState* game, RenderResources* resources, const float alpha)
 {
-    for (int i = 0; i < HIT_EFFECT_MAX_COUNT; i++)
-    {
-        if (!game->hitEffects[i].active)
-        {
-            game->hitEffects[i].position = position;
-            game->hitEffects[i].timer = HIT_EFFECT_DURATION;
-            game->hitEffects[i].active = true;
-            game->hitEffects[i].color = color;
-            break;
-        }
-    }
-}
+    ClearBackground((Color){ 10, 10, 50, 255 });
 
-void UpdateHitEffects(GameState* game, const float deltaTime)
-{
-    for (int i = 0; i < HIT_EFFECT_MAX_COUNT; i++)
-    {
-        if (game->hitEffects[i].active)
-        {
-            game->hitEffects[i].timer -= deltaTime;
-            if (game->hitEffects[i].timer <= 0.0f)
-            {
-                game->hitEffects[i].active = false;
-            }
-        }
-    }
-}
+    // Arenas larger than the window are scaled down to fit; the default arena maps 1:1
+    const float zoom = fminf(1.0f, fminf(GetScreenWidth() / game->scenario.arenaWidth,
+                                         GetScreenHeight() / game->scenario.arenaHeight));
+    BeginMode2D((Camera2D){ .zoom = zoom });
 
-void DrawHitEffects(GameState* game)
-{
-    for (int i = 0; i < HIT_EFFECT_MAX_COUNT; i++)
+    BeginProfilerPhase(game->profiler, PROFILE_DRAW_STARS);
+    DrawStarField(&resources->stars, game->gameTime);
+    EndProfilerPhase(game->profiler, PROFILE_DRAW_STARS);
+
+    BeginProfilerPhase(game->profiler, PROFILE_DRAW_SPRITES);
+
+    const Player player = InterpolatePlayer(&game->player, alpha, &game->scenario);
+
+    for (int i = 0; i < game->scenario.monsterCount; i++)
     {
-        if (game->hitEffects[i].active)
+        if (!IsMonsterDead(&game->monsters[i]))
         {
-            const HitEffect* effect = &game->hitEffects[i];
-            const float lifeRatio = effect->timer / HIT_EFFECT_DURATION;
+            const float dx = game->monsters[i].position.x - player.position.x;
+            const float dy = game->monsters[i].position.y - player.position.y;
+            const float distance = sqrtf(dx * dx + dy * dy);
             
-            for (int p = 0; p < HIT_EFFECT_PARTICLE_COUNT; p++)
+            float opacity = 1.0f;
+            if (distance > PLAYER_VISION_RADIUS)
             {
-                const float angle = (360.0f / HIT_EFFECT_PARTICLE_COUNT) * p;
-                const float angleRad = angle * DEG2RAD;
-                const float distance = HIT_EFFECT_SIZE * (1.0f - lifeRatio);
-
-                const Vector2 particlePos =
-                {
-                    effect->position.x + cosf(angleRad) * distance,
-                    effect->position.y + sinf(angleRad) * distance
-                };
-                
-                Color particleColor = effect->color;
-                particleColor.a = (unsigned char)(255 * lifeRatio);
-                
-                DrawCircleV(particlePos, 2.0f, particleColor);
+                const float fadeDistance = 100.0f;
+                const float fadeAmount = (distance - PLAYER_VISION_RADIUS) / fadeDistance;
+                opacity = 1.0f - fadeAmount;
+                if (opacity < 0.0f) opacity = 0.0f;
             }
+            
+            DrawMonster(&resources->sprites, &game->monsters[i], player.position, opacity);
         }
     }
-}
 
-void CreateDeathExplosion(GameState* game, Vector2 position, Color color, float size)
-{
-    for (int i = 0; i < MONSTER_COUNT + 1; i++)
+    if (!IsPlayerDead(&player))
     {
-        if (!game->deathExplosions[i].active)
-        {
-            game->deathExplosions[i].position = position;
-            game->deathExplosions[i].timer = DEATH_EXPLOSION_DURATION;
-            game->deathExplosions[i].active = true;
-            game->deathExplosions[i].color = color;
-            game->deathExplosions[i].size = size;
-            break;
-        }
+        DrawPlayer(&resources->sprites, &player);
     }
-}
 
-void UpdateDeathExplosions(GameState* game, float deltaTime)
-{
-    for (int i = 0; i < MONSTER_COUNT + 1; i++)
+    // Projectiles fly in straight lines, so their previous position is one tick back along their velocity. The ones
+    // fired during the last tick had none and stay where they are, rather than being drawn back inside their shooter.
+    const float projectileRewind = (1.0f - alpha) * SIMULATION_FIXED_DELTA_TIME;
+    const ProjectileStore* projectiles = &game->projectiles;
+    const int firstNewProjectile = projectiles->count - game->newProjectileCount;
+    for (int i = 0; i < projectiles->count; i++)
     {
-        if (game->deathExplosions[i].active)
-        {
-            game->deathExplosions[i].timer -= deltaTime;
-            if (game->deathExplosions[i].timer <= 0.0f)
-            {
-                game->deathExplosions[i].active = false;
-            }
-        }
+        const float rewind = i < firstNewProjectile ? projectileRewind : 0.0f;
+        const float x = projectiles->x[i] - projectiles->velocityX[i] * rewind;
+        const float y = projectiles->y[i] - projectiles->velocityY[i] * rewind;
+        const Rectangle rectangle = { x - PROJECTILE_SIZE / 2, y - PROJECTILE_SIZE / 2, PROJECTILE_SIZE, PROJECTILE_SIZE };
+        DrawSpriteRectangle(&resources->sprites, rectangle, GetProjectileColor((ProjectileOwner)projectiles->owner[i]));
     }
-}
 
-void DrawDeathExplosions(GameState* game)
-{
-    for (int i = 0; i < MONSTER_COUNT + 1; i++)
-    {
-        if (game->deathExplosions[i].active)
-        {
-            const DeathExplosion* explosion = &game->deathExplosions[i];
-            const float lifeRatio = explosion->timer / DEATH_EXPLOSION_DURATION;
-            
-            for (int p = 0; p < DEATH_EXPLOSION_PARTICLE_COUNT; p++)
-            {
-                const float angle = (360.0f / DEATH_EXPLOSION_PARTICLE_COUNT) * p;
-                const float angleRad = angle * DEG2RAD;
-                const float distance = explosion->size * (1.0f - lifeRatio);
-
-                const Vector2 particlePos =
-                {
-                    explosion->position.x + cosf(angleRad) * distance,
-                    explosion->position.y + sinf(angleRad) * distance
-                };
-                
-                Color particleColor = explosion->color;
-                particleColor.a = (unsigned char)(255 * lifeRatio);
-
-                const float particleSize = 3.0f + (explosion->size / 20.0f);
-                DrawCircleV(particlePos, particleSize, particleColor);
-            }
-        }
-    }
-}
+    // Monsters, player and projectiles all come from the atlas: one draw call for the whole layer
+    FlushSpriteBatch(&resources->sprites);
+    EndProfilerPhase(game->profiler, PROFILE_DRAW_SPRITES);
 
-void ShootProjectile(GameState* game, float angleInDegrees, Vector2 position, ProjectileOwner owner, int monsterIndex)
-{
-    ExpandProjectileArrayIfNeeded(game);
+    BeginProfilerPhase(game->profiler, PROFILE_DRAW_PARTICLES);
+    DrawHitEffectParticles(&resources->particles, &game->hitEffects);
+    DrawDeathExplosionParticles(&resources->particles, &game->deathExplosions);
+    EndProfilerPhase(game->profiler, PROFILE_DRAW_PARTICLES);
 
-    const float angleInRadians = angleInDegrees * DEG2RAD;
-    const float dx = cosf(angleInRadians);
-    const float dy = sinf(angleInRadians);
-    
-    Projectile* proj = &game->projectiles[game->projectileCount];
-    proj->position = position;
-    proj->velocity = (Vector2){ dx * PROJECTILE_SPEED, dy * PROJECTILE_SPEED };
-    proj->size = PROJECTILE_SIZE;
-    
-    if (owner == PROJECTILE_PLAYER)
-        proj->color = PROJECTILE_PLAYER_COLOR;
-    else if (owner == PROJECTILE_MONSTER_SPREAD)
-        proj->color = PROJECTILE_MONSTER_SPREAD_COLOR;
-    else
-        proj->color = PROJECTILE_MONSTER_COLOR;
+    EndMode2D();
 
-    proj->active = true;
-    proj->owner = owner;
-    proj->monsterIndex = monsterIndex;
-    
-    game->projectileCount++;
+    BeginProfilerPhase(game->profiler, PROFILE_DRAW_UI);
+    DrawUI(game);
+    EndProfilerPhase(game->profiler, PROFILE_DRAW_UI);
 }
 
-void RemoveInactiveProjectiles(GameState* game)
+void UpdateProfilerOverlayToggle(Profiler* profiler)
 {
-    int writeIndex = 0;
-    for (int i = 0; i < game->projectileCount; i++)
-    {
-        if (game->projectiles[i].active)
-        {
-            if (writeIndex != i)
-            {
-                game->projectiles[writeIndex] = game->projectiles[i];
-            }
-            writeIndex++;
-        }
-    }
-    game->projectileCount = writeIndex;
+    if (IsKeyPressed(KEY_F3))
+        profiler->overlayVisible = !profiler->overlayVisible;
 }
 
-void UpdateProjectiles(GameState* game, float deltaTime)
+// Feeds the frame time to the simulation in fixed ticks and returns the interpolation factor for rendering.
+// Every tick is recorded when recorder is not NULL.
+float AdvanceGameState(GameState* game, float* accumulator, ReplayRecorder* recorder)
 {
-    const Rectangle playerHitbox = GetPlayerHitbox(&game->player);
-    
-    for (int i = 0; i < game->projectileCount; i++)
-    {
-        if (!game->projectiles[i].active)
-            continue;
-        
-        Projectile* proj = &game->projectiles[i];
-        
-        proj->position.x += proj->velocity.x * deltaTime;
-        proj->position.y += proj->velocity.y * deltaTime;
-        
-        if (proj->position.x < -50 || proj->position.x > SCREEN_WIDTH + 50 ||
-            proj->position.y < -50 || proj->position.y > SCREEN_HEIGHT + 50)
-        {
-            proj->active = false;
-            continue;
-        }
-
-        const Rectangle projectileRect =
-        {
-            proj->position.x - proj->size / 2,
-            proj->position.y - proj->size / 2,
-            proj->size,
-            proj->size
-        };
-        
-        if (proj->owner == PROJECTILE_PLAYER)
-        {
-            for (int m = 0; m < MONSTER_COUNT; m++)
-            {
-                if (!IsMonsterDead(&game->monsters[m]) && game->monsters[m].invincibilityTimer <= 0.0f && IsMonsterVisible(&game->monsters[m], &game->player))
-                {
-                    const Rectangle monsterHitbox = GetMonsterHitbox(&game->monsters[m]);
-                    if (CheckCollisionRecs(projectileRect, monsterHitbox))
-                    {
-                        proj->active = false;
-                        game->score++;
-                        DamageMonster(&game->monsters[m], DAMAGE_PLAYER_PROJECTILE);
-                        CreateHitEffect(game, proj->position, ORANGE);
-                        break;
-                    }
-                }
-            }
-        }
-        else if (proj->owner == PROJECTILE_MONSTER || proj->owner == PROJECTILE_MONSTER_SPREAD)
-        {
-            if (!IsPlayerDead(&game->player) && CheckCollisionRecs(projectileRect, playerHitbox))
-            {
-                proj->active = false;
+    float frameTime = GetFrameTime();
+    if (frameTime > SIMULATION_MAX_FRAME_TIME)
+        frameTime = SIMULATION_MAX_FRAME_TIME;
 
-                const float damage = (proj->owner == PROJECTILE_MONSTER_SPREAD) ? DAMAGE_MONSTER_SPREAD_SHOT : DAMAGE_MONSTER_PROJECTILE;
-                game->player.health -= damage;
-                if (game->player.health < 0.0f)
-                    game->player.health = 0.0f;
-            }
-        }
-    }
-    
-    RemoveInactiveProjectiles(game);
-}
-
-bool AreAllMonstersDead(GameState* game)
-{
-    for (int i = 0; i < MONSTER_COUNT; i++)
+    *accumulator += frameTime;
+    while (*accumulator >= SIMULATION_FIXED_DELTA_TIME)
     {
-        if (!IsMonsterDead(&game->monsters[i]))
-        {
-            return false;
-        }
+        UpdateGameState(game, SIMULATION_FIXED_DELTA_TIME);
+        if (recorder)
+            RecordReplayTick(recorder, game, SIMULATION_FIXED_DELTA_TIME);
+        *accumulator -= SIMULATION_FIXED_DELTA_TIME;
     }
 
-    return true;
+    return *accumulator / SIMULATION_FIXED_DELTA_TIME;
 }
 
-void UpdateAllMonsters(GameState* game, const float deltaTime)
-{
-    for (int i = 0; i < MONSTER_COUNT; i++) 
-    {
-        const bool wasAlive = !IsMonsterDead(&game->monsters[i]);
-        UpdateMonster(&game->monsters[i], deltaTime);
-        const bool isNowDead = IsMonsterDead(&game->monsters[i]);
-        
-        if (wasAlive && isNowDead)
-            CreateDeathExplosion(game, game->monsters[i].position, RED, game->monsters[i].size * 1.5f);
-    }
-}
-
-void ApplyProximityDamageToPlayer(GameState* game, float deltaTime)
-{
-    for (int i = 0; i < MONSTER_COUNT; i++)
-    {
-        if (!IsMonsterDead(&game->monsters[i]))
-        {
-            const float dx = game->player.position.x - game->monsters[i].position.x;
-            const float dy = game->player.position.y - game->monsters[i].position.y;
-            const float distance = sqrtf(dx * dx + dy * dy);
-            const float dangerZone = game->monsters[i].size;
-            
-            if (distance < dangerZone)
-            {
-                game->player.health -= DAMAGE_PROXIMITY_PER_SECOND * deltaTime;
-                if (game->player.health < 0.0f)
-                    game->player.health = 0.0f;
-            }
-        }
-    }
-}
+#define REPLAY_SEEK_SECONDS 5.0f
+#define REPLAY_MAX_SPEED 16.0f
+#define REPLAY_MIN_SPEED 0.25f
 
-void BuildVisibleMonstersArray(const GameState* game, MonsterView* visibleMonsters, int* outCount)
+typedef struct ReplayViewer // replay given with --replay, played back instead of a live game
 {
-    int visibleCount = 0;
-    
-    for (int i = 0; i < MONSTER_COUNT; i++)
-    {
-        if (!IsMonsterDead(&game->monsters[i]))
-        {
-            const float dx = game->player.position.x - game->monsters[i].position.x;
-            const float dy = game->player.position.y - game->monsters[i].position.y;
-            const float distance = sqrtf(dx * dx + dy * dy);
-            
-            if (distance <= PLAYER_VISION_RADIUS)
-            {
-                visibleMonsters[visibleCount].position = game->monsters[i].position;
-                visibleMonsters[visibleCount].size = game->monsters[i].size;
-                visibleMonsters[visibleCount].health = game->monsters[i].health;
-                visibleMonsters[visibleCount].invincible = game->monsters[i].invincibilityTimer > 0.0f;
-                visibleCount++;
-            }
-        }
-    }
-    *outCount = visibleCount;
-}
-
-void ProcessPlayerAIAndShooting(GameState* game)
+    Replay replay;
+    ReplayPlayer player;
+    float speed;
+    bool paused;
+} ReplayViewer;
+
+// Same as AdvanceGameState for a replay, with the keyboard controlling playback
+float AdvanceReplay(GameState* game, ReplayViewer* viewer, float* accumulator)
 {
-    static MonsterView visibleMonsters[MONSTER_COUNT];
-    int visibleCount;
-    
-    BuildVisibleMonstersArray(game, visibleMonsters, &visibleCount);
-    
-    BeginPlayerAI(&game->player, 0.0f);
-    
-    PlayerContext context;
-    context.playerPosition = game->player.position;
-    context.playerVelocity = game->player.velocity;
-    context.playerRotation = game->player.rotation;
-    context.visibleMonsters = visibleMonsters;
-    context.visibleMonsterCount = visibleCount;
-    context.deltaTime = GetFrameTime();
-    
-    OnPlayerUpdate(context);
-
-    ShootDirection shootDir;
-    if (PlayerDidShoot(&shootDir))
+    const long seekTicks = (long)(REPLAY_SEEK_SECONDS / SIMULATION_FIXED_DELTA_TIME);
+    long seekTarget = -1;
+    if (IsKeyPressed(KEY_RIGHT))
+        seekTarget = viewer->player.tick + seekTicks;
+    if (IsKeyPressed(KEY_LEFT))
+        seekTarget = viewer->player.tick > seekTicks ? viewer->player.tick - seekTicks : 0;
+    if (IsKeyPressed(KEY_HOME))
+        seekTarget = 0;
+    if (IsKeyPressed(KEY_END))
+        seekTarget = viewer->replay.tickCount;
+    if (IsKeyPressed(KEY_SPACE))
+        viewer->paused = !viewer->paused;
+    if (IsKeyPressed(KEY_UP) && viewer->speed < REPLAY_MAX_SPEED)
+        viewer->speed *= 2.0f;
+    if (IsKeyPressed(KEY_DOWN) && viewer->speed > REPLAY_MIN_SPEED)
+        viewer->speed /= 2.0f;
+
+    if (seekTarget >= 0)
     {
-        const float baseAngle = game->player.rotation;
-        
-        float shootAngle = baseAngle;
-        if (shootDir == SHOOT_LEFT)
-            shootAngle -= 90.0f;
-        else if (shootDir == SHOOT_RIGHT)
-            shootAngle += 90.0f;
-        
-        ShootProjectile(game, shootAngle, game->player.position, PROJECTILE_PLAYER, -1);
+        SeekReplay(&viewer->player, game, seekTarget);
+        *accumulator = 0.0f;
+        return 1.0f;
     }
+    if (viewer->paused)
+        return 1.0f;
 
-    EndPlayerAI();
-}
+    float frameTime = GetFrameTime();
+    if (frameTime > SIMULATION_MAX_FRAME_TIME)
+        frameTime = SIMULATION_MAX_FRAME_TIME;
 
-void ProcessMonsterShooting(GameState* game)
-{
-    for (int m = 0; m < MONSTER_COUNT; m++)
+    *accumulator += frameTime * viewer->speed;
+    while (*accumulator >= SIMULATION_FIXED_DELTA_TIME)
     {
-        if (!IsMonsterDead(&game->monsters[m]) && !IsPlayerDead(&game->player) && game->monsters[m].canShoot)
+        if (!StepReplay(&viewer->player, game))
         {
-            if (game->monsters[m].shootTimer <= 0.0f)
-            {
-                const float dx = game->player.position.x - game->monsters[m].position.x;
-                const float dy = game->player.position.y - game->monsters[m].position.y;
-                const float angleToPlayer = atan2f(dy, dx) * RAD2DEG;
-                
-                ShootProjectile(game, angleToPlayer, game->monsters[m].position, PROJECTILE_MONSTER, m);
-                game->monsters[m].shootTimer = game->monsters[m].shootCooldown;
-            }
-            
-            if (game->monsters[m].spreadShotTimer <= 0.0f)
-            {
-                for (int i = 0; i < MONSTER_SPREAD_SHOT_COUNT; i++)
-                {
-                    const float angle = (360.0f / MONSTER_SPREAD_SHOT_COUNT) * i;
-                    ShootProjectile(game, angle, game->monsters[m].position, PROJECTILE_MONSTER_SPREAD, m);
-                }
-                game->monsters[m].spreadShotTimer = game->monsters[m].spreadShotCooldown;
-            }
+            *accumulator = 0.0f;
+            return 1.0f;
         }
+        *accumulator -= SIMULATION_FIXED_DELTA_TIME;
     }
-}
 
-void UpdateGameState(GameState* game, const float deltaTime)
-{
-    const bool allMonstersDead = AreAllMonstersDead(game);
-    
-    if (!IsPlayerDead(&game->player) && !allMonstersDead)
-    {
-        game->gameTime += deltaTime;
-    }
-    
-    UpdateAllMonsters(game, deltaTime);
-    
-    const bool wasPlayerAlive = !IsPlayerDead(&game->player);
-    UpdatePlayer(&game->player, deltaTime);
-    const bool isPlayerNowDead = IsPlayerDead(&game->player);
-    
-    if (wasPlayerAlive && isPlayerNowDead)
-    {
-        CreateDeathExplosion(game, game->player.position, BLUE, PLAYER_SIZE * 1.5f);
-    }
-    
-    if (!IsPlayerDead(&game->player) && !allMonstersDead)
-    {
-        ApplyProximityDamageToPlayer(game, deltaTime);
-        ProcessPlayerAIAndShooting(game);
-    }
-    
-    ProcessMonsterShooting(game);
-    UpdateProjectiles(game, deltaTime);
-    UpdateHitEffects(game, deltaTime);
-    UpdateDeathExplosions(game, deltaTime);
+    return *accumulator / SIMULATION_FIXED_DELTA_TIME;
 }
 
-void DrawGameState(GameState* game)
+typedef struct AILibrarySet // AI libraries given with --ai; the active one drives the player
 {
-    ClearBackground((Color){ 10, 10, 50, 255 });
-
-    DrawStars(game);
+    PlayerAILibrary libraries[PLAYER_AI_LIBRARY_MAX_LOADED];
+    int count;
+    int active;
+} AILibrarySet;
 
-    for (int i = 0; i < MONSTER_COUNT; i++)
-    {
-        if (!IsMonsterDead(&game->monsters[i]))
-        {
-            const float dx = game->monsters[i].position.x - game->player.position.x;
-            const float dy = game->monsters[i].position.y - game->player.position.y;
-            const float distance = sqrtf(dx * dx + dy * dy);
-            
-            float opacity = 1.0f;
-            if (distance > PLAYER_VISION_RADIUS)
-            {
-                const float fadeDistance = 100.0f;
-                const float fadeAmount = (distance - PLAYER_VISION_RADIUS) / fadeDistance;
-                opacity = 1.0f - fadeAmount;
-                if (opacity < 0.0f) opacity = 0.0f;
-            }
-            
-            DrawMonster(&game->monsters[i], game->player.position, opacity);
-        }
-    }
+// Called between frames: swaps in rebuilt libraries and lets Tab cycle through the loaded ones
+void UpdateAILibraries(GameState* game, AILibrarySet* set)
+{
+    if (set->count == 0)
+        return;
 
-    if (!IsPlayerDead(&game->player))
+    for (int i = 0; i < set->count; i++)
     {
-        DrawPlayer(&game->player);
+        if (ReloadPlayerAILibraryIfChanged(&set->libraries[i]))
+            printf("Reloaded AI library %s (reload %d)\n", set->libraries[i].path, set->libraries[i].reloadCount);
     }
 
-    for (int i = 0; i < game->projectileCount; i++)
+    if (set->count > 1 && IsKeyPressed(KEY_TAB))
     {
-        if (game->projectiles[i].active)
-        {
-            Projectile* proj = &game->projectiles[i];
-            DrawRectangle(
-                (int)(proj->position.x - proj->size / 2),
-                (int)(proj->position.y - proj->size / 2),
-                (int)proj->size,
-                (int)proj->size,
-                proj->color
-            );
-        }
+        set->active = (set->active + 1) % set->count;
+        printf("Player AI: %s\n", set->libraries[set->active].path);
     }
 
-    DrawHitEffects(game);
-    DrawDeathExplosions(game);
-
-    DrawUI(game);
+    game->playerUpdate = set->libraries[set->active].update;
 }
 
-void CleanupGameState(GameState* game)
+void UnloadAILibraries(GameState* game, AILibrarySet* set)
 {
-    for (int i = 0; i < MONSTER_COUNT; i++)
+    game->playerUpdate = NULL;
+    for (int i = 0; i < set->count; i++)
     {
-        CleanupMonster(&game->monsters[i]);
+        UnloadPlayerAILibrary(&set->libraries[i]);
     }
-    UnloadTexture(game->sharedMonsterTexture);
-
-    CleanupPlayer(&game->player);
-    free(game->projectiles);
+    set->count = 0;
 }
 
 #ifdef PLATFORM_WEB
 #include <emscripten.h>
 static GameState* g_gameState = NULL;
+static RenderResources* g_renderResources = NULL;
+static float g_accumulator = 0.0f;
 
 static void game_loop(void)
 {
     if (!g_gameState) return;
 
-    const float deltaTime = GetFrameTime();
-    
-    UpdateGameState(g_gameState, deltaTime);
+    UpdateProfilerOverlayToggle(g_gameState->profiler);
+    const float alpha = AdvanceGameState(g_gameState, &g_accumulator, NULL);
 
     BeginDrawing();
-    DrawGameState(g_gameState);
+    DrawGameState(g_gameState, g_renderResources, alpha);
     EndDrawing();
+    EndProfilerFrame(g_gameState->profiler);
 }
 #endif
 
-int main(void)
+int main(int argc, char** argv)
 {
-    srand((unsigned int)time(NULL));
+    unsigned int seed = (unsigned int)time(NULL);
+    Scenario scenario;
+    InitDefaultScenario(&scenario);
+    const char* scriptPath = "player_ai.py";
+    const char* profilePath = NULL;
+    const char* recordPath = NULL;
+    const char* replayPath = NULL;
+    static AILibrarySet aiLibraries;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--scenario") == 0 && i + 1 < argc)
+        {
+            if (!LoadScenarioFile(&scenario, argv[++i]))
+                return 1;
+        }
+        else if (strcmp(argv[i], "--script") == 0 && i + 1 < argc)
+            scriptPath = argv[++i];
+        else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc)
+            profilePath = argv[++i];
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            recordPath = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+            replayPath = argv[++i];
+        else if (strcmp(argv[i], "--ai") == 0 && i + 1 < argc && aiLibraries.count < PLAYER_AI_LIBRARY_MAX_LOADED)
+        {
+            if (!LoadPlayerAILibrary(&aiLibraries.libraries[aiLibraries.count], argv[++i]))
+                return 1;
+            aiLibraries.count++;
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [--scenario <file>] [--script <player_ai.py>] [--ai <library> ...] [--profile <csv>]\n"
+                            "       [--seed <n>] [--record <replay>] [--replay <replay>]\n", argv[0]);
+            return 1;
+        }
+    }
     
 #ifdef PLATFORM_WEB
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Espace Confiote - Web Edition");
@@ -605,34 +335,90 @@ int main(void)
 
 #ifdef PLATFORM_WEB
     // For web, no script path needed - user provides code via UI
+    (void)scriptPath;
     if (!InitPythonAI(NULL))
     {
         fprintf(stderr, "Warning: Failed to initialize Python AI. The game will run but player AI won't work.\n");
     }
+#elif defined(USE_PYTHON_AI)
+    if (!InitPythonAI(scriptPath))
+    {
+        fprintf(stderr, "Warning: Failed to load %s. The game will run but player AI won't work.\n", scriptPath);
+    }
+#else
+    (void)scriptPath;
 #endif
 
-    GameState game;
-    InitGameState(&game);
+    static GameState game;
+    static ReplayViewer viewer;
+    if (replayPath)
+    {
+        viewer.speed = 1.0f;
+        if (!LoadReplay(&viewer.replay, replayPath) || !StartReplayPlayback(&viewer.player, &viewer.replay, &game))
+        {
+            CloseWindow();
+            return 1;
+        }
+    }
+    else
+    {
+        if (!InitGameState(&game, &scenario, seed))
+        {
+            fprintf(stderr, "Error: Failed to allocate a world for %d monsters\n", scenario.monsterCount);
+            CloseWindow();
+            return 1;
+        }
+    }
+
+    static ReplayRecorder recorder;
+    if (recordPath && !replayPath && !BeginReplayRecording(&recorder, recordPath, seed, &game, REPLAY_DEFAULT_KEYFRAME_INTERVAL))
+        fprintf(stderr, "Warning: Failed to open %s, the game will not be recorded\n", recordPath);
+
+    static RenderResources resources;
+    LoadRenderResources(&resources, &game);
+
+    // The phase timers are always on so the overlay (F3) has data as soon as it is shown
+    static Profiler profiler;
+    InitProfiler(&profiler);
+    if (profilePath && !OpenProfilerCSV(&profiler, profilePath))
+        fprintf(stderr, "Warning: Failed to open %s, frame timings will not be saved\n", profilePath);
+    game.profiler = &profiler;
 
 #ifdef PLATFORM_WEB
     g_gameState = &game;
+    g_renderResources = &resources;
     // Use Emscripten's main loop for web
     emscripten_set_main_loop(game_loop, 0, 1);
     // This won't return, but we need it for compilation
     return 0;
 #else
+    float accumulator = 0.0f;
     while (!WindowShouldClose())
     {
-        float deltaTime = GetFrameTime();
-        
-        UpdateGameState(&game, deltaTime);
+        UpdateAILibraries(&game, &aiLibraries);
+        UpdateProfilerOverlayToggle(&profiler);
+        const float alpha = replayPath ?
+            AdvanceReplay(&game, &viewer, &accumulator) :
+            AdvanceGameState(&game, &accumulator, &recorder);
 
         BeginDrawing();
-        DrawGameState(&game);
+        DrawGameState(&game, &resources, alpha);
+        if (replayPath)
+            DrawReplayBar(&viewer.player, viewer.speed, viewer.paused);
         EndDrawing();
+        EndProfilerFrame(&profiler);
     }
 
+    if (recorder.file && !EndReplayRecording(&recorder))
+        fprintf(stderr, "Warning: Failed to write %s\n", recordPath);
+    FreeReplay(&viewer.replay);
+    CloseProfiler(&profiler);
+    UnloadRenderResources(&resources);
+    UnloadAILibraries(&game, &aiLibraries);
     CleanupGameState(&game);
+#ifdef USE_PYTHON_AI
+    CleanupPythonAI();
+#endif
     CloseWindow();
 
     return 0;
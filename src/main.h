@@ -5,26 +5,15 @@
 #include "monster.h"
 #include "player.h"
 #include "config.h"
+#include "projectile_store.h"
+#include "collision_grid.h"
+#include "effect_pool.h"
+#include "frame_arena.h"
+#include "profiler.h"
+#include "random.h"
+#include "scenario.h"
 #include "player_ai_backend/player_ai.h"
 
-typedef enum ProjectileOwner 
-{
-    PROJECTILE_PLAYER,
-    PROJECTILE_MONSTER,
-    PROJECTILE_MONSTER_SPREAD
-} ProjectileOwner;
-
-typedef struct Projectile 
-{
-    Vector2 position;
-    Vector2 velocity;
-    float size;
-    Color color;
-    bool active;
-    ProjectileOwner owner;
-    int monsterIndex;
-} Projectile;
-
 typedef struct Star
 {
     Vector2 position;
@@ -36,7 +25,6 @@ typedef struct HitEffect
 {
     Vector2 position;
     float timer;
-    bool active;
     Color color;
 } HitEffect;
 
@@ -44,29 +32,41 @@ typedef struct DeathExplosion
 {
     Vector2 position;
     float timer;
-    bool active;
     Color color;
     float size;
 } DeathExplosion;
 
 typedef struct GameState 
 {
-    Monster monsters[MONSTER_COUNT];
+    Scenario scenario;
+
+    // Sized by the scenario and carved out of worldBlock
+    Monster* monsters;
+    Star* stars;
+
+    void* worldBlock;
+
+    FrameArena frameArena; // Scratch memory for the engine and the AI, reset at the start of every tick
+
     Player player;
+    PlayerUpdateFunction playerUpdate; // AI driving the player; NULL runs the linked OnPlayerUpdate
+    const PlayerInput* scriptedInput;  // Applied instead of running the AI when set (replay playback)
+    PlayerInput lastInput;             // Commands that took effect during the last tick, for replay recording
+
+    Random worldRandom;     // Draws the world in InitGameState
+    Random aiRandom;        // Handed to the AI through its PlayerControl
     
-    Projectile* projectiles;
-    int projectileCount;
-    int projectileCapacity;
-    
-    Star stars[STAR_COUNT];
-    
-    HitEffect hitEffects[HIT_EFFECT_MAX_COUNT];
-    DeathExplosion deathExplosions[MONSTER_COUNT + 1];
-    
-    Texture2D sharedMonsterTexture;
+    ProjectileStore projectiles;
+    int newProjectileCount;    // Fired during the last tick and still in flight: the last ones in projectiles
+    CollisionGrid monsterGrid; // Broadphase for projectile-vs-monster tests, rebuilt every tick
 
+    EffectPool hitEffects;       // HitEffect items
+    EffectPool deathExplosions;  // DeathExplosion items
+    
     int score;
     float gameTime;
+
+    Profiler* profiler; // Times the simulation phases when set; not owned
 } GameState;
 
 #endif // MAIN_H
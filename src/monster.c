@@ -7,8 +7,8 @@ void InitMonster(Monster* monster, const Vector2 position, const float size)
     monster->position = position;
     monster->size = size;
 
-    monster->texture = (Texture2D){0};
-    monster->explosionTexture = (Texture2D){0};
+    monster->sprite = (Sprite){0};
+    monster->explosionSprite = (Sprite){0};
     monster->fallbackColor = RED;
     
     // Health scales with size
@@ -55,21 +55,22 @@ void UpdateMonster(Monster* monster, const float deltaTime)
     }
 }
 
-void DrawMonster(const Monster* monster, const Vector2 targetPosition, const float opacity)
+#ifndef HEADLESS
+void DrawMonster(SpriteBatch* batch, const Monster* monster, const Vector2 targetPosition, const float opacity)
 {
     if (monster->isDead)
     {
-        if (monster->explosionTexture.id != 0 && monster->explosionFrame < EXPLOSION_FRAME_COUNT)
+        if (monster->explosionSprite.texture.id != 0 && monster->explosionFrame < EXPLOSION_FRAME_COUNT)
         {
-            const int frameWidth = monster->explosionTexture.width / EXPLOSION_FRAME_COUNT;
-            const int frameHeight = monster->explosionTexture.height;
+            const Rectangle frames = monster->explosionSprite.source;
+            const float frameWidth = frames.width / EXPLOSION_FRAME_COUNT;
 
             const Rectangle source =
             {
-                (float)(monster->explosionFrame * frameWidth),
-                0,
-                (float)frameWidth,
-                (float)frameHeight
+                frames.x + monster->explosionFrame * frameWidth,
+                frames.y,
+                frameWidth,
+                frames.height
             };
 
             const Rectangle dest =
@@ -91,22 +92,21 @@ void DrawMonster(const Monster* monster, const Vector2 targetPosition, const flo
             }
 
             const Color tint = (Color){255, 255, 255, (unsigned char)(explosionOpacity * 255)};
-            DrawTexturePro(monster->explosionTexture, source, dest, origin, 0, tint);
+            DrawSpriteQuad(batch, monster->explosionSprite.texture, source, dest, origin, 0, tint);
         }
         return;
     }
     
-    if (monster->texture.id != 0)
+    if (monster->sprite.texture.id != 0)
     {
         const float dx = targetPosition.x - monster->position.x;
         const float dy = targetPosition.y - monster->position.y;
         const float rotationAngle = atan2f(dy, dx) * RAD2DEG - 90.0f;
 
-        const float aspectRatio = (float)monster->texture.width / (float)monster->texture.height;
+        const float aspectRatio = monster->sprite.source.width / monster->sprite.source.height;
         const float scaledHeight = monster->size;
         const float scaledWidth = scaledHeight * aspectRatio;
 
-        const Rectangle source = { 0, 0, (float)monster->texture.width, (float)monster->texture.height };
         const Rectangle dest =
         {
             monster->position.x, 
@@ -125,7 +125,7 @@ void DrawMonster(const Monster* monster, const Vector2 targetPosition, const flo
         }
 
         const Color tint = (Color){255, 255, 255, (unsigned char)(finalOpacity * 255)};
-        DrawTexturePro(monster->texture, source, dest, origin, rotationAngle, tint);
+        DrawSpriteQuad(batch, monster->sprite.texture, monster->sprite.source, dest, origin, rotationAngle, tint);
     }
     else
     {
@@ -139,20 +139,23 @@ void DrawMonster(const Monster* monster, const Vector2 targetPosition, const flo
         
         Color tintedColor = monster->fallbackColor;
         tintedColor.a = (unsigned char)(finalOpacity * 255);
-        DrawRectangle(
-            (int)(monster->position.x - monster->size / 2),
-            (int)(monster->position.y - monster->size / 2),
-            (int)monster->size,
-            (int)monster->size,
-            tintedColor
-        );
+        const Rectangle rectangle =
+        {
+            monster->position.x - monster->size / 2,
+            monster->position.y - monster->size / 2,
+            monster->size,
+            monster->size
+        };
+        DrawSpriteRectangle(batch, rectangle, tintedColor);
     }
 }
 
+#endif // HEADLESS
+
 void CleanupMonster(Monster* monster)
 {
-    monster->texture = (Texture2D){0};
-    monster->explosionTexture = (Texture2D){0};
+    monster->sprite = (Sprite){0};
+    monster->explosionSprite = (Sprite){0};
 }
 
 bool IsMonsterDead(const Monster* monster)
@@ -191,9 +194,20 @@ Rectangle GetMonsterHitbox(const Monster* monster)
 
 bool IsMonsterVisible(const Monster* monster, const Player* player)
 {
-    const Vector2 position = monster->position;
-    const float dx = position.x - player->position.x;
-    const float dy = position.y - player->position.y;
-    const float distance = hypotf(dx, dy);
-    return distance <= (PLAYER_VISION_RADIUS + monster->size);
+    return IsMonsterVisibleFrom(monster, player->position);
+}
+
+// Answered from the squared distance unless the monster is too close to the edge for rounding not to matter,
+// since hypotf is the most expensive part of the test
+bool IsMonsterVisibleFrom(const Monster* monster, const Vector2 viewer)
+{
+    const float dx = monster->position.x - viewer.x;
+    const float dy = monster->position.y - viewer.y;
+    const float radius = PLAYER_VISION_RADIUS + monster->size;
+    const float squaredDistance = dx * dx + dy * dy;
+    if (squaredDistance < radius * radius * 0.99f)
+        return true;
+    if (squaredDistance > radius * radius * 1.01f)
+        return false;
+    return hypotf(dx, dy) <= radius;
 }
@@ -3,14 +3,15 @@
 
 #include "raylib.h"
 #include "player.h"
+#include "sprite_batch.h"
 #include <stdbool.h>
 
 typedef struct Monster 
 {
     Vector2 position;
     float size;
-    Texture2D texture;
-    Texture2D explosionTexture;
+    Sprite sprite;
+    Sprite explosionSprite;     // EXPLOSION_FRAME_COUNT frames side by side
     Color fallbackColor;
     float health;
     bool isDead;
@@ -26,12 +27,13 @@ typedef struct Monster
 
 void InitMonster(Monster* monster, Vector2 position, float size);
 void UpdateMonster(Monster* monster, float deltaTime);
-void DrawMonster(const Monster* monster, Vector2 targetPosition, float opacity);
+void DrawMonster(SpriteBatch* batch, const Monster* monster, Vector2 targetPosition, float opacity);
 void CleanupMonster(Monster* monster);
 Rectangle GetMonsterHitbox(const Monster* monster);
 bool IsMonsterDead(const Monster* monster);
 bool IsMonsterFullyExploded(const Monster* monster);
 void DamageMonster(Monster* monster, float damage);
 bool IsMonsterVisible(const Monster* monster, const Player* player);
+bool IsMonsterVisibleFrom(const Monster* monster, Vector2 viewer);
 
 #endif // MONSTER_H
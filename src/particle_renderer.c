@@ -0,0 +1,107 @@
+#include "particle_renderer.h"
+#include "main.h"
+#include "rlgl.h"
+#include <math.h>
+
+#define PARTICLE_DISC_TEXTURE_SIZE 32
+
+void FillUnitCircleDirections(Vector2* directions, const int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        const float angleRad = (360.0f / count) * i * DEG2RAD;
+        directions[i] = (Vector2){ cosf(angleRad), sinf(angleRad) };
+    }
+}
+
+void LoadParticleRenderer(ParticleRenderer* renderer)
+{
+    const int size = PARTICLE_DISC_TEXTURE_SIZE;
+    Image disc = GenImageColor(size, size, BLANK);
+    ImageDrawCircleV(&disc, (Vector2){ size / 2.0f, size / 2.0f }, size / 2 - 1, WHITE);
+    renderer->discTexture = LoadTextureFromImage(disc);
+    SetTextureFilter(renderer->discTexture, TEXTURE_FILTER_BILINEAR);
+    UnloadImage(disc);
+
+    FillUnitCircleDirections(renderer->hitDirections, HIT_EFFECT_PARTICLE_COUNT);
+    FillUnitCircleDirections(renderer->explosionDirections, DEATH_EXPLOSION_PARTICLE_COUNT);
+}
+
+void UnloadParticleRenderer(ParticleRenderer* renderer)
+{
+    UnloadTexture(renderer->discTexture);
+    renderer->discTexture = (Texture2D){0};
+}
+
+// Emits one ring of particles: every particle shares the color, distance from center and radius.
+// Must be called between rlBegin(RL_QUADS) and rlEnd().
+void EmitParticleRing(const Vector2* directions, const int count, const Vector2 center, const float distance,
+                      const float radius, const Color color)
+{
+    // Flushes the batch first if the whole ring would not fit, so a ring never straddles two draws
+    rlCheckRenderBatchLimit(4 * count);
+
+    rlColor4ub(color.r, color.g, color.b, color.a);
+    for (int p = 0; p < count; p++)
+    {
+        const float x = center.x + directions[p].x * distance;
+        const float y = center.y + directions[p].y * distance;
+
+        rlTexCoord2f(0.0f, 0.0f);
+        rlVertex2f(x - radius, y - radius);
+        rlTexCoord2f(0.0f, 1.0f);
+        rlVertex2f(x - radius, y + radius);
+        rlTexCoord2f(1.0f, 1.0f);
+        rlVertex2f(x + radius, y + radius);
+        rlTexCoord2f(1.0f, 0.0f);
+        rlVertex2f(x + radius, y - radius);
+    }
+}
+
+void DrawHitEffectParticles(const ParticleRenderer* renderer, const EffectPool* hitEffects)
+{
+    if (hitEffects->count == 0)
+        return;
+
+    rlSetTexture(renderer->discTexture.id);
+    rlBegin(RL_QUADS);
+
+    for (int i = 0; i < hitEffects->count; i++)
+    {
+        const HitEffect* effect = (const HitEffect*)GetEffect(hitEffects, i);
+        const float lifeRatio = effect->timer / HIT_EFFECT_DURATION;
+
+        Color color = effect->color;
+        color.a = (unsigned char)(255 * lifeRatio);
+
+        EmitParticleRing(renderer->hitDirections, HIT_EFFECT_PARTICLE_COUNT, effect->position,
+                         HIT_EFFECT_SIZE * (1.0f - lifeRatio), 2.0f, color);
+    }
+
+    rlEnd();
+    rlSetTexture(0);
+}
+
+void DrawDeathExplosionParticles(const ParticleRenderer* renderer, const EffectPool* deathExplosions)
+{
+    if (deathExplosions->count == 0)
+        return;
+
+    rlSetTexture(renderer->discTexture.id);
+    rlBegin(RL_QUADS);
+
+    for (int i = 0; i < deathExplosions->count; i++)
+    {
+        const DeathExplosion* explosion = (const DeathExplosion*)GetEffect(deathExplosions, i);
+        const float lifeRatio = explosion->timer / DEATH_EXPLOSION_DURATION;
+
+        Color color = explosion->color;
+        color.a = (unsigned char)(255 * lifeRatio);
+
+        EmitParticleRing(renderer->explosionDirections, DEATH_EXPLOSION_PARTICLE_COUNT, explosion->position,
+                         explosion->size * (1.0f - lifeRatio), 3.0f + (explosion->size / 20.0f), color);
+    }
+
+    rlEnd();
+    rlSetTexture(0);
+}
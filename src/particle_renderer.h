@@ -0,0 +1,23 @@
+#ifndef PARTICLE_RENDERER_H
+#define PARTICLE_RENDERER_H
+
+#include "raylib.h"
+#include "config.h"
+#include "effect_pool.h"
+
+// Draws hit effects and death explosions as textured quads streamed into rlgl's render batch,
+// one layer per call, instead of one DrawCircleV (and one cosf/sinf pair) per particle.
+typedef struct ParticleRenderer
+{
+    Texture2D discTexture;
+    Vector2 hitDirections[HIT_EFFECT_PARTICLE_COUNT];
+    Vector2 explosionDirections[DEATH_EXPLOSION_PARTICLE_COUNT];
+} ParticleRenderer;
+
+void LoadParticleRenderer(ParticleRenderer* renderer);
+void UnloadParticleRenderer(ParticleRenderer* renderer);
+
+void DrawHitEffectParticles(const ParticleRenderer* renderer, const EffectPool* hitEffects);
+void DrawDeathExplosionParticles(const ParticleRenderer* renderer, const EffectPool* deathExplosions);
+
+#endif // PARTICLE_RENDERER_H
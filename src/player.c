@@ -1,4 +1,6 @@
 #include "player.h"
+#include "player_control.h"
+#include "main.h"
 
 #include <assert.h>
 
@@ -7,21 +9,19 @@
 #include <stdlib.h>
 #include <stdio.h>
 
-static Player* g_currentPlayer = NULL;
-static float g_deltaTime = 0.0f;
-static ShootDirection g_shootDirection = SHOOT_FORWARD;
-static bool g_shootRequested = false;
-static float g_leftThruster = 0.0f;
-static float g_rightThruster = 0.0f;
+// Only used by the compatibility API; per-thread so games on different threads never see each other's control
+static _Thread_local PlayerControl* g_currentControl = NULL;
 
 void InitPlayer(Player* player, Vector2 position, float size)
 {
     player->position = position;
+    player->previousPosition = position;
     player->velocity = (Vector2){0, 0};
     player->rotation = 0.0f;
+    player->previousRotation = 0.0f;
     player->size = size;
-    player->texture = LoadTexture("resources/player.png");
-    player->explosionTexture = (Texture2D){0};
+    player->sprite = (Sprite){0};
+    player->explosionSprite = (Sprite){0};
     player->fallbackColor = YELLOW;
     player->shootCooldown = PLAYER_SHOOT_COOLDOWN;
     player->shootTimer = 0.0f;
@@ -32,10 +32,15 @@ void InitPlayer(Player* player, Vector2 position, float size)
     player->isDead = false;
     player->explosionTimer = 0.0f;
     player->explosionFrame = 0;
+    player->leftThruster = 0.0f;
+    player->rightThruster = 0.0f;
 }
 
-void UpdatePlayer(Player* player, float deltaTime)
+void UpdatePlayer(Player* player, float deltaTime, Vector2 arenaSize)
 {
+    player->previousPosition = player->position;
+    player->previousRotation = player->rotation;
+
     if (player->health <= 0.0f && !player->isDead)
     {
         player->isDead = true;
@@ -56,8 +61,8 @@ void UpdatePlayer(Player* player, float deltaTime)
     if (player->shootTimer > 0.0f)
         player->shootTimer -= deltaTime;
 
-    const float avgThrust = (g_leftThruster + g_rightThruster) / 2.0f;
-    const float thrustDiff = g_rightThruster - g_leftThruster;
+    const float avgThrust = (player->leftThruster + player->rightThruster) / 2.0f;
+    const float thrustDiff = player->rightThruster - player->leftThruster;
     
     player->rotation += thrustDiff * player->turnRate * deltaTime;
 
@@ -68,8 +73,9 @@ void UpdatePlayer(Player* player, float deltaTime)
     player->velocity.x += thrustX * deltaTime;
     player->velocity.y += thrustY * deltaTime;
     
-    player->velocity.x *= PLAYER_DRAG;
-    player->velocity.y *= PLAYER_DRAG;
+    const float drag = powf(PLAYER_DRAG, deltaTime * PLAYER_DRAG_REFERENCE_RATE);
+    player->velocity.x *= drag;
+    player->velocity.y *= drag;
 
     const float speed = sqrtf(player->velocity.x * player->velocity.x +
                        player->velocity.y * player->velocity.y);
@@ -82,57 +88,82 @@ void UpdatePlayer(Player* player, float deltaTime)
     player->position.x += player->velocity.x * deltaTime;
     player->position.y += player->velocity.y * deltaTime;
 
-    const int screenWidth = GetScreenWidth();
-    const int screenHeight = GetScreenHeight();
-    
     if (player->position.x < 0)
-        player->position.x = (float)screenWidth;
-    else if (player->position.x > (float)screenWidth)
+        player->position.x = arenaSize.x;
+    else if (player->position.x > arenaSize.x)
         player->position.x = 0;
     
     if (player->position.y < 0)
-        player->position.y = (float)screenHeight;
-    else if (player->position.y > (float)screenHeight)
+        player->position.y = arenaSize.y;
+    else if (player->position.y > arenaSize.y)
         player->position.y = 0;
 }
 
-void BeginPlayerAI(Player* player, float deltaTime)
+void BeginPlayerAI(PlayerControl* control, GameState* game, const float deltaTime, const MonsterView* visibleMonsters, const int visibleMonsterCount)
 {
-    g_currentPlayer = player;
-    g_deltaTime = deltaTime;
-    g_shootRequested = false;
+    control->game = game;
+    control->player = &game->player;
+    control->frameArena = &game->frameArena;
+    control->random = &game->aiRandom;
+    control->deltaTime = deltaTime;
+    control->visibleMonsters = visibleMonsters;
+    control->visibleMonsterCount = visibleMonsterCount;
+    control->shootRequested = false;
+    control->shootDirection = SHOOT_FORWARD;
+    control->lineOfFireReady = false;
+    control->forecastWorld = NULL;
+    g_currentControl = control;
 }
 
-void EndPlayerAI(void)
+void EndPlayerAI(PlayerControl* control)
 {
-    g_currentPlayer = NULL;
+    control->game = NULL;
+    control->player = NULL;
+    control->frameArena = NULL;
+    control->random = NULL;
+    control->visibleMonsters = NULL;
+    control->visibleMonsterCount = 0;
+    control->lineOfFireReady = false;
+    control->forecastWorld = NULL;
+    if (g_currentControl == control)
+        g_currentControl = NULL;
 }
 
-bool PlayerDidShoot(ShootDirection* outDirection)
+bool PlayerDidShoot(const PlayerControl* control, ShootDirection* outDirection)
 {
-    if (g_shootRequested && outDirection)
+    if (control->shootRequested && outDirection)
     {
-        *outDirection = g_shootDirection;
+        *outDirection = control->shootDirection;
         return true;
     }
     return false;
 }
 
-void DrawPlayer(const Player* player)
+float GetShootAngle(const float rotation, const ShootDirection direction)
+{
+    if (direction == SHOOT_LEFT)
+        return rotation - 90.0f;
+    if (direction == SHOOT_RIGHT)
+        return rotation + 90.0f;
+    return rotation;
+}
+
+#ifndef HEADLESS
+void DrawPlayer(SpriteBatch* batch, const Player* player)
 {
     if (player->isDead)
     {
-        if (player->explosionTexture.id != 0 && player->explosionFrame < EXPLOSION_FRAME_COUNT)
+        if (player->explosionSprite.texture.id != 0 && player->explosionFrame < EXPLOSION_FRAME_COUNT)
         {
-            const int frameWidth = player->explosionTexture.width / EXPLOSION_FRAME_COUNT;
-            const int frameHeight = player->explosionTexture.height;
+            const Rectangle frames = player->explosionSprite.source;
+            const float frameWidth = frames.width / EXPLOSION_FRAME_COUNT;
 
             const Rectangle source =
             {
-                (float)(player->explosionFrame * frameWidth),
-                0,
-                (float)frameWidth,
-                (float)frameHeight
+                frames.x + player->explosionFrame * frameWidth,
+                frames.y,
+                frameWidth,
+                frames.height
             };
 
             const Rectangle dest =
@@ -155,20 +186,19 @@ void DrawPlayer(const Player* player)
             }
 
             const Color tint = (Color){255, 255, 255, (unsigned char)(explosionOpacity * 255)};
-            DrawTexturePro(player->explosionTexture, source, dest, origin, 0, tint);
+            DrawSpriteQuad(batch, player->explosionSprite.texture, source, dest, origin, 0, tint);
         }
         return;
     }
     
-    if (player->texture.id != 0)
+    if (player->sprite.texture.id != 0)
     {
         const float playerRotationAngle = player->rotation + 90.0f;
 
-        const float playerAspectRatio = (float)player->texture.width / (float)player->texture.height;
+        const float playerAspectRatio = player->sprite.source.width / player->sprite.source.height;
         const float playerScaledHeight = player->size;
         const float playerScaledWidth = playerScaledHeight * playerAspectRatio;
 
-        const Rectangle playerSource = { 0, 0, (float)player->texture.width, (float)player->texture.height };
         const Rectangle playerDest =
         {
             player->position.x, 
@@ -178,25 +208,21 @@ void DrawPlayer(const Player* player)
         };
         const Vector2 playerOrigin = { playerScaledWidth / 2, playerScaledHeight / 2 };
         
-        DrawTexturePro(player->texture, playerSource, playerDest, playerOrigin, playerRotationAngle, WHITE);
+        DrawSpriteQuad(batch, player->sprite.texture, player->sprite.source, playerDest, playerOrigin, playerRotationAngle, WHITE);
     }
     else
     {
-        DrawRectangle(
-            (int)(player->position.x - player->size / 2),
-            (int)(player->position.y - player->size / 2),
-            (int)player->size,
-            (int)player->size,
-            player->fallbackColor
-        );
+        const Rectangle rectangle =
+        {
+            player->position.x - player->size / 2,
+            player->position.y - player->size / 2,
+            player->size,
+            player->size
+        };
+        DrawSpriteRectangle(batch, rectangle, player->fallbackColor);
     }
 }
-
-void CleanupPlayer(const Player* player)
-{
-    UnloadTexture(player->texture);
-    UnloadTexture(player->explosionTexture);
-}
+#endif // HEADLESS
 
 Rectangle GetPlayerHitbox(const Player* player)
 {
@@ -209,29 +235,29 @@ Rectangle GetPlayerHitbox(const Player* player)
     };
 }
 
-void PlayerShoot(ShootDirection direction)
+void PlayerControlShoot(PlayerControl* control, ShootDirection direction)
 {
-    if (g_currentPlayer == NULL)
+    if (control == NULL || control->player == NULL)
         return;
-    if (g_currentPlayer->isDead)
+    if (control->player->isDead)
         return;
-    if (g_currentPlayer->shootTimer > 0.0f)
+    if (control->player->shootTimer > 0.0f)
         return;
     
-    g_currentPlayer->shootTimer = g_currentPlayer->shootCooldown;
-    g_shootRequested = true;
-    g_shootDirection = direction;
+    control->player->shootTimer = control->player->shootCooldown;
+    control->shootRequested = true;
+    control->shootDirection = direction;
 }
 
-void PlayerSetThrusters(float leftPower, float rightPower)
+void PlayerControlSetThrusters(PlayerControl* control, float leftPower, float rightPower)
 {
-    if (g_currentPlayer == NULL)
+    if (control == NULL || control->player == NULL)
     {
-        printf("ERROR: g_currentPlayer is NULL, returning early!\n");
+        fprintf(stderr, "Error: no player is being controlled, returning early\n");
         return;
     }
 
-    if (g_currentPlayer->isDead)
+    if (control->player->isDead)
         return;
     
     if (leftPower < -1.0f)
@@ -243,15 +269,209 @@ void PlayerSetThrusters(float leftPower, float rightPower)
     if (rightPower > 1.0f)
         rightPower = 1.0f;
     
-    g_leftThruster = leftPower;
-    g_rightThruster = rightPower;
+    control->player->leftThruster = leftPower;
+    control->player->rightThruster = rightPower;
 }
 
-Vector2 PlayerGetPosition(void)
+Vector2 PlayerControlGetPosition(const PlayerControl* control)
 {
-    if (g_currentPlayer == NULL)
+    if (control == NULL || control->player == NULL)
         return (Vector2){0, 0};
-    return g_currentPlayer->position;
+    return control->player->position;
+}
+
+// Index of the first visible monster farther than distance from the ship
+int FindVisibleMonsterAfterDistance(const PlayerControl* control, const float distance)
+{
+    int low = 0;
+    int high = control->visibleMonsterCount;
+    while (low < high)
+    {
+        const int middle = (low + high) / 2;
+        if (control->visibleMonsters[middle].distance <= distance)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+int PlayerControlGetNearestMonsters(const PlayerControl* control, const int k, const MonsterView** outMonsters)
+{
+    if (control == NULL || control->visibleMonsters == NULL || k <= 0)
+        return 0;
+    *outMonsters = control->visibleMonsters;
+    return k < control->visibleMonsterCount ? k : control->visibleMonsterCount;
+}
+
+int PlayerControlGetMonstersInRadius(const PlayerControl* control, const float radius, const MonsterView** outMonsters)
+{
+    if (control == NULL || control->visibleMonsters == NULL)
+        return 0;
+    *outMonsters = control->visibleMonsters;
+    return FindVisibleMonsterAfterDistance(control, radius);
+}
+
+int PlayerControlFindMonstersNear(const PlayerControl* control, const Vector2 point, const float radius, const MonsterView** outMonsters, const int maxCount)
+{
+    if (control == NULL || control->visibleMonsters == NULL || control->player == NULL)
+        return 0;
+
+    // A monster within radius of point is within radius of the point's distance to the ship, so only the slice
+    // of the sorted list in [distance - radius, distance + radius] is tested (with a pixel of slack for rounding)
+    const float dx = point.x - control->player->position.x;
+    const float dy = point.y - control->player->position.y;
+    const float pointDistance = sqrtf(dx * dx + dy * dy);
+    const float firstDistance = pointDistance - radius - 1.0f;
+    const int first = firstDistance > 0.0f ? FindVisibleMonsterAfterDistance(control, firstDistance) : 0;
+    const float lastDistance = pointDistance + radius + 1.0f;
+
+    int count = 0;
+    for (int i = first; i < control->visibleMonsterCount && count < maxCount; i++)
+    {
+        const MonsterView* monster = &control->visibleMonsters[i];
+        if (monster->distance > lastDistance)
+            break;
+
+        const float mx = monster->position.x - point.x;
+        const float my = monster->position.y - point.y;
+        if (mx * mx + my * my <= radius * radius)
+            outMonsters[count++] = monster;
+    }
+    return count;
+}
+
+void* PlayerControlAllocate(PlayerControl* control, const size_t size)
+{
+    if (control == NULL || control->frameArena == NULL)
+        return NULL;
+    return FrameArenaAlloc(control->frameArena, size);
+}
+
+int PlayerControlRandomInt(PlayerControl* control, const int min, const int max)
+{
+    if (control == NULL || control->random == NULL || max < min)
+        return min;
+    return RandomInt(control->random, min, max);
+}
+
+float PlayerControlRandomFloat(PlayerControl* control)
+{
+    if (control == NULL || control->random == NULL)
+        return 0.0f;
+    return RandomFloat(control->random);
+}
+
+// The hitboxes only depend on the visible monsters, so they are laid out once per tick however many rays are cast
+static bool PrepareLineOfFire(PlayerControl* control)
+{
+    if (control->lineOfFireReady)
+        return true;
+
+    if (!InitLineOfFireTargets(&control->lineOfFire, control->frameArena, control->visibleMonsterCount))
+        return false;
+
+    for (int i = 0; i < control->visibleMonsterCount; i++)
+    {
+        const MonsterView* monster = &control->visibleMonsters[i];
+        if (monster->invincible)
+            continue;
+
+        const Rectangle hitbox =
+        {
+            monster->position.x - monster->size / 2,
+            monster->position.y - monster->size / 2,
+            monster->size,
+            monster->size
+        };
+        AddLineOfFireTarget(&control->lineOfFire, hitbox, i);
+    }
+
+    control->lineOfFireReady = true;
+    return true;
+}
+
+int PlayerControlCastRays(PlayerControl* control, const float* angles, const int rayCount, PlayerRayHit* outHits)
+{
+    if (control == NULL || control->player == NULL || control->frameArena == NULL)
+        return 0;
+
+    const bool ready = PrepareLineOfFire(control);
+    const Vector2 origin = control->player->position;
+    int hitCount = 0;
+    for (int r = 0; r < rayCount; r++)
+    {
+        const float angleInRadians = angles[r] * DEG2RAD;
+        const Vector2 direction = { cosf(angleInRadians), sinf(angleInRadians) };
+
+        float distance = 0.0f;
+        const int monster = ready ? CastLineOfFire(&control->lineOfFire, origin, direction, &distance) : -1;
+        if (monster < 0)
+        {
+            outHits[r] = (PlayerRayHit){ NULL, 0.0f, -1.0f };
+            continue;
+        }
+
+        outHits[r] = (PlayerRayHit){ &control->visibleMonsters[monster], distance, distance / PROJECTILE_SPEED };
+        hitCount++;
+    }
+    return hitCount;
+}
+
+int PlayerControlCastShots(PlayerControl* control, PlayerRayHit outHits[SHOOT_DIRECTION_COUNT])
+{
+    if (control == NULL || control->player == NULL)
+        return 0;
+
+    float angles[SHOOT_DIRECTION_COUNT];
+    for (int d = 0; d < SHOOT_DIRECTION_COUNT; d++)
+        angles[d] = GetShootAngle(control->player->rotation, (ShootDirection)d);
+    return PlayerControlCastRays(control, angles, SHOOT_DIRECTION_COUNT, outHits);
+}
+
+void PlayerShoot(ShootDirection direction)
+{
+    PlayerControlShoot(g_currentControl, direction);
+}
+
+void PlayerSetThrusters(float leftPower, float rightPower)
+{
+    PlayerControlSetThrusters(g_currentControl, leftPower, rightPower);
+}
+
+Vector2 PlayerGetPosition(void)
+{
+    return PlayerControlGetPosition(g_currentControl);
+}
+
+void* PlayerAllocate(const size_t size)
+{
+    return PlayerControlAllocate(g_currentControl, size);
+}
+
+int PlayerRandomInt(const int min, const int max)
+{
+    return PlayerControlRandomInt(g_currentControl, min, max);
+}
+
+float PlayerRandomFloat(void)
+{
+    return PlayerControlRandomFloat(g_currentControl);
+}
+
+int PlayerCastRays(const float* angles, const int rayCount, PlayerRayHit* outHits)
+{
+    return PlayerControlCastRays(g_currentControl, angles, rayCount, outHits);
+}
+
+int PlayerCastShots(PlayerRayHit outHits[SHOOT_DIRECTION_COUNT])
+{
+    return PlayerControlCastShots(g_currentControl, outHits);
+}
+
+bool PlayerForecast(const PlayerInput* inputs, const int tickCount, PlayerForecastResult* outForecast)
+{
+    return PlayerControlForecast(g_currentControl, inputs, tickCount, outForecast);
 }
 
 bool IsPlayerDead(const Player* player)
@@ -2,6 +2,8 @@
 #define PLAYER_H
 
 #include "raylib.h"
+#include "sprite_batch.h"
+#include <stddef.h>
 
 typedef struct MonsterView // read-only data exposed to player AI
 {
@@ -9,27 +11,37 @@ typedef struct MonsterView // read-only data exposed to player AI
     float size;
     float health;
     bool invincible;
+    float distance;         // From the ship's center
+    float bearing;          // Direction from the ship in degrees, in [0, 360), same convention as playerRotation
+    float relativeAngle;    // bearing - playerRotation, in [-180, 180); positive means the monster is to the right
 } MonsterView;
 
 
+typedef struct PlayerControl PlayerControl;
+typedef struct GameState GameState;
+typedef struct PlayerForecastWorld PlayerForecastWorld;
+
 typedef struct PlayerContext // limited information exposed to player code
 {
     Vector2 playerPosition;
     Vector2 playerVelocity;
     float playerRotation;
-    const MonsterView* visibleMonsters; // Array of monster views
+    const MonsterView* visibleMonsters; // Array of monster views, nearest first
     int visibleMonsterCount;
     float deltaTime;
+    PlayerControl* control; // Handle to pass to the PlayerControl* functions below
 } PlayerContext;
 
 typedef struct Player 
 {
     Vector2 position;
+    Vector2 previousPosition; // State at the start of the last tick, used for render interpolation
     Vector2 velocity;
     float rotation;
+    float previousRotation;
     float size;
-    Texture2D texture;
-    Texture2D explosionTexture;
+    Sprite sprite;
+    Sprite explosionSprite;     // EXPLOSION_FRAME_COUNT frames side by side
     Color fallbackColor;
     float shootCooldown;
     float shootTimer;
@@ -40,6 +52,8 @@ typedef struct Player
     bool isDead;
     float explosionTimer;
     int explosionFrame;
+    float leftThruster;
+    float rightThruster;
 } Player;
 
 typedef enum ShootDirection 
@@ -49,24 +63,92 @@ typedef enum ShootDirection
     SHOOT_RIGHT
 } ShootDirection;
 
+#define SHOOT_DIRECTION_COUNT 3
+
+typedef struct PlayerInput // the commands of one tick, as far as the simulation is concerned
+{
+    float leftThruster;
+    float rightThruster;
+    bool shoot;
+    ShootDirection shootDirection;
+} PlayerInput;
+
+typedef struct PlayerRayHit // what a projectile fired along a ray would hit if monsters stayed where they are
+{
+    const MonsterView* monster; // First monster hit, NULL if none
+    float distance;             // Travelled by the projectile's center until it touches the monster
+    float timeToImpact;         // distance / PROJECTILE_SPEED in seconds, -1 if nothing is hit
+} PlayerRayHit;
+
+typedef struct PlayerForecastResult // where a sequence of commands would leave the ship, see PlayerControlForecast
+{
+    Vector2 position;
+    Vector2 velocity;
+    float rotation;
+    float health;               // 0 if the ship would be destroyed
+    float damageDealt;          // Health taken off the visible monsters
+    int monstersDestroyed;
+    int ticks;                  // Ticks simulated: the whole sequence unless the ship is destroyed first
+} PlayerForecastResult;
+
 // API functions available to player code
+void PlayerControlShoot(PlayerControl* control, ShootDirection direction);
+void PlayerControlSetThrusters(PlayerControl* control, float leftPower, float rightPower); // -1.0 to 1.0
+Vector2 PlayerControlGetPosition(const PlayerControl* control);
+// Queries over the visible monsters. The first two return a prefix of the distance-sorted list without copying:
+// *outMonsters points at the returned number of monsters, nearest first.
+int PlayerControlGetNearestMonsters(const PlayerControl* control, int k, const MonsterView** outMonsters);
+int PlayerControlGetMonstersInRadius(const PlayerControl* control, float radius, const MonsterView** outMonsters);
+// Stores into outMonsters (up to maxCount) the visible monsters centered within radius of point, nearest to the ship first
+int PlayerControlFindMonstersNear(const PlayerControl* control, Vector2 point, float radius, const MonsterView** outMonsters, int maxCount);
+// Scratch memory that stays valid until the end of the current tick; no need to free it. 16-byte aligned, NULL on failure.
+void* PlayerControlAllocate(PlayerControl* control, size_t size);
+// Random numbers from a generator seeded with the game, so seeded runs stay reproducible (unlike rand())
+int PlayerControlRandomInt(PlayerControl* control, int min, int max); // min and max included
+float PlayerControlRandomFloat(PlayerControl* control);               // In [0, 1)
+// Casts rays from the ship at angles in degrees (same convention as playerRotation) against the hitboxes of the
+// visible monsters, as a projectile would travel. Returns how many rays hit a monster.
+int PlayerControlCastRays(PlayerControl* control, const float* angles, int rayCount, PlayerRayHit* outHits);
+// Same for the directions PlayerControlShoot fires in; outHits is indexed by ShootDirection
+int PlayerControlCastShots(PlayerControl* control, PlayerRayHit outHits[SHOOT_DIRECTION_COUNT]);
+// Plays the game forward from this tick with inputs[t] as the commands of tick t (inputs[0] being the ones this
+// call issues) and reports where the ship would end up. Only what the ship can see takes part: the visible monsters
+// and the projectiles within its vision radius, plus its own. Nothing is changed in the actual game.
+bool PlayerControlForecast(PlayerControl* control, const PlayerInput* inputs, int tickCount, PlayerForecastResult* outForecast);
+
+// Compatibility versions of the above acting on the control of the OnPlayerUpdate call running on this thread
 void PlayerShoot(ShootDirection direction);
 void PlayerSetThrusters(float leftPower, float rightPower); // -1.0 to 1.0
 Vector2 PlayerGetPosition(void);
 Vector2 PlayerGetMonsterPosition(void);
+void* PlayerAllocate(size_t size);
+int PlayerRandomInt(int min, int max);
+float PlayerRandomFloat(void);
+int PlayerCastRays(const float* angles, int rayCount, PlayerRayHit* outHits);
+int PlayerCastShots(PlayerRayHit outHits[SHOOT_DIRECTION_COUNT]);
+bool PlayerForecast(const PlayerInput* inputs, int tickCount, PlayerForecastResult* outForecast);
+
+// AI libraries loaded at runtime (see player_ai_library.h) must export OnPlayerUpdate with default visibility
+#if defined(_WIN32)
+#define PLAYER_AI_EXPORT __declspec(dllexport)
+#else
+#define PLAYER_AI_EXPORT __attribute__((visibility("default")))
+#endif
+
+typedef void (*PlayerUpdateFunction)(PlayerContext context);
 
 // Function that user implements
-void OnPlayerUpdate(PlayerContext context);
+PLAYER_AI_EXPORT void OnPlayerUpdate(PlayerContext context);
 
 // Internal functions (not for player code)
 void InitPlayer(Player* player, Vector2 position, float size);
-void UpdatePlayer(Player* player, float deltaTime);
-void BeginPlayerAI(Player* player, float deltaTime);
-void EndPlayerAI(void);
-void DrawPlayer(const Player* player);
-void CleanupPlayer(const Player* player);
+void UpdatePlayer(Player* player, float deltaTime, Vector2 arenaSize);
+void BeginPlayerAI(PlayerControl* control, GameState* game, float deltaTime, const MonsterView* visibleMonsters, int visibleMonsterCount);
+void EndPlayerAI(PlayerControl* control);
+void DrawPlayer(SpriteBatch* batch, const Player* player);
 Rectangle GetPlayerHitbox(const Player* player);
-bool PlayerDidShoot(ShootDirection* outDirection);
+bool PlayerDidShoot(const PlayerControl* control, ShootDirection* outDirection);
+float GetShootAngle(float rotation, ShootDirection direction);
 bool IsPlayerDead(const Player* player);
 bool IsPlayerFullyExploded(const Player* player);
 
@@ -8,76 +8,41 @@
 // - context.playerPosition - your current position
 // - context.playerVelocity - your current velocity
 // - context.playerRotation - your current rotation (degrees)
-// - context.visibleMonsters - array of visible monster views
+// - context.visibleMonsters - array of visible monster views, nearest first, each with its distance, bearing
+//   and relativeAngle (to your heading) already computed
 // - context.visibleMonsterCount - number of visible monsters
-// - context.deltaTime - time since last frame
+// - context.deltaTime - duration of a simulation tick (fixed)
+// - context.control - handle to your ship, passed to the functions below
 //
 // Available functions:
-// - PlayerShoot(direction) - shoot in direction: SHOOT_FORWARD, SHOOT_LEFT, or SHOOT_RIGHT
-// - PlayerSetThrusters(leftPower, rightPower) - set thruster power from -1.0 to 1.0
+// - PlayerControlShoot(control, direction) - shoot in direction: SHOOT_FORWARD, SHOOT_LEFT, or SHOOT_RIGHT
+// - PlayerControlSetThrusters(control, leftPower, rightPower) - set thruster power from -1.0 to 1.0
 //   - Both same = move forward/backward
 //   - Different = turn (right > left = turn right)
-
-typedef struct
-{
-    MonsterView monster;
-    float distance;
-} MonsterDistance;
-
-int CompareDistance(const void *a, const void *b)
-{
-    float distA = ((MonsterDistance *)a)->distance;
-    float distB = ((MonsterDistance *)b)->distance;
-    if (distA < distB)
-        return -1;
-    if (distA > distB)
-        return 1;
-    return 0;
-}
-
-MonsterDistance* SortMonstersByDistance(PlayerContext context)
-{
-    if (context.visibleMonsterCount == 0)
-    {
-        return NULL;
-    }
-
-    MonsterDistance *distances = malloc(sizeof(MonsterDistance) * context.visibleMonsterCount);
-    for (int i = 0; i < context.visibleMonsterCount; i++)
-    {
-        float dx = context.playerPosition.x - context.visibleMonsters[i].position.x;
-        float dy = context.playerPosition.y - context.visibleMonsters[i].position.y;
-        float dist = hypotf(dx, dy);
-        distances[i].monster = context.visibleMonsters[i];
-        distances[i].distance = dist;
-    }
-
-    qsort(distances, context.visibleMonsterCount, sizeof(MonsterDistance), CompareDistance);
-    return distances;
-}
-
-MonsterView* GetNearestMonster(PlayerContext* context, MonsterDistance* distances, bool skipInvincible)
+// - PlayerControlGetNearestMonsters / PlayerControlGetMonstersInRadius / PlayerControlFindMonstersNear - monster queries
+// - PlayerControlAllocate(control, size) - scratch memory freed automatically at the end of the tick
+// - PlayerControlRandomInt(control, min, max) / PlayerControlRandomFloat(control) - random numbers seeded with the game
+// - PlayerControlForecast(control, inputs, tickCount, &forecast) - where a sequence of commands would leave the ship
+
+// Logging is compiled out of headless builds, where it would dominate the run time
+#ifdef HEADLESS
+#define AI_LOG(...) ((void)0)
+#else
+#define AI_LOG(...) printf(__VA_ARGS__)
+#endif
+
+// The engine hands over the visible monsters sorted by distance, so the nearest one is the first match
+const MonsterView* GetNearestMonster(const PlayerContext* context, bool skipInvincible)
 {
-    if (distances == NULL)
-    {
-        return NULL;
-    }
-
-    size_t index = 0;
-
-    if (skipInvincible)
+    for (int i = 0; i < context->visibleMonsterCount; i++)
     {
-        while (distances[index].monster.invincible)
+        if (!skipInvincible || !context->visibleMonsters[i].invincible)
         {
-            index++;
-            if (index >= context->visibleMonsterCount) // Reached end of array
-            {
-                return NULL;
-            }
+            return &context->visibleMonsters[i];
         }
     }
 
-    return &distances[index].monster;
+    return NULL;
 }
 
 float ClampAngle(float angle)
@@ -87,129 +52,129 @@ float ClampAngle(float angle)
     return angle;
 }
 
-void ThrustBackward(void)
+void ShootForward(PlayerControl* control)
 {
-    printf("Too close to monster! Thrusting backward.\n");
-    PlayerShoot(SHOOT_FORWARD);
-    PlayerSetThrusters(-1.0f, -1.0f); // Thrust backward
+    AI_LOG("Close angle - Shooting forward.\n");
+    PlayerControlSetThrusters(control, 1.0f, 1.0f); // Move forward
+    PlayerControlShoot(control, SHOOT_FORWARD);
+}
+
+// Whether the ship survives backing off for half a second, shooting ahead. Only worth asking at close range.
+bool CanBackOff(PlayerControl* control)
+{
+    PlayerInput inputs[30];
+    for (int t = 0; t < 30; t++)
+    {
+        inputs[t] = (PlayerInput){ -1.0f, -1.0f, true, SHOOT_FORWARD };
+    }
+
+    PlayerForecastResult forecast;
+    return !PlayerControlForecast(control, inputs, 30, &forecast) || forecast.health > 0.0f;
 }
 
-void ShootForward(void)
+void ThrustBackward(PlayerControl* control, float distance)
 {
-    printf("Close angle - Shooting forward.\n");
-    PlayerSetThrusters(1.0f, 1.0f); // Move forward
-    PlayerShoot(SHOOT_FORWARD);
+    if (distance < 100.0f && !CanBackOff(control))
+    {
+        AI_LOG("Too close to monster and no way out! Charging.\n");
+        ShootForward(control);
+        return;
+    }
+
+    AI_LOG("Too close to monster! Thrusting backward.\n");
+    PlayerControlShoot(control, SHOOT_FORWARD);
+    PlayerControlSetThrusters(control, -1.0f, -1.0f); // Thrust backward
 }
 
-void ThrustToMatchAngle(float angleDiff)
+void ThrustToMatchAngle(PlayerControl* control, float angleDiff)
 {
     if (angleDiff > 180.0f)
     {
-        printf("Turning left.\n");
-        PlayerSetThrusters(1.f, 0.f); // Turn left
-        PlayerShoot(SHOOT_LEFT);
+        AI_LOG("Turning left.\n");
+        PlayerControlSetThrusters(control, 1.f, 0.f); // Turn left
+        PlayerControlShoot(control, SHOOT_LEFT);
     }
     else
     {
-        printf("Turning right.\n");
-        PlayerSetThrusters(0.f, 1.f); // Turn right
-        PlayerShoot(SHOOT_RIGHT);
+        AI_LOG("Turning right.\n");
+        PlayerControlSetThrusters(control, 0.f, 1.f); // Turn right
+        PlayerControlShoot(control, SHOOT_RIGHT);
     }
 }
 
-void ShootRandomly(void)
+void ShootRandomly(PlayerControl* control)
 {
-    ShootDirection dir = (ShootDirection)(rand() % 3);
-    PlayerShoot(dir);
+    ShootDirection dir = (ShootDirection)PlayerControlRandomInt(control, 0, SHOOT_DIRECTION_COUNT - 1);
+    PlayerControlShoot(control, dir);
 }
 
-void Roam(void)
+void Roam(PlayerControl* control)
 {
-    printf("No visible monsters. Moving forward.\n");
-    ShootRandomly();
-    PlayerSetThrusters(1.0f, 1.0f); // Just move forward if no monsters
+    AI_LOG("No visible monsters. Moving forward.\n");
+    ShootRandomly(control);
+    PlayerControlSetThrusters(control, 1.0f, 1.0f); // Just move forward if no monsters
 }
 
-bool IsMonsterOnTheWay(Vector2 playerPosition, float angle, MonsterView* monster)
+bool IsMonsterOnTheWay(const MonsterView* monster)
 {
-    Vector2 toMonster =
-    {
-        monster->position.x - playerPosition.x,
-        monster->position.y - playerPosition.y
-    };
-
-    float angleToMonster = ClampAngle(atan2f(toMonster.y, toMonster.x) * RAD2DEG);
-    float angleDiff = angleToMonster - angle;
-    angleDiff = ClampAngle(angleDiff);
-
-    return fabs(angleDiff) < 15.0f; // Consider "on the way" if within 15 degrees
+    return ClampAngle(monster->relativeAngle) < 15.0f; // Consider "on the way" if within 15 degrees
 }
 
 void OnPlayerUpdate(PlayerContext context)
 {
+    PlayerControl* control = context.control;
     const float rangeAngle = 7.5f;
     const float minDistance = 250.0f;
-    MonsterDistance* sortedDistances = SortMonstersByDistance(context);
-    MonsterView *nearestMonsterAll = GetNearestMonster(&context, sortedDistances, true);
-    MonsterView *nearestMonster = GetNearestMonster(&context, sortedDistances, false);
+    const MonsterView *nearestMonsterAll = GetNearestMonster(&context, true);
+    const MonsterView *nearestMonster = GetNearestMonster(&context, false);
 
     if (nearestMonster == NULL)
     {
-        if (nearestMonsterAll != NULL && IsMonsterOnTheWay(context.playerPosition, context.playerRotation, nearestMonsterAll))
+        if (nearestMonsterAll != NULL && IsMonsterOnTheWay(nearestMonsterAll))
         {
-            ShootRandomly();
+            ShootRandomly(control);
             goto end;
         }
-        Roam();
+        Roam(control);
         goto end;
     }
 
-    Vector2 toMonster =
-    {
-        nearestMonster->position.x - context.playerPosition.x,
-        nearestMonster->position.y - context.playerPosition.y
-    };
-
-    float distToMonster = hypotf(toMonster.x, toMonster.y);
-    float angleToMonster = ClampAngle(atan2f(toMonster.y, toMonster.x) * RAD2DEG);
-    
-    float angleDiff = angleToMonster - context.playerRotation; // Rotate toward target
-    angleDiff = ClampAngle(angleDiff);
+    float distToMonster = nearestMonster->distance;
+    float angleDiff = ClampAngle(nearestMonster->relativeAngle); // Rotate toward target
 
-    printf("Distance to monster: %.2f, Angle diff: %.2f\n", distToMonster, angleDiff);
+    AI_LOG("Distance to monster: %.2f, Angle diff: %.2f\n", distToMonster, angleDiff);
     
     if (distToMonster < minDistance) // Check if too close to monster
     {
-        ThrustBackward();
+        ThrustBackward(control, distToMonster);
         goto end;
     }
     else
     {
         if (fabs(angleDiff) > rangeAngle) // Far angle - turn in place
         {
-            if (nearestMonster != NULL && IsMonsterOnTheWay(context.playerPosition, context.playerRotation, nearestMonster))
+            if (nearestMonster != NULL && IsMonsterOnTheWay(nearestMonster))
             {
-                printf("Monster on the way! Thrusting forward while turning.\n");
-                PlayerSetThrusters(1.0f, 0.0f); // Turn while moving forward
+                AI_LOG("Monster on the way! Thrusting forward while turning.\n");
+                PlayerControlSetThrusters(control, 1.0f, 0.0f); // Turn while moving forward
                 if (angleDiff > 180.0f)
                 {
-                    PlayerShoot(SHOOT_LEFT);
+                    PlayerControlShoot(control, SHOOT_LEFT);
                 }
                 else
                 {
-                    PlayerShoot(SHOOT_RIGHT);
+                    PlayerControlShoot(control, SHOOT_RIGHT);
                 }
                 goto end;
             }
-            ThrustToMatchAngle(angleDiff);
+            ThrustToMatchAngle(control, angleDiff);
             goto end;
         }
 
         // Close angle - move forward and shoot
-        ShootForward();
+        ShootForward(control);
     }
 
 end:
-    free(sortedDistances);
-    printf("------------------------\n");
+    AI_LOG("------------------------\n");
 }
\ No newline at end of file
@@ -0,0 +1,623 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include "player_ai.h"
+#include "../player.h"
+#include <stdio.h>
+#include <string.h>
+
+// Desktop backend: embeds CPython and calls on_player_update(context) from the user's script.
+//
+// The context is a dict built once per thread and updated in place every tick. Its 'visibleMonsters' entry is a
+// MonsterArray: a float32 (count, 8) buffer of x, y, size, health, invincible, distance, bearing, relativeAngle rows,
+// nearest first, that numpy.asarray() wraps without a copy, and that still indexes like the old list of monster dicts.
+//
+// The GIL is released once the script is loaded, and every OnPlayerUpdate takes it back with PyGILState_Ensure,
+// so the backend can be driven from any thread (the tournament workers, for instance).
+
+enum
+{
+    MONSTER_COLUMN_X,
+    MONSTER_COLUMN_Y,
+    MONSTER_COLUMN_SIZE,
+    MONSTER_COLUMN_HEALTH,
+    MONSTER_COLUMN_INVINCIBLE,
+    MONSTER_COLUMN_DISTANCE,
+    MONSTER_COLUMN_BEARING,
+    MONSTER_COLUMN_RELATIVE_ANGLE,
+    MONSTER_COLUMN_COUNT
+};
+
+#define MONSTER_ARRAY_INITIAL_CAPACITY 64
+
+typedef struct MonsterArrayObject
+{
+    PyObject_HEAD
+    float* values;          // count rows of MONSTER_COLUMN_COUNT floats
+    Py_ssize_t count;
+    Py_ssize_t capacity;
+    Py_ssize_t shape[2];
+    Py_ssize_t strides[2];
+    int exports;            // Live buffer views; the array must not move or change shape while any exist
+} MonsterArrayObject;
+
+typedef struct PythonAIThreadState // Per-thread objects reused across ticks
+{
+    PyObject* context;
+    PyObject* playerPosition;
+    PyObject* playerVelocity;
+    MonsterArrayObject* monsters;
+} PythonAIThreadState;
+
+static bool g_pythonAIInitialized = false;
+static PyThreadState* g_mainThreadState = NULL;
+static PyObject* g_updateFunction = NULL;
+static _Thread_local PlayerControl* g_pythonControl = NULL;
+static _Thread_local PythonAIThreadState g_threadState;
+static _Thread_local long g_threadStateGeneration = 0;
+static long g_interpreterGeneration = 0; // Invalidates thread states left over from a previous interpreter
+
+static void MonsterArrayDealloc(PyObject* self)
+{
+    MonsterArrayObject* array = (MonsterArrayObject*)self;
+    PyMem_Free(array->values);
+    Py_TYPE(self)->tp_free(self);
+}
+
+static int MonsterArrayGetBuffer(PyObject* self, Py_buffer* view, int flags)
+{
+    MonsterArrayObject* array = (MonsterArrayObject*)self;
+    if (flags & PyBUF_WRITABLE)
+    {
+        PyErr_SetString(PyExc_BufferError, "visibleMonsters is read-only");
+        view->obj = NULL;
+        return -1;
+    }
+
+    array->shape[0] = array->count;
+    array->shape[1] = MONSTER_COLUMN_COUNT;
+    array->strides[0] = (Py_ssize_t)(sizeof(float) * MONSTER_COLUMN_COUNT);
+    array->strides[1] = (Py_ssize_t)sizeof(float);
+
+    view->buf = array->values;
+    view->obj = Py_NewRef(self);
+    view->len = array->count * MONSTER_COLUMN_COUNT * (Py_ssize_t)sizeof(float);
+    view->readonly = 1;
+    view->itemsize = (Py_ssize_t)sizeof(float);
+    view->format = (flags & PyBUF_FORMAT) ? "f" : NULL;
+    view->ndim = 2;
+    view->shape = (flags & PyBUF_ND) ? array->shape : NULL;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? array->strides : NULL;
+    view->suboffsets = NULL;
+    view->internal = NULL;
+    array->exports++;
+    return 0;
+}
+
+static void MonsterArrayReleaseBuffer(PyObject* self, Py_buffer* view)
+{
+    (void)view;
+    ((MonsterArrayObject*)self)->exports--;
+}
+
+static Py_ssize_t MonsterArrayLength(PyObject* self)
+{
+    return ((MonsterArrayObject*)self)->count;
+}
+
+static PyObject* BuildVectorDict(const float x, const float y)
+{
+    return Py_BuildValue("{s:f,s:f}", "x", (double)x, "y", (double)y);
+}
+
+// Rows are only turned into dicts when a script indexes them, for compatibility with the list-of-dicts API
+static PyObject* MonsterArrayItem(PyObject* self, const Py_ssize_t index)
+{
+    MonsterArrayObject* array = (MonsterArrayObject*)self;
+    if (index < 0 || index >= array->count)
+    {
+        PyErr_SetString(PyExc_IndexError, "monster index out of range");
+        return NULL;
+    }
+
+    const float* row = &array->values[index * MONSTER_COLUMN_COUNT];
+    PyObject* position = BuildVectorDict(row[MONSTER_COLUMN_X], row[MONSTER_COLUMN_Y]);
+    if (!position)
+        return NULL;
+
+    return Py_BuildValue("{s:N,s:f,s:f,s:O,s:f,s:f,s:f}",
+        "position", position,
+        "size", (double)row[MONSTER_COLUMN_SIZE],
+        "health", (double)row[MONSTER_COLUMN_HEALTH],
+        "invincible", row[MONSTER_COLUMN_INVINCIBLE] != 0.0f ? Py_True : Py_False,
+        "distance", (double)row[MONSTER_COLUMN_DISTANCE],
+        "bearing", (double)row[MONSTER_COLUMN_BEARING],
+        "relativeAngle", (double)row[MONSTER_COLUMN_RELATIVE_ANGLE]);
+}
+
+static PyBufferProcs g_monsterArrayBufferProcs = {
+    .bf_getbuffer = MonsterArrayGetBuffer,
+    .bf_releasebuffer = MonsterArrayReleaseBuffer,
+};
+
+static PySequenceMethods g_monsterArraySequenceMethods = {
+    .sq_length = MonsterArrayLength,
+    .sq_item = MonsterArrayItem,
+};
+
+static PyTypeObject g_monsterArrayType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "player_ai_c.MonsterArray",
+    .tp_doc = "Visible monsters, nearest first, as a read-only float32 (count, 8) buffer: "
+              "x, y, size, health, invincible, distance, bearing, relativeAngle",
+    .tp_basicsize = sizeof(MonsterArrayObject),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_dealloc = MonsterArrayDealloc,
+    .tp_as_buffer = &g_monsterArrayBufferProcs,
+    .tp_as_sequence = &g_monsterArraySequenceMethods,
+};
+
+static MonsterArrayObject* NewMonsterArray(const Py_ssize_t capacity)
+{
+    MonsterArrayObject* array = PyObject_New(MonsterArrayObject, &g_monsterArrayType);
+    if (!array)
+        return NULL;
+
+    array->values = PyMem_Calloc((size_t)capacity * MONSTER_COLUMN_COUNT, sizeof(float));
+    array->count = 0;
+    array->capacity = capacity;
+    array->exports = 0;
+    if (!array->values)
+    {
+        Py_DECREF(array);
+        PyErr_NoMemory();
+        return NULL;
+    }
+    return array;
+}
+
+// Writes this tick's monsters into the thread's array. An array that a script still holds a view of, or that is
+// too small, is left to its owners and replaced by a new one.
+static bool WriteMonsterArray(PythonAIThreadState* state, const PlayerContext* context)
+{
+    MonsterArrayObject* array = state->monsters;
+    if (array->exports > 0 || array->capacity < context->visibleMonsterCount)
+    {
+        Py_ssize_t capacity = array->capacity;
+        while (capacity < context->visibleMonsterCount)
+            capacity *= 2;
+
+        MonsterArrayObject* replacement = NewMonsterArray(capacity);
+        if (!replacement)
+            return false;
+        if (PyDict_SetItemString(state->context, "visibleMonsters", (PyObject*)replacement) < 0)
+        {
+            Py_DECREF(replacement);
+            return false;
+        }
+        Py_SETREF(state->monsters, replacement);
+        array = replacement;
+    }
+
+    for (int i = 0; i < context->visibleMonsterCount; i++)
+    {
+        const MonsterView* view = &context->visibleMonsters[i];
+        float* row = &array->values[i * MONSTER_COLUMN_COUNT];
+        row[MONSTER_COLUMN_X] = view->position.x;
+        row[MONSTER_COLUMN_Y] = view->position.y;
+        row[MONSTER_COLUMN_SIZE] = view->size;
+        row[MONSTER_COLUMN_HEALTH] = view->health;
+        row[MONSTER_COLUMN_INVINCIBLE] = view->invincible ? 1.0f : 0.0f;
+        row[MONSTER_COLUMN_DISTANCE] = view->distance;
+        row[MONSTER_COLUMN_BEARING] = view->bearing;
+        row[MONSTER_COLUMN_RELATIVE_ANGLE] = view->relativeAngle;
+    }
+    array->count = context->visibleMonsterCount;
+    return true;
+}
+
+static bool SetFloatItem(PyObject* dict, const char* key, const float value)
+{
+    PyObject* number = PyFloat_FromDouble((double)value);
+    if (!number)
+        return false;
+    const int result = PyDict_SetItemString(dict, key, number);
+    Py_DECREF(number);
+    return result == 0;
+}
+
+static bool SetIntItem(PyObject* dict, const char* key, const int value)
+{
+    PyObject* number = PyLong_FromLong(value);
+    if (!number)
+        return false;
+    const int result = PyDict_SetItemString(dict, key, number);
+    Py_DECREF(number);
+    return result == 0;
+}
+
+static void ClearThreadState(PythonAIThreadState* state)
+{
+    Py_CLEAR(state->context);
+    Py_CLEAR(state->playerPosition);
+    Py_CLEAR(state->playerVelocity);
+    Py_CLEAR(state->monsters);
+}
+
+static PythonAIThreadState* GetThreadState(void)
+{
+    PythonAIThreadState* state = &g_threadState;
+    if (g_threadStateGeneration == g_interpreterGeneration && state->context)
+        return state;
+
+    // Objects from a finalized interpreter are gone with it, so they are forgotten rather than released
+    memset(state, 0, sizeof(*state));
+    g_threadStateGeneration = g_interpreterGeneration;
+
+    state->context = PyDict_New();
+    state->playerPosition = PyDict_New();
+    state->playerVelocity = PyDict_New();
+    state->monsters = NewMonsterArray(MONSTER_ARRAY_INITIAL_CAPACITY);
+    if (!state->context || !state->playerPosition || !state->playerVelocity || !state->monsters ||
+        PyDict_SetItemString(state->context, "playerPosition", state->playerPosition) < 0 ||
+        PyDict_SetItemString(state->context, "playerVelocity", state->playerVelocity) < 0 ||
+        PyDict_SetItemString(state->context, "visibleMonsters", (PyObject*)state->monsters) < 0)
+    {
+        ClearThreadState(state);
+        return NULL;
+    }
+    return state;
+}
+
+static bool WriteContext(PythonAIThreadState* state, const PlayerContext* context)
+{
+    return SetFloatItem(state->playerPosition, "x", context->playerPosition.x) &&
+           SetFloatItem(state->playerPosition, "y", context->playerPosition.y) &&
+           SetFloatItem(state->playerVelocity, "x", context->playerVelocity.x) &&
+           SetFloatItem(state->playerVelocity, "y", context->playerVelocity.y) &&
+           SetFloatItem(state->context, "playerRotation", context->playerRotation) &&
+           SetFloatItem(state->context, "deltaTime", context->deltaTime) &&
+           SetIntItem(state->context, "visibleMonsterCount", context->visibleMonsterCount) &&
+           WriteMonsterArray(state, context);
+}
+
+static PyObject* PythonShoot(PyObject* self, PyObject* args)
+{
+    (void)self;
+    int direction;
+    if (!PyArg_ParseTuple(args, "i", &direction))
+        return NULL;
+    if (direction < SHOOT_FORWARD || direction > SHOOT_RIGHT)
+    {
+        PyErr_SetString(PyExc_ValueError, "direction must be 0 (forward), 1 (left) or 2 (right)");
+        return NULL;
+    }
+
+    if (g_pythonControl)
+        PlayerControlShoot(g_pythonControl, (ShootDirection)direction);
+    Py_RETURN_NONE;
+}
+
+static PyObject* PythonSetThrusters(PyObject* self, PyObject* args)
+{
+    (void)self;
+    float leftPower;
+    float rightPower;
+    if (!PyArg_ParseTuple(args, "ff", &leftPower, &rightPower))
+        return NULL;
+
+    if (g_pythonControl)
+        PlayerControlSetThrusters(g_pythonControl, leftPower, rightPower);
+    Py_RETURN_NONE;
+}
+
+// [{'monster': index in visibleMonsters or None, 'distance': ..., 'timeToImpact': ...}, ...]
+static PyObject* BuildRayHitList(const PlayerControl* control, const PlayerRayHit* hits, const int count)
+{
+    PyObject* list = PyList_New(count);
+    if (!list)
+        return NULL;
+
+    // Hits point into the distance-sorted list, which the nearest monster query returns from its start
+    const MonsterView* visibleMonsters = NULL;
+    PlayerControlGetNearestMonsters(control, 1, &visibleMonsters);
+
+    for (int i = 0; i < count; i++)
+    {
+        PyObject* monster = hits[i].monster
+            ? PyLong_FromLong((long)(hits[i].monster - visibleMonsters))
+            : Py_NewRef(Py_None);
+        PyObject* hit = monster
+            ? Py_BuildValue("{s:N,s:d,s:d}", "monster", monster, "distance", (double)hits[i].distance, "timeToImpact", (double)hits[i].timeToImpact)
+            : NULL;
+        if (!hit)
+        {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, i, hit);
+    }
+    return list;
+}
+
+static PyObject* PythonCastRays(PyObject* self, PyObject* args)
+{
+    (void)self;
+    PyObject* angleSequence;
+    if (!PyArg_ParseTuple(args, "O", &angleSequence))
+        return NULL;
+
+    PyObject* angleList = PySequence_Fast(angleSequence, "angles must be a sequence of numbers");
+    if (!angleList)
+        return NULL;
+
+    const int rayCount = (int)PySequence_Fast_GET_SIZE(angleList);
+    if (!g_pythonControl)
+    {
+        Py_DECREF(angleList);
+        return PyList_New(0);
+    }
+
+    float* angles = PlayerControlAllocate(g_pythonControl, sizeof(float) * (size_t)rayCount);
+    PlayerRayHit* hits = PlayerControlAllocate(g_pythonControl, sizeof(PlayerRayHit) * (size_t)rayCount);
+    if (!angles || !hits)
+    {
+        Py_DECREF(angleList);
+        return PyErr_NoMemory();
+    }
+
+    for (int i = 0; i < rayCount; i++)
+    {
+        angles[i] = (float)PyFloat_AsDouble(PySequence_Fast_GET_ITEM(angleList, i));
+        if (PyErr_Occurred())
+        {
+            Py_DECREF(angleList);
+            return NULL;
+        }
+    }
+    Py_DECREF(angleList);
+
+    PlayerControlCastRays(g_pythonControl, angles, rayCount, hits);
+    return BuildRayHitList(g_pythonControl, hits, rayCount);
+}
+
+static PyObject* PythonCastShots(PyObject* self, PyObject* args)
+{
+    (void)self;
+    (void)args;
+    if (!g_pythonControl)
+        return PyList_New(0);
+
+    PlayerRayHit hits[SHOOT_DIRECTION_COUNT];
+    PlayerControlCastShots(g_pythonControl, hits);
+    return BuildRayHitList(g_pythonControl, hits, SHOOT_DIRECTION_COUNT);
+}
+
+// forecast([(left, right, shoot, direction), ...]) -> {'position': {...}, 'velocity': {...}, 'rotation': ..., ...}
+static PyObject* PythonForecast(PyObject* self, PyObject* args)
+{
+    (void)self;
+    PyObject* inputSequence;
+    if (!PyArg_ParseTuple(args, "O", &inputSequence))
+        return NULL;
+
+    PyObject* inputList = PySequence_Fast(inputSequence, "commands must be a sequence of (left, right, shoot, direction) tuples");
+    if (!inputList)
+        return NULL;
+
+    const int tickCount = (int)PySequence_Fast_GET_SIZE(inputList);
+    if (!g_pythonControl)
+    {
+        Py_DECREF(inputList);
+        Py_RETURN_NONE;
+    }
+
+    PlayerInput* inputs = PlayerControlAllocate(g_pythonControl, sizeof(PlayerInput) * (size_t)tickCount);
+    if (!inputs)
+    {
+        Py_DECREF(inputList);
+        return PyErr_NoMemory();
+    }
+
+    for (int i = 0; i < tickCount; i++)
+    {
+        int shoot = 0;
+        int direction = SHOOT_FORWARD;
+        if (!PyArg_ParseTuple(PySequence_Fast_GET_ITEM(inputList, i), "ff|pi", &inputs[i].leftThruster, &inputs[i].rightThruster, &shoot, &direction))
+        {
+            Py_DECREF(inputList);
+            return NULL;
+        }
+        if (direction < SHOOT_FORWARD || direction > SHOOT_RIGHT)
+        {
+            Py_DECREF(inputList);
+            PyErr_SetString(PyExc_ValueError, "direction must be 0 (forward), 1 (left) or 2 (right)");
+            return NULL;
+        }
+        inputs[i].shoot = shoot != 0;
+        inputs[i].shootDirection = (ShootDirection)direction;
+    }
+    Py_DECREF(inputList);
+
+    PlayerForecastResult forecast;
+    if (!PlayerControlForecast(g_pythonControl, inputs, tickCount, &forecast))
+        return PyErr_NoMemory();
+
+    return Py_BuildValue("{s:N,s:N,s:d,s:d,s:d,s:i,s:i}",
+        "position", BuildVectorDict(forecast.position.x, forecast.position.y),
+        "velocity", BuildVectorDict(forecast.velocity.x, forecast.velocity.y),
+        "rotation", (double)forecast.rotation,
+        "health", (double)forecast.health,
+        "damageDealt", (double)forecast.damageDealt,
+        "monstersDestroyed", forecast.monstersDestroyed,
+        "ticks", forecast.ticks);
+}
+
+static PyMethodDef g_playerAIMethods[] = {
+    {"shoot", PythonShoot, METH_VARARGS, "shoot(direction): 0 = forward, 1 = left, 2 = right"},
+    {"set_thrusters", PythonSetThrusters, METH_VARARGS, "set_thrusters(left, right): powers from -1.0 to 1.0"},
+    {"cast_rays", PythonCastRays, METH_VARARGS, "cast_rays(angles): what a projectile fired at each angle (degrees) would hit first"},
+    {"cast_shots", PythonCastShots, METH_NOARGS, "cast_shots(): cast_rays for the forward, left and right shot directions"},
+    {"forecast", PythonForecast, METH_VARARGS, "forecast(commands): where (left, right[, shoot, direction]) per tick would leave the ship"},
+    {NULL, NULL, 0, NULL}
+};
+
+static struct PyModuleDef g_playerAIModule = {
+    PyModuleDef_HEAD_INIT,
+    .m_name = "player_ai_c",
+    .m_doc = "Ship controls for on_player_update",
+    .m_size = -1,
+    .m_methods = g_playerAIMethods,
+};
+
+static PyObject* InitPlayerAIModule(void)
+{
+    if (PyType_Ready(&g_monsterArrayType) < 0)
+        return NULL;
+
+    PyObject* module = PyModule_Create(&g_playerAIModule);
+    if (!module)
+        return NULL;
+
+    if (PyModule_AddIntConstant(module, "SHOOT_FORWARD", SHOOT_FORWARD) < 0 ||
+        PyModule_AddIntConstant(module, "SHOOT_LEFT", SHOOT_LEFT) < 0 ||
+        PyModule_AddIntConstant(module, "SHOOT_RIGHT", SHOOT_RIGHT) < 0 ||
+        PyModule_AddIntConstant(module, "MONSTER_X", MONSTER_COLUMN_X) < 0 ||
+        PyModule_AddIntConstant(module, "MONSTER_Y", MONSTER_COLUMN_Y) < 0 ||
+        PyModule_AddIntConstant(module, "MONSTER_SIZE", MONSTER_COLUMN_SIZE) < 0 ||
+        PyModule_AddIntConstant(module, "MONSTER_HEALTH", MONSTER_COLUMN_HEALTH) < 0 ||
+        PyModule_AddIntConstant(module, "MONSTER_INVINCIBLE", MONSTER_COLUMN_INVINCIBLE) < 0 ||
+        PyModule_AddIntConstant(module, "MONSTER_DISTANCE", MONSTER_COLUMN_DISTANCE) < 0 ||
+        PyModule_AddIntConstant(module, "MONSTER_BEARING", MONSTER_COLUMN_BEARING) < 0 ||
+        PyModule_AddIntConstant(module, "MONSTER_RELATIVE_ANGLE", MONSTER_COLUMN_RELATIVE_ANGLE) < 0 ||
+        PyModule_AddObjectRef(module, "MonsterArray", (PyObject*)&g_monsterArrayType) < 0)
+    {
+        Py_DECREF(module);
+        return NULL;
+    }
+    return module;
+}
+
+// Runs the script as __main__ with its directory on sys.path, so it can import its own helpers
+static bool LoadPythonScript(const char* scriptPath)
+{
+    FILE* file = fopen(scriptPath, "rb");
+    if (!file)
+    {
+        fprintf(stderr, "Error: cannot open Python AI script %s\n", scriptPath);
+        return false;
+    }
+
+    char command[] = "import os, sys\nsys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))\n";
+    PyObject* mainModule = PyImport_AddModule("__main__"); // Borrowed
+    PyObject* globals = mainModule ? PyModule_GetDict(mainModule) : NULL;
+    PyObject* fileName = PyUnicode_DecodeFSDefault(scriptPath);
+    bool loaded = globals && fileName && PyDict_SetItemString(globals, "__file__", fileName) == 0;
+    Py_XDECREF(fileName);
+
+    if (loaded)
+    {
+        PyObject* result = PyRun_String(command, Py_file_input, globals, globals);
+        loaded = result != NULL;
+        Py_XDECREF(result);
+    }
+
+    if (loaded)
+    {
+        PyObject* result = PyRun_FileEx(file, scriptPath, Py_file_input, globals, globals, 1);
+        file = NULL;
+        loaded = result != NULL;
+        Py_XDECREF(result);
+    }
+
+    if (file)
+        fclose(file);
+
+    if (loaded)
+    {
+        g_updateFunction = PyDict_GetItemString(globals, "on_player_update"); // Borrowed
+        if (!g_updateFunction || !PyCallable_Check(g_updateFunction))
+        {
+            fprintf(stderr, "Error: %s does not define on_player_update(context)\n", scriptPath);
+            g_updateFunction = NULL;
+            return false;
+        }
+        Py_INCREF(g_updateFunction);
+    }
+    else
+    {
+        PyErr_Print();
+    }
+    return loaded;
+}
+
+bool InitPythonAI(const char* scriptPath)
+{
+    if (g_pythonAIInitialized)
+    {
+        return true;
+    }
+
+    if (!scriptPath)
+    {
+        scriptPath = "player_ai.py";
+    }
+
+    if (PyImport_AppendInittab("player_ai_c", InitPlayerAIModule) < 0)
+    {
+        return false;
+    }
+    Py_InitializeEx(0);
+    g_interpreterGeneration++;
+
+    if (!LoadPythonScript(scriptPath))
+    {
+        Py_FinalizeEx();
+        return false;
+    }
+
+    g_mainThreadState = PyEval_SaveThread();
+    g_pythonAIInitialized = true;
+    return true;
+}
+
+// Must be called from the thread that called InitPythonAI, once no OnPlayerUpdate is running
+void CleanupPythonAI(void)
+{
+    if (!g_pythonAIInitialized)
+    {
+        return;
+    }
+
+    PyEval_RestoreThread(g_mainThreadState);
+    ClearThreadState(&g_threadState);
+    Py_CLEAR(g_updateFunction);
+    Py_FinalizeEx();
+    g_mainThreadState = NULL;
+    g_pythonAIInitialized = false;
+}
+
+void OnPlayerUpdate(PlayerContext context)
+{
+    if (!g_pythonAIInitialized)
+    {
+        return;
+    }
+
+    const PyGILState_STATE gil = PyGILState_Ensure();
+
+    PythonAIThreadState* state = GetThreadState();
+    if (state && WriteContext(state, &context))
+    {
+        g_pythonControl = context.control;
+        PyObject* result = PyObject_CallOneArg(g_updateFunction, state->context);
+        g_pythonControl = NULL;
+        Py_XDECREF(result);
+    }
+
+    if (PyErr_Occurred())
+    {
+        PyErr_Print();
+    }
+
+    PyGILState_Release(gil);
+}
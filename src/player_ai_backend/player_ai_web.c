@@ -3,12 +3,52 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #ifdef PLATFORM_WEB
 #include <emscripten.h>
 #endif
 
+// Fixed binary layout shared with the web AI worker: AIChannel in web/ai_channel.js and _HEADER_WORDS,
+// _MONSTER_WORDS and the word indices in web/player_ai_worker.js must match it. The page hands the block to the
+// worker's Python (through the shared channel, or a message without SharedArrayBuffer) and copies the newest
+// commands the worker has published back into it, so nothing is parsed per tick.
+typedef struct WebAIMonster
+{
+    float positionX;
+    float positionY;
+    float size;
+    float health;
+    float invincible;   // 1.0 or 0.0
+    float distance;
+    float bearing;
+    float relativeAngle;
+} WebAIMonster;
+
+typedef struct WebAIContextBlock
+{
+    float playerPositionX;      // word 0
+    float playerPositionY;
+    float playerVelocityX;
+    float playerVelocityY;
+    float playerRotation;
+    float deltaTime;            // word 5
+    int32_t visibleMonsterCount;
+    int32_t monsterCapacity;
+    int32_t commandFlags;       // word 8, WEB_AI_COMMAND_* bits set by Python
+    float leftThruster;
+    float rightThruster;
+    int32_t shootDirection;     // word 11
+    int32_t reserved[4];
+    WebAIMonster monsters[];    // Starts at word 16
+} WebAIContextBlock;
+
+#define WEB_AI_COMMAND_THRUSTERS 1
+#define WEB_AI_COMMAND_SHOOT 2
+#define WEB_AI_INITIAL_MONSTER_CAPACITY 64
+
 static bool g_webAIInitialized = false;
 static char* g_userPythonCode = NULL;
+static WebAIContextBlock* g_contextBlock = NULL;
 
 #ifdef PLATFORM_WEB
 // JavaScript functions exposed to C
@@ -25,90 +65,78 @@ EM_JS(void, js_load_python_code, (const char* code), {
     }
 });
 
-EM_JS(void, js_call_python_update, (const char* contextJson), {
-    const jsonStr = UTF8ToString(contextJson);
-    if (typeof window.callPythonUpdate === 'function') {
-        window.callPythonUpdate(jsonStr);
-    }
-});
-
-EM_JS(void, js_set_thrusters, (float left, float right), {
-    if (typeof window.setThrusters === 'function') {
-        window.setThrusters(left, right);
+// Views over the context block are rebuilt only when the block moves or wasm memory grows
+EM_JS(void, js_call_python_update, (void* block, int wordCount), {
+    let views = Module.aiContextViews;
+    if (!views || views.ptr !== block || views.wordCount !== wordCount || views.floats.buffer !== HEAPF32.buffer) {
+        views = {
+            ptr: block,
+            wordCount: wordCount,
+            floats: HEAPF32.subarray(block >> 2, (block >> 2) + wordCount),
+            ints: HEAP32.subarray(block >> 2, (block >> 2) + wordCount)
+        };
+        Module.aiContextViews = views;
+        if (typeof window.bindPythonContext === 'function') {
+            window.bindPythonContext(views.floats, views.ints);
+        }
     }
-});
-
-EM_JS(void, js_shoot, (int direction), {
-    if (typeof window.shoot === 'function') {
-        window.shoot(direction);
+    if (typeof window.callPythonUpdate === 'function') {
+        window.callPythonUpdate();
     }
 });
+#endif // PLATFORM_WEB
 
-// Functions called from JavaScript
-EMSCRIPTEN_KEEPALIVE
-void web_player_shoot(int direction)
+static int GetContextBlockWordCount(const int monsterCapacity)
 {
-    // printf("web_player_shoot called with direction: %d\n", direction);
-    if (direction < 0 || direction > 2)
-    {
-        return;
-    }
-    PlayerShoot((ShootDirection)direction);
+    return (int)((sizeof(WebAIContextBlock) + sizeof(WebAIMonster) * (size_t)monsterCapacity) / sizeof(int32_t));
 }
 
-EMSCRIPTEN_KEEPALIVE
-void web_player_set_thrusters(float leftPower, float rightPower)
+static bool ReserveContextBlock(const int monsterCount)
 {
-    PlayerSetThrusters(leftPower, rightPower);
+    if (g_contextBlock && g_contextBlock->monsterCapacity >= monsterCount)
+        return true;
+
+    int capacity = g_contextBlock ? g_contextBlock->monsterCapacity * 2 : WEB_AI_INITIAL_MONSTER_CAPACITY;
+    if (capacity < monsterCount)
+        capacity = monsterCount;
+
+    WebAIContextBlock* block = (WebAIContextBlock*)realloc(g_contextBlock, sizeof(int32_t) * (size_t)GetContextBlockWordCount(capacity));
+    if (!block)
+        return false;
+
+    block->monsterCapacity = capacity;
+    g_contextBlock = block;
+    return true;
 }
-#endif // PLATFORM_WEB
 
-static char* ContextToJSON(PlayerContext* context)
+static void WriteContextBlock(WebAIContextBlock* block, const PlayerContext* context)
 {
-    // Estimate buffer size (should be enough for typical data)
-    const size_t bufferSize = 4096; // should be enough
-    char* json = (char*)malloc(bufferSize);
-    if (!json) return NULL;
-    
-    int written = snprintf(json, bufferSize,
-        "{"
-        "\"playerPosition\":{\"x\":%.2f,\"y\":%.2f},"
-        "\"playerVelocity\":{\"x\":%.2f,\"y\":%.2f},"
-        "\"playerRotation\":%.2f,"
-        "\"deltaTime\":%.4f,"
-        "\"visibleMonsterCount\":%d,"
-        "\"visibleMonsters\":[",
-        context->playerPosition.x, context->playerPosition.y,
-        context->playerVelocity.x, context->playerVelocity.y,
-        context->playerRotation,
-        context->deltaTime,
-        context->visibleMonsterCount
-    );
-    
+    block->playerPositionX = context->playerPosition.x;
+    block->playerPositionY = context->playerPosition.y;
+    block->playerVelocityX = context->playerVelocity.x;
+    block->playerVelocityY = context->playerVelocity.y;
+    block->playerRotation = context->playerRotation;
+    block->deltaTime = context->deltaTime;
+    block->visibleMonsterCount = context->visibleMonsterCount;
+    block->commandFlags = 0;
+
     for (int i = 0; i < context->visibleMonsterCount; i++)
     {
-        if (i > 0)
-        {
-            written += snprintf(json + written, bufferSize - written, ",");
-        }
-        written += snprintf(json + written, bufferSize - written,
-            "{"
-            "\"position\":{\"x\":%.2f,\"y\":%.2f},"
-            "\"size\":%.2f,"
-            "\"health\":%.2f,"
-            "\"invincible\":%s"
-            "}",
-            context->visibleMonsters[i].position.x,
-            context->visibleMonsters[i].position.y,
-            context->visibleMonsters[i].size,
-            context->visibleMonsters[i].health,
-            context->visibleMonsters[i].invincible ? "true" : "false"
-        );
+        const MonsterView* view = &context->visibleMonsters[i];
+        block->monsters[i] = (WebAIMonster){
+            view->position.x, view->position.y, view->size, view->health, view->invincible ? 1.0f : 0.0f,
+            view->distance, view->bearing, view->relativeAngle
+        };
     }
-    
-    written += snprintf(json + written, bufferSize - written, "]}");
-    
-    return json;
+}
+
+static void ApplyContextBlockCommands(const WebAIContextBlock* block, PlayerControl* control)
+{
+    if (block->commandFlags & WEB_AI_COMMAND_THRUSTERS)
+        PlayerControlSetThrusters(control, block->leftThruster, block->rightThruster);
+
+    if ((block->commandFlags & WEB_AI_COMMAND_SHOOT) && block->shootDirection >= 0 && block->shootDirection <= 2)
+        PlayerControlShoot(control, (ShootDirection)block->shootDirection);
 }
 
 bool InitPythonAI(const char* scriptPath)
@@ -117,7 +145,7 @@ bool InitPythonAI(const char* scriptPath)
     {
         return true;
     }
-    
+
 #ifdef PLATFORM_WEB
     // Initialize Pyodide in JavaScript
     js_init_pyodide();
@@ -125,7 +153,7 @@ bool InitPythonAI(const char* scriptPath)
     // Not a web build - this shouldn't be called
     return false;
 #endif
-    
+
     // For web, we don't load from file - user provides code via UI
     // But we can load default code if provided
     if (scriptPath)
@@ -134,7 +162,7 @@ bool InitPythonAI(const char* scriptPath)
         // For now, we'll just mark as initialized
         // The actual code loading happens via JavaScript
     }
-    
+
     g_webAIInitialized = true;
     return true;
 }
@@ -146,6 +174,8 @@ void CleanupPythonAI(void)
         free(g_userPythonCode);
         g_userPythonCode = NULL;
     }
+    free(g_contextBlock);
+    g_contextBlock = NULL;
     g_webAIInitialized = false;
 }
 
@@ -155,20 +185,21 @@ void OnPlayerUpdate(PlayerContext context)
     {
         return;
     }
-    
-    // Convert context to JSON
-    char* contextJson = ContextToJSON(&context);
-    if (!contextJson)
+
+    if (!ReserveContextBlock(context.visibleMonsterCount))
     {
         return;
     }
-    
+
+    WriteContextBlock(g_contextBlock, &context);
+
 #ifdef PLATFORM_WEB
-    // Call JavaScript function which will use Pyodide to execute Python
-    js_call_python_update(contextJson);
+    // Hands the context to the worker and writes the newest commands it has published into the block. Python runs
+    // asynchronously, so these may answer an earlier tick's context.
+    js_call_python_update(g_contextBlock, GetContextBlockWordCount(g_contextBlock->monsterCapacity));
 #endif
-    
-    free(contextJson);
+
+    ApplyContextBlockCommands(g_contextBlock, context.control);
 }
 
 #ifdef PLATFORM_WEB
@@ -0,0 +1,180 @@
+#if !defined(_WIN32) && !defined(PLATFORM_WEB)
+#define _POSIX_C_SOURCE 200809L
+#define PLAYER_AI_LIBRARY_SUPPORTED
+#endif
+
+#include "player_ai_library.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef PLAYER_AI_LIBRARY_SUPPORTED
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static bool GetLibraryFileInfo(const char* path, long long* modifiedTime, long long* fileSize)
+{
+    struct stat info;
+    if (stat(path, &info) != 0)
+        return false;
+
+#ifdef __APPLE__
+    *modifiedTime = (long long)info.st_mtimespec.tv_sec * 1000000000LL + info.st_mtimespec.tv_nsec;
+#else
+    *modifiedTime = (long long)info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec;
+#endif
+    *fileSize = (long long)info.st_size;
+    return true;
+}
+
+// dlopen returns the already loaded handle for a path it has seen, so every load goes through a fresh copy.
+// The copy is unlinked as soon as it is mapped.
+static bool CopyLibraryFile(const char* path, char* copyPath, const size_t copyPathSize)
+{
+    const char* directory = getenv("TMPDIR");
+    if (!directory || directory[0] == '\0')
+        directory = "/tmp";
+    if (snprintf(copyPath, copyPathSize, "%s/espace-confiote-ai-XXXXXX", directory) >= (int)copyPathSize)
+        return false;
+
+    FILE* source = fopen(path, "rb");
+    if (!source)
+        return false;
+
+    const int copyDescriptor = mkstemp(copyPath);
+    FILE* copy = copyDescriptor >= 0 ? fdopen(copyDescriptor, "wb") : NULL;
+    if (!copy)
+    {
+        if (copyDescriptor >= 0)
+        {
+            close(copyDescriptor);
+            unlink(copyPath);
+        }
+        fclose(source);
+        return false;
+    }
+
+    char buffer[16384];
+    size_t readSize;
+    bool copied = true;
+    while ((readSize = fread(buffer, 1, sizeof(buffer), source)) > 0)
+    {
+        if (fwrite(buffer, 1, readSize, copy) != readSize)
+        {
+            copied = false;
+            break;
+        }
+    }
+    copied = copied && !ferror(source);
+
+    fclose(source);
+    if (fclose(copy) != 0)
+        copied = false;
+    if (!copied)
+        unlink(copyPath);
+    return copied;
+}
+
+static bool OpenLibraryCopy(const char* path, void** outHandle, PlayerUpdateFunction* outUpdate)
+{
+    char copyPath[PLAYER_AI_LIBRARY_PATH_MAX + 64];
+    if (!CopyLibraryFile(path, copyPath, sizeof(copyPath)))
+    {
+        fprintf(stderr, "Error: cannot read AI library %s\n", path);
+        return false;
+    }
+
+    void* handle = dlopen(copyPath, RTLD_NOW | RTLD_LOCAL);
+    unlink(copyPath);
+    if (!handle)
+    {
+        fprintf(stderr, "Error: cannot load AI library %s: %s\n", path, dlerror());
+        return false;
+    }
+
+    void* symbol = dlsym(handle, "OnPlayerUpdate");
+    if (!symbol)
+    {
+        fprintf(stderr, "Error: AI library %s does not export OnPlayerUpdate\n", path);
+        dlclose(handle);
+        return false;
+    }
+
+    *outHandle = handle;
+    memcpy(outUpdate, &symbol, sizeof(*outUpdate)); // ISO C has no object-to-function pointer cast
+    return true;
+}
+
+bool LoadPlayerAILibrary(PlayerAILibrary* library, const char* path)
+{
+    memset(library, 0, sizeof(*library));
+    if (strlen(path) >= sizeof(library->path))
+    {
+        fprintf(stderr, "Error: AI library path too long: %s\n", path);
+        return false;
+    }
+    strcpy(library->path, path);
+
+    if (!GetLibraryFileInfo(path, &library->modifiedTime, &library->fileSize))
+    {
+        fprintf(stderr, "Error: cannot find AI library %s\n", path);
+        return false;
+    }
+    return OpenLibraryCopy(path, &library->handle, &library->update);
+}
+
+void UnloadPlayerAILibrary(PlayerAILibrary* library)
+{
+    if (library->handle)
+        dlclose(library->handle);
+    library->handle = NULL;
+    library->update = NULL;
+}
+
+bool ReloadPlayerAILibraryIfChanged(PlayerAILibrary* library)
+{
+    long long modifiedTime;
+    long long fileSize;
+    if (!GetLibraryFileInfo(library->path, &modifiedTime, &fileSize))
+        return false; // Mid-rebuild, the file can briefly disappear
+
+    if (modifiedTime == library->modifiedTime && fileSize == library->fileSize)
+        return false;
+
+    // A half-written library fails to load; it is retried once the file changes again
+    library->modifiedTime = modifiedTime;
+    library->fileSize = fileSize;
+
+    void* handle;
+    PlayerUpdateFunction update;
+    if (!OpenLibraryCopy(library->path, &handle, &update))
+        return false;
+
+    UnloadPlayerAILibrary(library);
+    library->handle = handle;
+    library->update = update;
+    library->reloadCount++;
+    return true;
+}
+#else
+bool LoadPlayerAILibrary(PlayerAILibrary* library, const char* path)
+{
+    memset(library, 0, sizeof(*library));
+    fprintf(stderr, "Error: AI libraries cannot be loaded on this platform (%s)\n", path);
+    return false;
+}
+
+void UnloadPlayerAILibrary(PlayerAILibrary* library)
+{
+    library->handle = NULL;
+    library->update = NULL;
+}
+
+bool ReloadPlayerAILibraryIfChanged(PlayerAILibrary* library)
+{
+    (void)library;
+    return false;
+}
+#endif // PLAYER_AI_LIBRARY_SUPPORTED
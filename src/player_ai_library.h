@@ -0,0 +1,32 @@
+#ifndef PLAYER_AI_LIBRARY_H
+#define PLAYER_AI_LIBRARY_H
+
+#include <stdbool.h>
+#include "player.h"
+
+#define PLAYER_AI_LIBRARY_PATH_MAX 512
+#define PLAYER_AI_LIBRARY_MAX_LOADED 8  // Libraries the game and the headless CLI accept on the command line
+
+// A player AI built as a shared library exporting OnPlayerUpdate (the player_ai target), loaded with dlopen.
+// Each load works on a private copy of the file, so several libraries, or several versions of one library,
+// can be loaded side by side and the original can be rebuilt while the game runs. Only on POSIX systems;
+// elsewhere loading fails.
+typedef struct PlayerAILibrary
+{
+    char path[PLAYER_AI_LIBRARY_PATH_MAX];
+    void* handle;
+    PlayerUpdateFunction update;
+    long long modifiedTime;     // Of the file last loaded or attempted, in nanoseconds
+    long long fileSize;
+    int reloadCount;
+} PlayerAILibrary;
+
+bool LoadPlayerAILibrary(PlayerAILibrary* library, const char* path);
+void UnloadPlayerAILibrary(PlayerAILibrary* library);
+
+// Loads the library again if its file changed since the last attempt. Returns true when library->update now
+// points to new code; the previous code is unloaded, so callers must swap the function between ticks.
+// A build that fails to load leaves the previous version running.
+bool ReloadPlayerAILibraryIfChanged(PlayerAILibrary* library);
+
+#endif // PLAYER_AI_LIBRARY_H
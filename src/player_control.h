@@ -0,0 +1,26 @@
+#ifndef PLAYER_CONTROL_H
+#define PLAYER_CONTROL_H
+
+#include "player.h"
+#include "frame_arena.h"
+#include "line_of_fire.h"
+#include "random.h"
+
+// Internal to the simulation: player code only holds PlayerControl handles and goes through the API in player.h
+struct PlayerControl // commands issued by player code during one OnPlayerUpdate call
+{
+    const GameState* game;                  // Read by the forecasts only
+    Player* player;
+    FrameArena* frameArena;
+    Random* random;                         // The game's AI stream
+    float deltaTime;
+    const MonsterView* visibleMonsters;     // Sorted by distance, backs the monster queries below
+    int visibleMonsterCount;
+    bool shootRequested;
+    ShootDirection shootDirection;
+    LineOfFireTargets lineOfFire;           // Built on the first ray cast of the tick
+    bool lineOfFireReady;
+    PlayerForecastWorld* forecastWorld;     // Built on the first forecast of the tick
+};
+
+#endif // PLAYER_CONTROL_H
@@ -0,0 +1,150 @@
+#ifdef HEADLESS
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "profiler.h"
+#include <stdlib.h>
+#include <string.h>
+#ifdef HEADLESS
+#include <time.h>
+#else
+#include "raylib.h"
+#endif
+
+static const char* g_phaseNames[PROFILE_PHASE_COUNT] =
+{
+    "update_monsters",
+    "update_player",
+    "proximity_damage",
+    "visible_monsters",
+    "player_ai",
+    "monster_shooting",
+    "projectiles",
+    "effects",
+    "draw_stars",
+    "draw_sprites",
+    "draw_particles",
+    "draw_ui",
+};
+
+// A monotonic clock, so that adjustments of the system time cannot make phases jump or go negative
+static double GetProfilerTime(void)
+{
+#ifdef HEADLESS
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+#else
+    return GetTime();
+#endif
+}
+
+void InitProfiler(Profiler* profiler)
+{
+    memset(profiler, 0, sizeof(*profiler));
+    profiler->frameStart = GetProfilerTime();
+}
+
+bool OpenProfilerCSV(Profiler* profiler, const char* path)
+{
+    FILE* file = fopen(path, "w");
+    if (!file)
+        return false;
+
+    if (profiler->csv)
+        fclose(profiler->csv);
+    profiler->csv = file;
+
+    fprintf(file, "frame,ticks,frame_ms");
+    for (int p = 0; p < PROFILE_PHASE_COUNT; p++)
+        fprintf(file, ",%s_ms", g_phaseNames[p]);
+    fprintf(file, "\n");
+    return true;
+}
+
+void CloseProfiler(Profiler* profiler)
+{
+    if (profiler->csv)
+        fclose(profiler->csv);
+    profiler->csv = NULL;
+}
+
+void BeginProfilerPhase(Profiler* profiler, const ProfilerPhase phase)
+{
+    if (profiler)
+        profiler->phaseStart[phase] = GetProfilerTime();
+}
+
+void EndProfilerPhase(Profiler* profiler, const ProfilerPhase phase)
+{
+    if (profiler)
+        profiler->frameTotals[phase] += GetProfilerTime() - profiler->phaseStart[phase];
+}
+
+void CountProfilerTick(Profiler* profiler)
+{
+    if (profiler)
+        profiler->frameTicks++;
+}
+
+void EndProfilerFrame(Profiler* profiler)
+{
+    if (!profiler)
+        return;
+
+    const double now = GetProfilerTime();
+    const int slot = profiler->historyNext;
+    for (int p = 0; p < PROFILE_PHASE_COUNT; p++)
+        profiler->history[p][slot] = (float)(profiler->frameTotals[p] * 1000.0);
+    profiler->history[PROFILE_PHASE_COUNT][slot] = (float)((now - profiler->frameStart) * 1000.0);
+
+    if (profiler->csv)
+    {
+        fprintf(profiler->csv, "%ld,%d,%.4f", profiler->frameIndex, profiler->frameTicks, profiler->history[PROFILE_PHASE_COUNT][slot]);
+        for (int p = 0; p < PROFILE_PHASE_COUNT; p++)
+            fprintf(profiler->csv, ",%.4f", profiler->history[p][slot]);
+        fprintf(profiler->csv, "\n");
+    }
+
+    profiler->historyNext = (slot + 1) % PROFILER_HISTORY_FRAMES;
+    if (profiler->historyCount < PROFILER_HISTORY_FRAMES)
+        profiler->historyCount++;
+
+    memset(profiler->frameTotals, 0, sizeof(profiler->frameTotals));
+    profiler->frameTicks = 0;
+    profiler->frameIndex++;
+    profiler->frameStart = now;
+}
+
+const char* GetProfilerPhaseName(const int phase)
+{
+    return phase >= 0 && phase < PROFILE_PHASE_COUNT ? g_phaseNames[phase] : "frame";
+}
+
+static int CompareFloats(const void* a, const void* b)
+{
+    const float x = *(const float*)a;
+    const float y = *(const float*)b;
+    return (x > y) - (x < y);
+}
+
+ProfilerStats GetProfilerStats(const Profiler* profiler, const int phase)
+{
+    ProfilerStats stats = { 0.0f, 0.0f };
+    const int count = profiler->historyCount;
+    if (count == 0 || phase < 0 || phase > PROFILE_PHASE_COUNT)
+        return stats;
+
+    float sorted[PROFILER_HISTORY_FRAMES];
+    double sum = 0.0;
+    for (int i = 0; i < count; i++)
+    {
+        sorted[i] = profiler->history[phase][i];
+        sum += sorted[i];
+    }
+    qsort(sorted, (size_t)count, sizeof(float), CompareFloats);
+
+    stats.averageMs = (float)(sum / count);
+    stats.p99Ms = sorted[(count * 99) / 100];
+    return stats;
+}
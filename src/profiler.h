@@ -0,0 +1,66 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+typedef enum ProfilerPhase
+{
+    PROFILE_UPDATE_MONSTERS,
+    PROFILE_UPDATE_PLAYER,
+    PROFILE_PROXIMITY_DAMAGE,
+    PROFILE_VISIBLE_MONSTERS,   // Building the AI's view of the world
+    PROFILE_PLAYER_AI,          // The OnPlayerUpdate call alone
+    PROFILE_MONSTER_SHOOTING,
+    PROFILE_PROJECTILES,
+    PROFILE_EFFECTS,
+    PROFILE_DRAW_STARS,
+    PROFILE_DRAW_SPRITES,
+    PROFILE_DRAW_PARTICLES,
+    PROFILE_DRAW_UI,
+    PROFILE_PHASE_COUNT
+} ProfilerPhase;
+
+#define PROFILER_HISTORY_FRAMES 240
+
+// Time spent in each phase, read from a monotonic clock and summed per rendered frame (a frame runs zero or more
+// simulation ticks). The last PROFILER_HISTORY_FRAMES frames are kept for the overlay; every frame can also be
+// appended to a CSV.
+// Draw phases measure the CPU side only: the GPU work they queue shows up in the frame time.
+typedef struct Profiler
+{
+    double phaseStart[PROFILE_PHASE_COUNT];
+    double frameTotals[PROFILE_PHASE_COUNT];            // Seconds, for the frame in progress
+    float history[PROFILE_PHASE_COUNT + 1][PROFILER_HISTORY_FRAMES]; // Milliseconds; the last row is the whole frame
+    int historyNext;
+    int historyCount;
+    double frameStart;
+    int frameTicks;
+    long frameIndex;
+    FILE* csv;
+    bool overlayVisible;
+} Profiler;
+
+typedef struct ProfilerStats
+{
+    float averageMs;
+    float p99Ms;
+} ProfilerStats;
+
+void InitProfiler(Profiler* profiler);
+// Streams one row per frame to path from now on
+bool OpenProfilerCSV(Profiler* profiler, const char* path);
+void CloseProfiler(Profiler* profiler);
+
+// All of these accept NULL, so callers can leave profiling off without checking
+void BeginProfilerPhase(Profiler* profiler, ProfilerPhase phase);
+void EndProfilerPhase(Profiler* profiler, ProfilerPhase phase);
+void CountProfilerTick(Profiler* profiler);
+void EndProfilerFrame(Profiler* profiler);
+
+// Phase PROFILE_PHASE_COUNT stands for the whole frame in both
+const char* GetProfilerPhaseName(int phase);
+// Over the frames in the history
+ProfilerStats GetProfilerStats(const Profiler* profiler, int phase);
+
+#endif // PROFILER_H
@@ -0,0 +1,318 @@
+#include "projectile_store.h"
+#include "config.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define PROJECTILE_SIMD_AVX
+    #define PROJECTILE_SIMD_WIDTH 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define PROJECTILE_SIMD_SSE
+    #define PROJECTILE_SIMD_WIDTH 4
+#elif defined(__wasm_simd128__)
+    #include <wasm_simd128.h>
+    #define PROJECTILE_SIMD_WASM
+    #define PROJECTILE_SIMD_WIDTH 4
+#else
+    #define PROJECTILE_SIMD_WIDTH 1
+#endif
+
+// Lane lengths are rounded to this many elements so every lane starts on a 32 byte boundary of the block
+#define PROJECTILE_LANE_GRANULARITY 8
+
+size_t GetProjectileBlockSize(const int capacity)
+{
+    return (size_t)capacity * (4 * sizeof(float) + sizeof(int) + sizeof(unsigned char));
+}
+
+void AssignProjectileLanes(ProjectileStore* store, unsigned char* block, const int capacity)
+{
+    store->x = (float*)block;
+    store->y = store->x + capacity;
+    store->velocityX = store->y + capacity;
+    store->velocityY = store->velocityX + capacity;
+    store->monsterIndex = (int*)(store->velocityY + capacity);
+    store->owner = (unsigned char*)(store->monsterIndex + capacity);
+    store->block = block;
+    store->capacity = capacity;
+}
+
+void InitProjectileStoreInBlock(ProjectileStore* store, void* block, const int capacity)
+{
+    memset(store, 0, sizeof(ProjectileStore));
+    AssignProjectileLanes(store, (unsigned char*)block, capacity);
+}
+
+bool InitProjectileStore(ProjectileStore* store, const int capacity)
+{
+    memset(store, 0, sizeof(ProjectileStore));
+    return ReserveProjectiles(store, capacity);
+}
+
+void FreeProjectileStore(ProjectileStore* store)
+{
+    free(store->block);
+    memset(store, 0, sizeof(ProjectileStore));
+}
+
+bool ReserveProjectiles(ProjectileStore* store, int capacity)
+{
+    if (capacity <= store->capacity)
+        return true;
+
+    if (capacity < store->capacity * 2)
+        capacity = store->capacity * 2;
+    capacity = (capacity + PROJECTILE_LANE_GRANULARITY - 1) / PROJECTILE_LANE_GRANULARITY * PROJECTILE_LANE_GRANULARITY;
+
+    unsigned char* block = (unsigned char*)malloc(GetProjectileBlockSize(capacity));
+    if (!block)
+        return false;
+
+    ProjectileStore grown = *store;
+    AssignProjectileLanes(&grown, block, capacity);
+
+    const int count = store->count;
+    if (count > 0)
+    {
+        memcpy(grown.x, store->x, sizeof(float) * count);
+        memcpy(grown.y, store->y, sizeof(float) * count);
+        memcpy(grown.velocityX, store->velocityX, sizeof(float) * count);
+        memcpy(grown.velocityY, store->velocityY, sizeof(float) * count);
+        memcpy(grown.monsterIndex, store->monsterIndex, sizeof(int) * count);
+        memcpy(grown.owner, store->owner, sizeof(unsigned char) * count);
+    }
+
+    free(store->block);
+    *store = grown;
+    return true;
+}
+
+int AddProjectile(ProjectileStore* store, const Vector2 position, const Vector2 velocity, const ProjectileOwner owner, const int monsterIndex)
+{
+    if (store->count >= store->capacity && !ReserveProjectiles(store, store->count + 1))
+        return -1;
+
+    const int index = store->count++;
+    store->snapshotId = 0;
+    store->x[index] = position.x;
+    store->y[index] = position.y;
+    store->velocityX[index] = velocity.x;
+    store->velocityY[index] = velocity.y;
+    store->owner[index] = (unsigned char)owner;
+    store->monsterIndex[index] = monsterIndex;
+    if (owner == PROJECTILE_PLAYER)
+        store->playerCount++;
+    return index;
+}
+
+int FireProjectile(ProjectileStore* store, const float angleInDegrees, const Vector2 position, const ProjectileOwner owner, const int monsterIndex)
+{
+    const float angleInRadians = angleInDegrees * DEG2RAD;
+    const float dx = cosf(angleInRadians);
+    const float dy = sinf(angleInRadians);
+
+    const Vector2 velocity = { dx * PROJECTILE_SPEED, dy * PROJECTILE_SPEED };
+    return AddProjectile(store, position, velocity, owner, monsterIndex);
+}
+
+void CopyProjectiles(ProjectileStore* destination, const ProjectileStore* source)
+{
+    const size_t count = (size_t)source->count;
+    memcpy(destination->x, source->x, sizeof(float) * count);
+    memcpy(destination->y, source->y, sizeof(float) * count);
+    memcpy(destination->velocityX, source->velocityX, sizeof(float) * count);
+    memcpy(destination->velocityY, source->velocityY, sizeof(float) * count);
+    memcpy(destination->monsterIndex, source->monsterIndex, sizeof(int) * count);
+    memcpy(destination->owner, source->owner, sizeof(unsigned char) * count);
+    destination->count = source->count;
+    destination->playerCount = source->playerCount;
+    destination->snapshotId = 0;
+}
+
+void MoveProjectile(ProjectileStore* store, const int from, const int to)
+{
+    if (from == to)
+        return;
+
+    store->x[to] = store->x[from];
+    store->y[to] = store->y[from];
+    store->velocityX[to] = store->velocityX[from];
+    store->velocityY[to] = store->velocityY[from];
+    store->owner[to] = store->owner[from];
+    store->monsterIndex[to] = store->monsterIndex[from];
+}
+
+static bool IsPlayerProjectile(const ProjectileStore* store, const int index)
+{
+    return (store->owner[index] & ~PROJECTILE_DEAD_FLAG) == PROJECTILE_PLAYER;
+}
+
+void IntegrateProjectiles(ProjectileStore* store, const float deltaTime)
+{
+    float* x = store->x;
+    float* y = store->y;
+    const float* velocityX = store->velocityX;
+    const float* velocityY = store->velocityY;
+    const int count = store->count;
+    int i = 0;
+    store->snapshotId = 0;
+
+#if defined(PROJECTILE_SIMD_AVX)
+    const __m256 dt = _mm256_set1_ps(deltaTime);
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm256_storeu_ps(x + i, _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_mul_ps(_mm256_loadu_ps(velocityX + i), dt)));
+        _mm256_storeu_ps(y + i, _mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_mul_ps(_mm256_loadu_ps(velocityY + i), dt)));
+    }
+#elif defined(PROJECTILE_SIMD_SSE)
+    const __m128 dt = _mm_set1_ps(deltaTime);
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(_mm_loadu_ps(velocityX + i), dt)));
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(_mm_loadu_ps(velocityY + i), dt)));
+    }
+#elif defined(PROJECTILE_SIMD_WASM)
+    const v128_t dt = wasm_f32x4_splat(deltaTime);
+    for (; i + 4 <= count; i += 4)
+    {
+        wasm_v128_store(x + i, wasm_f32x4_add(wasm_v128_load(x + i), wasm_f32x4_mul(wasm_v128_load(velocityX + i), dt)));
+        wasm_v128_store(y + i, wasm_f32x4_add(wasm_v128_load(y + i), wasm_f32x4_mul(wasm_v128_load(velocityY + i), dt)));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        x[i] += velocityX[i] * deltaTime;
+        y[i] += velocityY[i] * deltaTime;
+    }
+}
+
+void CullProjectilesOutOfBounds(ProjectileStore* store, const Rectangle bounds)
+{
+    const float minX = bounds.x;
+    const float minY = bounds.y;
+    const float maxX = bounds.x + bounds.width;
+    const float maxY = bounds.y + bounds.height;
+    const float* x = store->x;
+    const float* y = store->y;
+    const int count = store->count;
+    int writeIndex = 0;
+    int removedPlayerCount = 0;
+    int i = 0;
+
+#if PROJECTILE_SIMD_WIDTH > 1
+    #if defined(PROJECTILE_SIMD_AVX)
+    const __m256 lowX = _mm256_set1_ps(minX);
+    const __m256 lowY = _mm256_set1_ps(minY);
+    const __m256 highX = _mm256_set1_ps(maxX);
+    const __m256 highY = _mm256_set1_ps(maxY);
+    #elif defined(PROJECTILE_SIMD_WASM)
+    const v128_t lowX = wasm_f32x4_splat(minX);
+    const v128_t lowY = wasm_f32x4_splat(minY);
+    const v128_t highX = wasm_f32x4_splat(maxX);
+    const v128_t highY = wasm_f32x4_splat(maxY);
+    #else
+    const __m128 lowX = _mm_set1_ps(minX);
+    const __m128 lowY = _mm_set1_ps(minY);
+    const __m128 highX = _mm_set1_ps(maxX);
+    const __m128 highY = _mm_set1_ps(maxY);
+    #endif
+
+    for (; i + PROJECTILE_SIMD_WIDTH <= count; i += PROJECTILE_SIMD_WIDTH)
+    {
+    #if defined(PROJECTILE_SIMD_AVX)
+        const __m256 px = _mm256_loadu_ps(x + i);
+        const __m256 py = _mm256_loadu_ps(y + i);
+        const __m256 outside = _mm256_or_ps(
+            _mm256_or_ps(_mm256_cmp_ps(px, lowX, _CMP_LT_OQ), _mm256_cmp_ps(px, highX, _CMP_GT_OQ)),
+            _mm256_or_ps(_mm256_cmp_ps(py, lowY, _CMP_LT_OQ), _mm256_cmp_ps(py, highY, _CMP_GT_OQ)));
+        const int outsideMask = _mm256_movemask_ps(outside);
+    #elif defined(PROJECTILE_SIMD_WASM)
+        const v128_t px = wasm_v128_load(x + i);
+        const v128_t py = wasm_v128_load(y + i);
+        const v128_t outside = wasm_v128_or(
+            wasm_v128_or(wasm_f32x4_lt(px, lowX), wasm_f32x4_gt(px, highX)),
+            wasm_v128_or(wasm_f32x4_lt(py, lowY), wasm_f32x4_gt(py, highY)));
+        const int outsideMask = (int)wasm_i32x4_bitmask(outside);
+    #else
+        const __m128 px = _mm_loadu_ps(x + i);
+        const __m128 py = _mm_loadu_ps(y + i);
+        const __m128 outside = _mm_or_ps(
+            _mm_or_ps(_mm_cmplt_ps(px, lowX), _mm_cmpgt_ps(px, highX)),
+            _mm_or_ps(_mm_cmplt_ps(py, lowY), _mm_cmpgt_ps(py, highY)));
+        const int outsideMask = _mm_movemask_ps(outside);
+    #endif
+
+        // Common case: nothing left the arena and nothing before this block was removed
+        if (outsideMask == 0 && writeIndex == i)
+        {
+            writeIndex += PROJECTILE_SIMD_WIDTH;
+            continue;
+        }
+
+        for (int lane = 0; lane < PROJECTILE_SIMD_WIDTH; lane++)
+        {
+            if (!(outsideMask & (1 << lane)))
+                MoveProjectile(store, i + lane, writeIndex++);
+            else if (IsPlayerProjectile(store, i + lane))
+                removedPlayerCount++;
+        }
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        if (x[i] < minX || x[i] > maxX || y[i] < minY || y[i] > maxY)
+        {
+            if (IsPlayerProjectile(store, i))
+                removedPlayerCount++;
+            continue;
+        }
+        MoveProjectile(store, i, writeIndex++);
+    }
+
+    if (writeIndex != store->count)
+        store->snapshotId = 0;
+    store->count = writeIndex;
+    store->playerCount -= removedPlayerCount;
+}
+
+void RemoveDeadProjectiles(ProjectileStore* store)
+{
+    int writeIndex = 0;
+    int removedPlayerCount = 0;
+    for (int i = 0; i < store->count; i++)
+    {
+        if (!(store->owner[i] & PROJECTILE_DEAD_FLAG))
+            MoveProjectile(store, i, writeIndex++);
+        else if (IsPlayerProjectile(store, i))
+            removedPlayerCount++;
+    }
+    if (writeIndex != store->count)
+        store->snapshotId = 0;
+    store->count = writeIndex;
+    store->playerCount -= removedPlayerCount;
+}
+
+void RecountPlayerProjectiles(ProjectileStore* store)
+{
+    int count = 0;
+    for (int i = 0; i < store->count; i++)
+    {
+        if (IsPlayerProjectile(store, i))
+            count++;
+    }
+    store->playerCount = count;
+}
+
+Color GetProjectileColor(const ProjectileOwner owner)
+{
+    if (owner == PROJECTILE_PLAYER)
+        return PROJECTILE_PLAYER_COLOR;
+    if (owner == PROJECTILE_MONSTER_SPREAD)
+        return PROJECTILE_MONSTER_SPREAD_COLOR;
+    return PROJECTILE_MONSTER_COLOR;
+}
@@ -0,0 +1,60 @@
+#ifndef PROJECTILE_STORE_H
+#define PROJECTILE_STORE_H
+
+#include "raylib.h"
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum ProjectileOwner 
+{
+    PROJECTILE_PLAYER,
+    PROJECTILE_MONSTER,
+    PROJECTILE_MONSTER_SPREAD
+} ProjectileOwner;
+
+// Set in a projectile's owner byte once it has hit something; it is removed by RemoveDeadProjectiles
+#define PROJECTILE_DEAD_FLAG 0x80
+
+// Structure-of-arrays projectile container. Every projectile has the same size (PROJECTILE_SIZE)
+// and its color is derived from its owner, so only the lanes below are stored.
+typedef struct ProjectileStore
+{
+    float* x;
+    float* y;
+    float* velocityX;
+    float* velocityY;
+    unsigned char* owner;   // ProjectileOwner, possibly combined with PROJECTILE_DEAD_FLAG
+    int* monsterIndex;      // Index of the monster that fired it, -1 for the player
+    int count;
+    int playerCount;        // Projectiles owned by the player, kept by AddProjectile, CopyProjectiles and the kernels
+    int capacity;
+    void* block;            // Single allocation holding every lane
+    uint64_t snapshotId;    // Set while the lanes hold exactly what that snapshot captured, 0 once they change.
+                            // AddProjectile and the kernels clear it; code writing the lanes directly must too.
+} ProjectileStore;
+
+bool InitProjectileStore(ProjectileStore* store, int capacity);
+void FreeProjectileStore(ProjectileStore* store);
+bool ReserveProjectiles(ProjectileStore* store, int capacity);
+int AddProjectile(ProjectileStore* store, Vector2 position, Vector2 velocity, ProjectileOwner owner, int monsterIndex);
+// Adds a projectile flying at PROJECTILE_SPEED in the given direction
+int FireProjectile(ProjectileStore* store, float angleInDegrees, Vector2 position, ProjectileOwner owner, int monsterIndex);
+
+// Stores laid out over memory the caller owns (GetProjectileBlockSize(capacity) bytes, 16-byte aligned), such as
+// frame arena scratch. They must never grow or be freed, so callers check the capacity before adding.
+size_t GetProjectileBlockSize(int capacity);
+void InitProjectileStoreInBlock(ProjectileStore* store, void* block, int capacity);
+// The destination must have room for every projectile of the source
+void CopyProjectiles(ProjectileStore* destination, const ProjectileStore* source);
+// For code that writes the owner lane directly
+void RecountPlayerProjectiles(ProjectileStore* store);
+
+// Kernels, vectorized with AVX, SSE2 or WebAssembly SIMD128 when the target supports it.
+// Both keep the remaining projectiles in their original order.
+void IntegrateProjectiles(ProjectileStore* store, float deltaTime);
+void CullProjectilesOutOfBounds(ProjectileStore* store, Rectangle bounds);
+void RemoveDeadProjectiles(ProjectileStore* store);
+
+Color GetProjectileColor(ProjectileOwner owner);
+
+#endif // PROJECTILE_STORE_H
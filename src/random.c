@@ -0,0 +1,63 @@
+#include "random.h"
+
+static uint64_t SplitMix64(uint64_t* state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static uint32_t RotateLeft(const uint32_t value, const int bits)
+{
+    return (value << bits) | (value >> (32 - bits));
+}
+
+void SeedRandom(Random* random, const uint64_t seed, const RandomStream stream)
+{
+    // The stream is scrambled before it is mixed in, so (seed, stream) pairs never alias each other's sequences
+    uint64_t streamState = (uint64_t)stream;
+    uint64_t state = seed ^ SplitMix64(&streamState);
+    const uint64_t low = SplitMix64(&state);
+    const uint64_t high = SplitMix64(&state);
+
+    random->state[0] = (uint32_t)low;
+    random->state[1] = (uint32_t)(low >> 32);
+    random->state[2] = (uint32_t)high;
+    random->state[3] = (uint32_t)(high >> 32);
+    if ((random->state[0] | random->state[1] | random->state[2] | random->state[3]) == 0)
+        random->state[0] = 1;
+}
+
+uint32_t NextRandom(Random* random)
+{
+    uint32_t* s = random->state;
+    const uint32_t result = RotateLeft(s[1] * 5, 7) * 9;
+    const uint32_t t = s[1] << 9;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = RotateLeft(s[3], 11);
+    return result;
+}
+
+float RandomFloat(Random* random)
+{
+    // The top 24 bits fill a float's mantissa exactly
+    return (float)(NextRandom(random) >> 8) * (1.0f / 16777216.0f);
+}
+
+float RandomRange(Random* random, const float min, const float max)
+{
+    return min + RandomFloat(random) * (max - min);
+}
+
+int RandomInt(Random* random, const int min, const int max)
+{
+    // Multiply-shift maps the 32 random bits onto the range; unlike a modulo it does not favor the low values
+    const uint64_t range = (uint64_t)((int64_t)max - (int64_t)min + 1);
+    return (int)((int64_t)min + (int64_t)(((uint64_t)NextRandom(random) * range) >> 32));
+}
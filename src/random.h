@@ -0,0 +1,29 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <stdint.h>
+
+// xoshiro128** generator. Each GameState owns its generators, so simulations running side by side neither share
+// nor lock any hidden state, and a seed always produces the same sequence whatever else runs in the process.
+typedef struct Random
+{
+    uint32_t state[4];
+} Random;
+
+// Independent sequences drawn from one seed
+typedef enum RandomStream
+{
+    RANDOM_STREAM_WORLD,    // World generation
+    RANDOM_STREAM_AI        // Handed to the player AI
+} RandomStream;
+
+void SeedRandom(Random* random, uint64_t seed, RandomStream stream);
+uint32_t NextRandom(Random* random);
+// Uniform in [0, 1)
+float RandomFloat(Random* random);
+// Uniform in [min, max)
+float RandomRange(Random* random, float min, float max);
+// Uniform in [min, max], both included
+int RandomInt(Random* random, int min, int max);
+
+#endif // RANDOM_H
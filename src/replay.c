@@ -0,0 +1,618 @@
+#include "replay.h"
+#include "game.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define REPLAY_MAGIC "ECRP"
+#define REPLAY_VERSION 3
+
+// Tick records are a flags byte below REPLAY_RECORD_KEYFRAME
+#define REPLAY_TICK_SHOOT 0x01
+#define REPLAY_TICK_DIRECTION_SHIFT 1   // Two bits of ShootDirection
+#define REPLAY_TICK_THRUSTERS 0x08      // Followed by the left and right thrusters
+#define REPLAY_TICK_DELTA_TIME 0x10     // Followed by the frame time
+#define REPLAY_RECORD_KEYFRAME 0x80
+#define REPLAY_RECORD_END 0xFF
+
+typedef struct ReplayHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t seed;
+    int32_t keyframeInterval;
+    // The scenario and the effects are dumped as they are laid out in memory; the player and the monsters are
+    // written field by field (see WriteReplayPlayer and WriteReplayMonster)
+    uint32_t scenarioSize;
+    uint32_t hitEffectSize;
+    uint32_t deathExplosionSize;
+} ReplayHeader;
+
+static void WriteReplayBytes(ReplayRecorder* recorder, const void* data, const size_t size)
+{
+    if (fwrite(data, 1, size, recorder->file) != size)
+        recorder->writeFailed = true;
+}
+
+static void WriteReplayByte(ReplayRecorder* recorder, const unsigned char value)
+{
+    WriteReplayBytes(recorder, &value, 1);
+}
+
+static uint64_t HashBytes(uint64_t hash, const void* data, const size_t size)
+{
+    // FNV-1a
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+uint64_t HashReplayState(const GameState* game)
+{
+    uint64_t hash = 14695981039346656037ull;
+    hash = HashBytes(hash, &game->score, sizeof(game->score));
+    hash = HashBytes(hash, &game->gameTime, sizeof(game->gameTime));
+
+    const Player* player = &game->player;
+    hash = HashBytes(hash, &player->position, sizeof(player->position));
+    hash = HashBytes(hash, &player->velocity, sizeof(player->velocity));
+    hash = HashBytes(hash, &player->rotation, sizeof(player->rotation));
+    hash = HashBytes(hash, &player->health, sizeof(player->health));
+    hash = HashBytes(hash, &player->shootTimer, sizeof(player->shootTimer));
+    hash = HashBytes(hash, &player->leftThruster, sizeof(player->leftThruster));
+    hash = HashBytes(hash, &player->rightThruster, sizeof(player->rightThruster));
+
+    for (int m = 0; m < game->scenario.monsterCount; m++)
+    {
+        const Monster* monster = &game->monsters[m];
+        hash = HashBytes(hash, &monster->position, sizeof(monster->position));
+        hash = HashBytes(hash, &monster->health, sizeof(monster->health));
+        hash = HashBytes(hash, &monster->shootTimer, sizeof(monster->shootTimer));
+        hash = HashBytes(hash, &monster->spreadShotTimer, sizeof(monster->spreadShotTimer));
+        hash = HashBytes(hash, &monster->invincibilityTimer, sizeof(monster->invincibilityTimer));
+    }
+
+    const ProjectileStore* projectiles = &game->projectiles;
+    const size_t projectileCount = (size_t)projectiles->count;
+    hash = HashBytes(hash, &projectiles->count, sizeof(projectiles->count));
+    hash = HashBytes(hash, projectiles->x, sizeof(float) * projectileCount);
+    hash = HashBytes(hash, projectiles->y, sizeof(float) * projectileCount);
+    hash = HashBytes(hash, projectiles->owner, projectileCount);
+    return hash;
+}
+
+// Simulation fields of the player and of a monster, in this order. Sprites and colors stay with the GameState
+// playing the replay, which generated them from the same seed.
+#define REPLAY_PLAYER_FLOATS 18
+#define REPLAY_MONSTER_FLOATS 10
+#define REPLAY_PLAYER_SIZE (sizeof(float) * REPLAY_PLAYER_FLOATS + sizeof(int32_t) + 1)
+#define REPLAY_MONSTER_SIZE (sizeof(float) * REPLAY_MONSTER_FLOATS + sizeof(int32_t) + 2)
+
+static void WriteReplayPlayer(ReplayRecorder* recorder, const Player* player)
+{
+    const float fields[REPLAY_PLAYER_FLOATS] =
+    {
+        player->position.x, player->position.y,
+        player->previousPosition.x, player->previousPosition.y,
+        player->velocity.x, player->velocity.y,
+        player->rotation, player->previousRotation, player->size,
+        player->shootCooldown, player->shootTimer,
+        player->thrustPower, player->turnRate, player->maxSpeed,
+        player->health, player->explosionTimer,
+        player->leftThruster, player->rightThruster
+    };
+    const int32_t explosionFrame = player->explosionFrame;
+    WriteReplayBytes(recorder, fields, sizeof(fields));
+    WriteReplayBytes(recorder, &explosionFrame, sizeof(explosionFrame));
+    WriteReplayByte(recorder, player->isDead ? 1 : 0);
+}
+
+static void WriteReplayMonster(ReplayRecorder* recorder, const Monster* monster)
+{
+    const float fields[REPLAY_MONSTER_FLOATS] =
+    {
+        monster->position.x, monster->position.y,
+        monster->size, monster->health, monster->explosionTimer,
+        monster->shootCooldown, monster->shootTimer,
+        monster->spreadShotCooldown, monster->spreadShotTimer,
+        monster->invincibilityTimer
+    };
+    const int32_t explosionFrame = monster->explosionFrame;
+    WriteReplayBytes(recorder, fields, sizeof(fields));
+    WriteReplayBytes(recorder, &explosionFrame, sizeof(explosionFrame));
+    WriteReplayByte(recorder, monster->isDead ? 1 : 0);
+    WriteReplayByte(recorder, monster->canShoot ? 1 : 0);
+}
+
+static void WriteEffectPool(ReplayRecorder* recorder, const EffectPool* pool)
+{
+    const int32_t count = pool->count;
+    WriteReplayBytes(recorder, &count, sizeof(count));
+    WriteReplayBytes(recorder, pool->items, (size_t)pool->count * (size_t)pool->itemSize);
+}
+
+static void WriteReplayKeyframe(ReplayRecorder* recorder, const GameState* game)
+{
+    const int64_t tick = recorder->tick;
+    const uint64_t hash = HashReplayState(game);
+    WriteReplayByte(recorder, REPLAY_RECORD_KEYFRAME);
+    WriteReplayBytes(recorder, &tick, sizeof(tick));
+    WriteReplayBytes(recorder, &hash, sizeof(hash));
+
+    const int32_t score = game->score;
+    WriteReplayBytes(recorder, &score, sizeof(score));
+    WriteReplayBytes(recorder, &game->gameTime, sizeof(game->gameTime));
+
+    WriteReplayPlayer(recorder, &game->player);
+    for (int m = 0; m < game->scenario.monsterCount; m++)
+    {
+        WriteReplayMonster(recorder, &game->monsters[m]);
+    }
+
+    const ProjectileStore* projectiles = &game->projectiles;
+    const size_t projectileCount = (size_t)projectiles->count;
+    const int32_t count = projectiles->count;
+    WriteReplayBytes(recorder, &count, sizeof(count));
+    WriteReplayBytes(recorder, projectiles->x, sizeof(float) * projectileCount);
+    WriteReplayBytes(recorder, projectiles->y, sizeof(float) * projectileCount);
+    WriteReplayBytes(recorder, projectiles->velocityX, sizeof(float) * projectileCount);
+    WriteReplayBytes(recorder, projectiles->velocityY, sizeof(float) * projectileCount);
+    WriteReplayBytes(recorder, projectiles->owner, projectileCount);
+    WriteReplayBytes(recorder, projectiles->monsterIndex, sizeof(int) * projectileCount);
+
+    WriteEffectPool(recorder, &game->hitEffects);
+    WriteEffectPool(recorder, &game->deathExplosions);
+
+    recorder->writeFullRecord = true;
+}
+
+bool BeginReplayRecording(ReplayRecorder* recorder, const char* path, const unsigned int seed, const GameState* game, const int keyframeInterval)
+{
+    memset(recorder, 0, sizeof(*recorder));
+    recorder->file = fopen(path, "wb");
+    if (!recorder->file)
+        return false;
+    recorder->keyframeInterval = keyframeInterval > 0 ? keyframeInterval : REPLAY_DEFAULT_KEYFRAME_INTERVAL;
+
+    ReplayHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, REPLAY_MAGIC, sizeof(header.magic));
+    header.version = REPLAY_VERSION;
+    header.seed = seed;
+    header.keyframeInterval = recorder->keyframeInterval;
+    header.scenarioSize = sizeof(Scenario);
+    header.hitEffectSize = sizeof(HitEffect);
+    header.deathExplosionSize = sizeof(DeathExplosion);
+    WriteReplayBytes(recorder, &header, sizeof(header));
+    WriteReplayBytes(recorder, &game->scenario, sizeof(game->scenario));
+
+    WriteReplayKeyframe(recorder, game);
+    return !recorder->writeFailed;
+}
+
+void RecordReplayTick(ReplayRecorder* recorder, const GameState* game, const float deltaTime)
+{
+    if (!recorder->file)
+        return;
+
+    const PlayerInput* input = &game->lastInput;
+    unsigned char flags = 0;
+    if (input->shoot)
+        flags |= REPLAY_TICK_SHOOT | (unsigned char)(input->shootDirection << REPLAY_TICK_DIRECTION_SHIFT);
+
+    const bool thrustersChanged = recorder->writeFullRecord ||
+        input->leftThruster != recorder->previousInput.leftThruster ||
+        input->rightThruster != recorder->previousInput.rightThruster;
+    const bool deltaTimeChanged = recorder->writeFullRecord || deltaTime != recorder->previousDeltaTime;
+    if (thrustersChanged)
+        flags |= REPLAY_TICK_THRUSTERS;
+    if (deltaTimeChanged)
+        flags |= REPLAY_TICK_DELTA_TIME;
+
+    WriteReplayByte(recorder, flags);
+    if (thrustersChanged)
+    {
+        WriteReplayBytes(recorder, &input->leftThruster, sizeof(float));
+        WriteReplayBytes(recorder, &input->rightThruster, sizeof(float));
+    }
+    if (deltaTimeChanged)
+        WriteReplayBytes(recorder, &deltaTime, sizeof(float));
+
+    recorder->previousInput = *input;
+    recorder->previousDeltaTime = deltaTime;
+    recorder->writeFullRecord = false;
+    recorder->tick++;
+
+    if (recorder->tick % recorder->keyframeInterval == 0)
+        WriteReplayKeyframe(recorder, game);
+}
+
+bool EndReplayRecording(ReplayRecorder* recorder)
+{
+    if (!recorder->file)
+        return false;
+
+    WriteReplayByte(recorder, REPLAY_RECORD_END);
+    if (fclose(recorder->file) != 0)
+        recorder->writeFailed = true;
+    recorder->file = NULL;
+    return !recorder->writeFailed;
+}
+
+static bool ReadReplayBytes(const Replay* replay, size_t* cursor, void* out, const size_t size)
+{
+    if (size > replay->size - *cursor)
+        return false;
+    if (out)
+        memcpy(out, replay->data + *cursor, size);
+    *cursor += size;
+    return true;
+}
+
+static bool SkipEffectPool(const Replay* replay, size_t* cursor, const size_t itemSize)
+{
+    int32_t count;
+    return ReadReplayBytes(replay, cursor, &count, sizeof(count)) && count >= 0 &&
+           ReadReplayBytes(replay, cursor, NULL, (size_t)count * itemSize);
+}
+
+// Walks over a keyframe's state, checking that it lies within the file
+static bool SkipKeyframeState(const Replay* replay, size_t* cursor)
+{
+    int32_t projectileCount;
+    if (!ReadReplayBytes(replay, cursor, NULL, sizeof(int32_t) + sizeof(float) + REPLAY_PLAYER_SIZE +
+            REPLAY_MONSTER_SIZE * (size_t)replay->scenario.monsterCount) ||
+        !ReadReplayBytes(replay, cursor, &projectileCount, sizeof(projectileCount)) || projectileCount < 0 ||
+        !ReadReplayBytes(replay, cursor, NULL, (size_t)projectileCount * (sizeof(float) * 4 + 1 + sizeof(int))))
+        return false;
+    return SkipEffectPool(replay, cursor, sizeof(HitEffect)) && SkipEffectPool(replay, cursor, sizeof(DeathExplosion));
+}
+
+static size_t GetTickRecordSize(const unsigned char flags)
+{
+    size_t size = 1;
+    if (flags & REPLAY_TICK_THRUSTERS)
+        size += 2 * sizeof(float);
+    if (flags & REPLAY_TICK_DELTA_TIME)
+        size += sizeof(float);
+    return size;
+}
+
+static bool IndexReplay(Replay* replay, size_t cursor, const char* path)
+{
+    int capacity = 16;
+    replay->keyframes = (ReplayKeyframe*)malloc(sizeof(ReplayKeyframe) * (size_t)capacity);
+    if (!replay->keyframes)
+        return false;
+
+    for (;;)
+    {
+        unsigned char tag;
+        if (!ReadReplayBytes(replay, &cursor, &tag, 1))
+        {
+            fprintf(stderr, "Error: %s is truncated after %ld ticks\n", path, replay->tickCount);
+            return false;
+        }
+
+        if (tag == REPLAY_RECORD_END)
+            break;
+
+        if (tag == REPLAY_RECORD_KEYFRAME)
+        {
+            int64_t tick;
+            if (!ReadReplayBytes(replay, &cursor, &tick, sizeof(tick)) || tick != replay->tickCount)
+            {
+                fprintf(stderr, "Error: %s has a misplaced keyframe after %ld ticks\n", path, replay->tickCount);
+                return false;
+            }
+
+            if (replay->keyframeCount == capacity)
+            {
+                capacity *= 2;
+                ReplayKeyframe* grown = (ReplayKeyframe*)realloc(replay->keyframes, sizeof(ReplayKeyframe) * (size_t)capacity);
+                if (!grown)
+                    return false;
+                replay->keyframes = grown;
+            }
+
+            ReplayKeyframe* keyframe = &replay->keyframes[replay->keyframeCount];
+            keyframe->tick = (long)tick;
+            keyframe->stateOffset = cursor;
+            if (!ReadReplayBytes(replay, &cursor, NULL, sizeof(uint64_t)) || !SkipKeyframeState(replay, &cursor))
+            {
+                fprintf(stderr, "Error: %s is truncated in the keyframe at tick %ld\n", path, replay->tickCount);
+                return false;
+            }
+            keyframe->nextRecord = cursor;
+            replay->keyframeCount++;
+        }
+        else if (tag < REPLAY_RECORD_KEYFRAME)
+        {
+            if (!ReadReplayBytes(replay, &cursor, NULL, GetTickRecordSize(tag) - 1))
+            {
+                fprintf(stderr, "Error: %s is truncated after %ld ticks\n", path, replay->tickCount);
+                return false;
+            }
+            replay->tickCount++;
+        }
+        else
+        {
+            fprintf(stderr, "Error: %s has an unknown record 0x%02x after %ld ticks\n", path, tag, replay->tickCount);
+            return false;
+        }
+    }
+
+    if (replay->keyframeCount == 0 || replay->keyframes[0].tick != 0)
+    {
+        fprintf(stderr, "Error: %s does not start with a keyframe\n", path);
+        return false;
+    }
+    return true;
+}
+
+bool LoadReplay(Replay* replay, const char* path)
+{
+    memset(replay, 0, sizeof(*replay));
+
+    FILE* file = fopen(path, "rb");
+    if (!file)
+    {
+        fprintf(stderr, "Error: cannot open %s\n", path);
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    const long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size > 0)
+        replay->data = (unsigned char*)malloc((size_t)size);
+    if (!replay->data || fread(replay->data, 1, (size_t)size, file) != (size_t)size)
+    {
+        fprintf(stderr, "Error: cannot read %s\n", path);
+        fclose(file);
+        FreeReplay(replay);
+        return false;
+    }
+    fclose(file);
+    replay->size = (size_t)size;
+
+    size_t cursor = 0;
+    ReplayHeader header;
+    if (!ReadReplayBytes(replay, &cursor, &header, sizeof(header)) || memcmp(header.magic, REPLAY_MAGIC, sizeof(header.magic)) != 0)
+    {
+        fprintf(stderr, "Error: %s is not a replay\n", path);
+        FreeReplay(replay);
+        return false;
+    }
+
+    if (header.version != REPLAY_VERSION ||
+        header.scenarioSize != sizeof(Scenario) ||
+        header.hitEffectSize != sizeof(HitEffect) ||
+        header.deathExplosionSize != sizeof(DeathExplosion))
+    {
+        fprintf(stderr, "Error: %s was recorded by an incompatible version of the game\n", path);
+        FreeReplay(replay);
+        return false;
+    }
+
+    replay->seed = header.seed;
+    replay->keyframeInterval = header.keyframeInterval;
+    if (!ReadReplayBytes(replay, &cursor, &replay->scenario, sizeof(replay->scenario)) || !IsScenarioValid(&replay->scenario))
+    {
+        fprintf(stderr, "Error: %s holds an invalid scenario\n", path);
+        FreeReplay(replay);
+        return false;
+    }
+
+    if (!IndexReplay(replay, cursor, path))
+    {
+        FreeReplay(replay);
+        return false;
+    }
+    return true;
+}
+
+void FreeReplay(Replay* replay)
+{
+    free(replay->keyframes);
+    free(replay->data);
+    memset(replay, 0, sizeof(*replay));
+}
+
+// For records IndexReplay has already checked
+static void CopyReplayBytes(const Replay* replay, size_t* cursor, void* out, const size_t size)
+{
+    memcpy(out, replay->data + *cursor, size);
+    *cursor += size;
+}
+
+static void ReadReplayPlayer(const Replay* replay, size_t* cursor, Player* player)
+{
+    float fields[REPLAY_PLAYER_FLOATS];
+    int32_t explosionFrame;
+    unsigned char isDead;
+    CopyReplayBytes(replay, cursor, fields, sizeof(fields));
+    CopyReplayBytes(replay, cursor, &explosionFrame, sizeof(explosionFrame));
+    CopyReplayBytes(replay, cursor, &isDead, sizeof(isDead));
+
+    player->position = (Vector2){ fields[0], fields[1] };
+    player->previousPosition = (Vector2){ fields[2], fields[3] };
+    player->velocity = (Vector2){ fields[4], fields[5] };
+    player->rotation = fields[6];
+    player->previousRotation = fields[7];
+    player->size = fields[8];
+    player->shootCooldown = fields[9];
+    player->shootTimer = fields[10];
+    player->thrustPower = fields[11];
+    player->turnRate = fields[12];
+    player->maxSpeed = fields[13];
+    player->health = fields[14];
+    player->explosionTimer = fields[15];
+    player->leftThruster = fields[16];
+    player->rightThruster = fields[17];
+    player->explosionFrame = explosionFrame;
+    player->isDead = isDead != 0;
+}
+
+static void ReadReplayMonster(const Replay* replay, size_t* cursor, Monster* monster)
+{
+    float fields[REPLAY_MONSTER_FLOATS];
+    int32_t explosionFrame;
+    unsigned char flags[2];
+    CopyReplayBytes(replay, cursor, fields, sizeof(fields));
+    CopyReplayBytes(replay, cursor, &explosionFrame, sizeof(explosionFrame));
+    CopyReplayBytes(replay, cursor, flags, sizeof(flags));
+
+    monster->position = (Vector2){ fields[0], fields[1] };
+    monster->size = fields[2];
+    monster->health = fields[3];
+    monster->explosionTimer = fields[4];
+    monster->shootCooldown = fields[5];
+    monster->shootTimer = fields[6];
+    monster->spreadShotCooldown = fields[7];
+    monster->spreadShotTimer = fields[8];
+    monster->invincibilityTimer = fields[9];
+    monster->explosionFrame = explosionFrame;
+    monster->isDead = flags[0] != 0;
+    monster->canShoot = flags[1] != 0;
+}
+
+static bool ReadEffectPool(const Replay* replay, size_t* cursor, EffectPool* pool)
+{
+    int32_t count;
+    CopyReplayBytes(replay, cursor, &count, sizeof(count));
+    if (!AssignEffects(pool, replay->data + *cursor, count))
+        return false;
+    *cursor += (size_t)count * (size_t)pool->itemSize;
+    return true;
+}
+
+static bool RestoreReplayKeyframe(const Replay* replay, const ReplayKeyframe* keyframe, GameState* game)
+{
+    size_t cursor = keyframe->stateOffset + sizeof(uint64_t);
+
+    int32_t score;
+    CopyReplayBytes(replay, &cursor, &score, sizeof(score));
+    game->score = score;
+    CopyReplayBytes(replay, &cursor, &game->gameTime, sizeof(game->gameTime));
+
+    ReadReplayPlayer(replay, &cursor, &game->player);
+    for (int m = 0; m < game->scenario.monsterCount; m++)
+    {
+        ReadReplayMonster(replay, &cursor, &game->monsters[m]);
+    }
+
+    int32_t projectileCount;
+    CopyReplayBytes(replay, &cursor, &projectileCount, sizeof(projectileCount));
+    ProjectileStore* projectiles = &game->projectiles;
+    if (!ReserveProjectiles(projectiles, projectileCount))
+        return false;
+    const size_t count = (size_t)projectileCount;
+    CopyReplayBytes(replay, &cursor, projectiles->x, sizeof(float) * count);
+    CopyReplayBytes(replay, &cursor, projectiles->y, sizeof(float) * count);
+    CopyReplayBytes(replay, &cursor, projectiles->velocityX, sizeof(float) * count);
+    CopyReplayBytes(replay, &cursor, projectiles->velocityY, sizeof(float) * count);
+    CopyReplayBytes(replay, &cursor, projectiles->owner, count);
+    CopyReplayBytes(replay, &cursor, projectiles->monsterIndex, sizeof(int) * count);
+    projectiles->count = projectileCount;
+    projectiles->snapshotId = 0;
+    RecountPlayerProjectiles(projectiles);
+    game->newProjectileCount = 0;
+
+    return ReadEffectPool(replay, &cursor, &game->hitEffects) && ReadEffectPool(replay, &cursor, &game->deathExplosions);
+}
+
+static void ResumeFromKeyframe(ReplayPlayer* player, const GameState* game, const int keyframeIndex)
+{
+    const ReplayKeyframe* keyframe = &player->replay->keyframes[keyframeIndex];
+    player->cursor = keyframe->nextRecord;
+    player->tick = keyframe->tick;
+    player->nextKeyframe = keyframeIndex + 1;
+    player->input.leftThruster = game->player.leftThruster;
+    player->input.rightThruster = game->player.rightThruster;
+}
+
+bool StartReplayPlayback(ReplayPlayer* player, const Replay* replay, GameState* game)
+{
+    if (!InitGameState(game, &replay->scenario, replay->seed))
+        return false;
+
+    memset(player, 0, sizeof(*player));
+    player->replay = replay;
+    player->divergedTick = -1;
+    ResumeFromKeyframe(player, game, 0);
+    game->scriptedInput = &player->input;
+
+    // A mismatch this early means world generation itself differs from the recording
+    uint64_t hash;
+    memcpy(&hash, replay->data + replay->keyframes[0].stateOffset, sizeof(hash));
+    if (hash != HashReplayState(game))
+        player->divergedTick = 0;
+    return true;
+}
+
+bool StepReplay(ReplayPlayer* player, GameState* game)
+{
+    const Replay* replay = player->replay;
+    if (player->tick >= replay->tickCount)
+        return false;
+
+    size_t cursor = player->cursor;
+    unsigned char flags;
+    CopyReplayBytes(replay, &cursor, &flags, 1);
+    player->input.shoot = (flags & REPLAY_TICK_SHOOT) != 0;
+    player->input.shootDirection = (ShootDirection)((flags >> REPLAY_TICK_DIRECTION_SHIFT) & 0x3);
+    if (flags & REPLAY_TICK_THRUSTERS)
+    {
+        CopyReplayBytes(replay, &cursor, &player->input.leftThruster, sizeof(float));
+        CopyReplayBytes(replay, &cursor, &player->input.rightThruster, sizeof(float));
+    }
+    if (flags & REPLAY_TICK_DELTA_TIME)
+        CopyReplayBytes(replay, &cursor, &player->deltaTime, sizeof(float));
+
+    UpdateGameState(game, player->deltaTime);
+    player->tick++;
+    player->cursor = cursor;
+
+    if (player->nextKeyframe < replay->keyframeCount && replay->keyframes[player->nextKeyframe].tick == player->tick)
+    {
+        const ReplayKeyframe* keyframe = &replay->keyframes[player->nextKeyframe];
+        uint64_t hash;
+        memcpy(&hash, replay->data + keyframe->stateOffset, sizeof(hash));
+        if (hash != HashReplayState(game) && player->divergedTick < 0)
+            player->divergedTick = player->tick;
+
+        player->cursor = keyframe->nextRecord;
+        player->nextKeyframe++;
+    }
+    return true;
+}
+
+bool SeekReplay(ReplayPlayer* player, GameState* game, long tick)
+{
+    const Replay* replay = player->replay;
+    if (tick < 0)
+        tick = 0;
+    if (tick > replay->tickCount)
+        tick = replay->tickCount;
+
+    int keyframeIndex = 0;
+    while (keyframeIndex + 1 < replay->keyframeCount && replay->keyframes[keyframeIndex + 1].tick <= tick)
+        keyframeIndex++;
+
+    // Playing on is cheaper than restoring when the target is ahead and no keyframe lies in between
+    if (player->tick > tick || player->tick < replay->keyframes[keyframeIndex].tick)
+    {
+        if (!RestoreReplayKeyframe(replay, &replay->keyframes[keyframeIndex], game))
+            return false;
+        ResumeFromKeyframe(player, game, keyframeIndex);
+    }
+
+    while (player->tick < tick && StepReplay(player, game))
+    {
+    }
+    return true;
+}
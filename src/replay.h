@@ -0,0 +1,87 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "main.h"
+#include <stdint.h>
+#include <stdio.h>
+
+// Deterministic replays. The simulation only draws random numbers while the world is generated, so a game is
+// reproduced by its seed, its scenario and, for every tick, the frame time and the commands that took effect.
+//
+// File layout (native byte order, so replays move between machines of the same endianness):
+//   header    "ECRP", format version, seed, scenario, and the sizes of the scenario and effect structures, which
+//             are dumped as they are laid out in memory
+//   records   a tick record per tick: a flags byte, then the thrusters if they changed and the frame time if it
+//             changed since the previous tick; every keyframeInterval ticks, a keyframe record holding a full
+//             copy of the simulation state so playback can seek without re-simulating from the start; the player
+//             and the monsters are written field by field, without their sprites
+//   end       REPLAY_RECORD_END
+//
+// Keyframes also carry a hash of the state, which playback compares against to detect divergence (a replay
+// played by a build whose floating-point code generation differs from the recording one, for example).
+
+#define REPLAY_DEFAULT_KEYFRAME_INTERVAL 600 // Ticks between keyframes: 5 seconds at 120 Hz
+
+typedef struct ReplayRecorder
+{
+    FILE* file;
+    long tick;
+    int keyframeInterval;
+    PlayerInput previousInput;   // Thrusters and frame time are only written when they change
+    float previousDeltaTime;
+    bool writeFullRecord;        // Set after a keyframe, which playback may resume from
+    bool writeFailed;
+} ReplayRecorder;
+
+typedef struct ReplayKeyframe
+{
+    long tick;              // Ticks played before the state was captured
+    size_t stateOffset;     // Offset of the state in Replay.data
+    size_t nextRecord;      // Offset of the tick record that follows it
+} ReplayKeyframe;
+
+typedef struct Replay
+{
+    unsigned char* data;    // The whole file
+    size_t size;
+    unsigned int seed;
+    Scenario scenario;
+    int keyframeInterval;
+    long tickCount;
+    ReplayKeyframe* keyframes;
+    int keyframeCount;
+} Replay;
+
+typedef struct ReplayPlayer
+{
+    const Replay* replay;
+    size_t cursor;          // Offset of the next tick record
+    long tick;              // Ticks played so far
+    int nextKeyframe;       // First keyframe not reached yet
+    PlayerInput input;      // Fed to the simulation through GameState.scriptedInput
+    float deltaTime;
+    long divergedTick;      // First keyframe whose hash did not match, -1 while none has
+} ReplayPlayer;
+
+// Starts a recording of a game that has just been initialized with the given seed
+bool BeginReplayRecording(ReplayRecorder* recorder, const char* path, unsigned int seed, const GameState* game, int keyframeInterval);
+// Records the tick UpdateGameState has just played with this deltaTime
+void RecordReplayTick(ReplayRecorder* recorder, const GameState* game, float deltaTime);
+// Closes the file; false if any write failed along the way
+bool EndReplayRecording(ReplayRecorder* recorder);
+
+// Loads and validates a replay file, printing what is wrong to stderr
+bool LoadReplay(Replay* replay, const char* path);
+void FreeReplay(Replay* replay);
+
+// Generates the replay's world into game (which must not be initialized) and sets it up to be driven by player
+bool StartReplayPlayback(ReplayPlayer* player, const Replay* replay, GameState* game);
+// Plays one recorded tick; false once the replay is over
+bool StepReplay(ReplayPlayer* player, GameState* game);
+// Moves to any tick by restoring the last keyframe at or before it and re-simulating from there.
+// Sprites already assigned to the player and monsters are kept.
+bool SeekReplay(ReplayPlayer* player, GameState* game, long tick);
+
+uint64_t HashReplayState(const GameState* game);
+
+#endif // REPLAY_H
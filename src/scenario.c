@@ -0,0 +1,100 @@
+#include "scenario.h"
+#include "config.h"
+#include <stdio.h>
+#include <string.h>
+
+void InitDefaultScenario(Scenario* scenario)
+{
+    scenario->monsterCount = MONSTER_COUNT;
+    scenario->starCount = STAR_COUNT;
+    scenario->hitEffectCapacity = HIT_EFFECT_INITIAL_CAPACITY;
+    scenario->arenaWidth = SCREEN_WIDTH;
+    scenario->arenaHeight = SCREEN_HEIGHT;
+    scenario->damagePlayerProjectile = DAMAGE_PLAYER_PROJECTILE;
+    scenario->damageMonsterProjectile = DAMAGE_MONSTER_PROJECTILE;
+    scenario->damageMonsterSpreadShot = DAMAGE_MONSTER_SPREAD_SHOT;
+    scenario->damageProximityPerSecond = DAMAGE_PROXIMITY_PER_SECOND;
+}
+
+bool SetScenarioValue(Scenario* scenario, const char* key, const float value)
+{
+    if (strcmp(key, "monster_count") == 0)
+        scenario->monsterCount = (int)value;
+    else if (strcmp(key, "star_count") == 0)
+        scenario->starCount = (int)value;
+    else if (strcmp(key, "hit_effect_capacity") == 0)
+        scenario->hitEffectCapacity = (int)value;
+    else if (strcmp(key, "arena_width") == 0)
+        scenario->arenaWidth = value;
+    else if (strcmp(key, "arena_height") == 0)
+        scenario->arenaHeight = value;
+    else if (strcmp(key, "damage_player_projectile") == 0)
+        scenario->damagePlayerProjectile = value;
+    else if (strcmp(key, "damage_monster_projectile") == 0)
+        scenario->damageMonsterProjectile = value;
+    else if (strcmp(key, "damage_monster_spread_shot") == 0)
+        scenario->damageMonsterSpreadShot = value;
+    else if (strcmp(key, "damage_proximity_per_second") == 0)
+        scenario->damageProximityPerSecond = value;
+    else
+        return false;
+
+    return true;
+}
+
+bool LoadScenarioFile(Scenario* scenario, const char* path)
+{
+    FILE* file = fopen(path, "r");
+    if (!file)
+    {
+        fprintf(stderr, "Error: cannot open scenario file %s\n", path);
+        return false;
+    }
+
+    char line[256];
+    int lineNumber = 0;
+    bool success = true;
+
+    while (fgets(line, sizeof(line), file))
+    {
+        lineNumber++;
+
+        char* comment = strchr(line, '#');
+        if (comment)
+            *comment = '\0';
+
+        char key[64];
+        float value;
+        char trailing;
+        const int fields = sscanf(line, " %63[a-z_] = %f %c", key, &value, &trailing);
+        if (fields == EOF)
+            continue;
+
+        if (fields != 2 || !SetScenarioValue(scenario, key, value))
+        {
+            fprintf(stderr, "Error: %s:%d: invalid scenario setting: %s\n", path, lineNumber, line);
+            success = false;
+            break;
+        }
+    }
+
+    fclose(file);
+    return success && IsScenarioValid(scenario);
+}
+
+bool IsScenarioValid(const Scenario* scenario)
+{
+    if (scenario->monsterCount < 1 || scenario->starCount < 0 || scenario->hitEffectCapacity < 1)
+    {
+        fprintf(stderr, "Error: scenario needs at least one monster and one hit effect slot\n");
+        return false;
+    }
+
+    if (scenario->arenaWidth < 2 * MONSTER_MAX_SIZE || scenario->arenaHeight < 2 * MONSTER_MAX_SIZE)
+    {
+        fprintf(stderr, "Error: scenario arena must be at least %.0f units on each side\n", 2 * MONSTER_MAX_SIZE);
+        return false;
+    }
+
+    return true;
+}
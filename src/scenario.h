@@ -0,0 +1,28 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include <stdbool.h>
+
+// World parameters chosen at startup. The defaults come from config.h; any of them can be
+// overridden by a scenario file made of "key = value" lines ('#' starts a comment).
+typedef struct Scenario
+{
+    int monsterCount;
+    int starCount;
+    int hitEffectCapacity;  // Initial size of the hit effect pool, which grows on demand
+    float arenaWidth;
+    float arenaHeight;
+    float damagePlayerProjectile;
+    float damageMonsterProjectile;
+    float damageMonsterSpreadShot;
+    float damageProximityPerSecond;
+} Scenario;
+
+void InitDefaultScenario(Scenario* scenario);
+
+// Applies the settings found in the file on top of the current values.
+// Prints the offending line to stderr and returns false on any error.
+bool LoadScenarioFile(Scenario* scenario, const char* path);
+bool IsScenarioValid(const Scenario* scenario);
+
+#endif // SCENARIO_H
@@ -0,0 +1,309 @@
+#include "snapshot.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SNAPSHOT_ALIGNMENT 16
+
+// Simulation fields of a monster; sprites and colors stay with the GameState
+typedef struct SnapshotMonster
+{
+    Vector2 position;
+    float size;
+    float health;
+    float explosionTimer;
+    int explosionFrame;
+    float shootCooldown;
+    float shootTimer;
+    float spreadShotCooldown;
+    float spreadShotTimer;
+    float invincibilityTimer;
+    bool isDead;
+    bool canShoot;
+} SnapshotMonster;
+
+typedef struct SnapshotPlayer
+{
+    Vector2 position;
+    Vector2 previousPosition;
+    Vector2 velocity;
+    float rotation;
+    float previousRotation;
+    float size;
+    float shootCooldown;
+    float shootTimer;
+    float thrustPower;
+    float turnRate;
+    float maxSpeed;
+    float health;
+    float explosionTimer;
+    int explosionFrame;
+    float leftThruster;
+    float rightThruster;
+    bool isDead;
+} SnapshotPlayer;
+
+typedef struct SnapshotHeader
+{
+    int32_t monsterCount;
+    int32_t projectileCount;
+    int32_t playerProjectileCount;
+    int32_t hitEffectCount;
+    int32_t deathExplosionCount;
+    uint64_t projectileSnapshotId;  // Never 0, see ProjectileStore.snapshotId
+    int32_t score;
+    float gameTime;
+    Random worldRandom;
+    Random aiRandom;
+    PlayerInput lastInput;
+    SnapshotPlayer player;
+} SnapshotHeader;
+
+// Offsets of the sections that follow the header; each depends only on the counts before it
+typedef struct SnapshotLayout
+{
+    size_t monsters;
+    size_t projectiles;     // x, y, velocityX, velocityY, monsterIndex and owner lanes back to back
+    size_t hitEffects;
+    size_t deathExplosions;
+    size_t size;
+} SnapshotLayout;
+
+static atomic_uint_least64_t g_nextSnapshotId = 1;
+
+static size_t AlignSnapshotOffset(const size_t offset)
+{
+    return (offset + SNAPSHOT_ALIGNMENT - 1) & ~(size_t)(SNAPSHOT_ALIGNMENT - 1);
+}
+
+static SnapshotLayout GetSnapshotLayout(const int monsterCount, const int projectileCount, const int hitEffectCount, const int deathExplosionCount)
+{
+    SnapshotLayout layout;
+    layout.monsters = AlignSnapshotOffset(sizeof(SnapshotHeader));
+    layout.projectiles = AlignSnapshotOffset(layout.monsters + sizeof(SnapshotMonster) * (size_t)monsterCount);
+    layout.hitEffects = AlignSnapshotOffset(layout.projectiles +
+        (size_t)projectileCount * (4 * sizeof(float) + sizeof(int) + sizeof(unsigned char)));
+    layout.deathExplosions = AlignSnapshotOffset(layout.hitEffects + sizeof(HitEffect) * (size_t)hitEffectCount);
+    layout.size = layout.deathExplosions + sizeof(DeathExplosion) * (size_t)deathExplosionCount;
+    return layout;
+}
+
+static bool ReserveSnapshot(GameSnapshot* snapshot, const size_t size)
+{
+    if (size <= snapshot->capacity)
+        return true;
+
+    // realloc keeps the previous contents, which an incremental capture relies on
+    const size_t capacity = size > snapshot->capacity * 2 ? size : snapshot->capacity * 2;
+    unsigned char* data = (unsigned char*)realloc(snapshot->data, capacity);
+    if (!data)
+        return false;
+
+    snapshot->data = data;
+    snapshot->capacity = capacity;
+    return true;
+}
+
+void InitGameSnapshot(GameSnapshot* snapshot)
+{
+    memset(snapshot, 0, sizeof(*snapshot));
+}
+
+void FreeGameSnapshot(GameSnapshot* snapshot)
+{
+    free(snapshot->data);
+    memset(snapshot, 0, sizeof(*snapshot));
+}
+
+static void CaptureMonster(SnapshotMonster* out, const Monster* monster)
+{
+    out->position = monster->position;
+    out->size = monster->size;
+    out->health = monster->health;
+    out->explosionTimer = monster->explosionTimer;
+    out->explosionFrame = monster->explosionFrame;
+    out->shootCooldown = monster->shootCooldown;
+    out->shootTimer = monster->shootTimer;
+    out->spreadShotCooldown = monster->spreadShotCooldown;
+    out->spreadShotTimer = monster->spreadShotTimer;
+    out->invincibilityTimer = monster->invincibilityTimer;
+    out->isDead = monster->isDead;
+    out->canShoot = monster->canShoot;
+}
+
+static void RestoreMonster(Monster* monster, const SnapshotMonster* in)
+{
+    monster->position = in->position;
+    monster->size = in->size;
+    monster->health = in->health;
+    monster->explosionTimer = in->explosionTimer;
+    monster->explosionFrame = in->explosionFrame;
+    monster->shootCooldown = in->shootCooldown;
+    monster->shootTimer = in->shootTimer;
+    monster->spreadShotCooldown = in->spreadShotCooldown;
+    monster->spreadShotTimer = in->spreadShotTimer;
+    monster->invincibilityTimer = in->invincibilityTimer;
+    monster->isDead = in->isDead;
+    monster->canShoot = in->canShoot;
+}
+
+static void CapturePlayer(SnapshotPlayer* out, const Player* player)
+{
+    out->position = player->position;
+    out->previousPosition = player->previousPosition;
+    out->velocity = player->velocity;
+    out->rotation = player->rotation;
+    out->previousRotation = player->previousRotation;
+    out->size = player->size;
+    out->shootCooldown = player->shootCooldown;
+    out->shootTimer = player->shootTimer;
+    out->thrustPower = player->thrustPower;
+    out->turnRate = player->turnRate;
+    out->maxSpeed = player->maxSpeed;
+    out->health = player->health;
+    out->explosionTimer = player->explosionTimer;
+    out->explosionFrame = player->explosionFrame;
+    out->leftThruster = player->leftThruster;
+    out->rightThruster = player->rightThruster;
+    out->isDead = player->isDead;
+}
+
+static void RestorePlayer(Player* player, const SnapshotPlayer* in)
+{
+    player->position = in->position;
+    player->previousPosition = in->previousPosition;
+    player->velocity = in->velocity;
+    player->rotation = in->rotation;
+    player->previousRotation = in->previousRotation;
+    player->size = in->size;
+    player->shootCooldown = in->shootCooldown;
+    player->shootTimer = in->shootTimer;
+    player->thrustPower = in->thrustPower;
+    player->turnRate = in->turnRate;
+    player->maxSpeed = in->maxSpeed;
+    player->health = in->health;
+    player->explosionTimer = in->explosionTimer;
+    player->explosionFrame = in->explosionFrame;
+    player->leftThruster = in->leftThruster;
+    player->rightThruster = in->rightThruster;
+    player->isDead = in->isDead;
+}
+
+bool CaptureGameSnapshot(GameSnapshot* snapshot, GameState* game)
+{
+    ProjectileStore* projectiles = &game->projectiles;
+    const int monsterCount = game->scenario.monsterCount;
+    const SnapshotLayout layout = GetSnapshotLayout(monsterCount, projectiles->count,
+        game->hitEffects.count, game->deathExplosions.count);
+
+    // The lanes already in the snapshot can be kept when the store still holds what they were copied from
+    const SnapshotHeader* previous = snapshot->size >= sizeof(SnapshotHeader) ? (const SnapshotHeader*)snapshot->data : NULL;
+    const bool projectilesUnchanged = previous && projectiles->snapshotId != 0 &&
+        previous->projectileSnapshotId == projectiles->snapshotId &&
+        previous->monsterCount == monsterCount && previous->projectileCount == projectiles->count;
+
+    if (!ReserveSnapshot(snapshot, layout.size))
+        return false;
+
+    SnapshotHeader* header = (SnapshotHeader*)snapshot->data;
+    header->monsterCount = monsterCount;
+    header->projectileCount = projectiles->count;
+    header->playerProjectileCount = projectiles->playerCount;
+    header->hitEffectCount = game->hitEffects.count;
+    header->deathExplosionCount = game->deathExplosions.count;
+    header->score = game->score;
+    header->gameTime = game->gameTime;
+    header->worldRandom = game->worldRandom;
+    header->aiRandom = game->aiRandom;
+    header->lastInput = game->lastInput;
+    CapturePlayer(&header->player, &game->player);
+
+    SnapshotMonster* monsters = (SnapshotMonster*)(snapshot->data + layout.monsters);
+    for (int m = 0; m < monsterCount; m++)
+    {
+        CaptureMonster(&monsters[m], &game->monsters[m]);
+    }
+
+    if (!projectilesUnchanged)
+    {
+        const size_t count = (size_t)projectiles->count;
+        float* lanes = (float*)(snapshot->data + layout.projectiles);
+        memcpy(lanes, projectiles->x, sizeof(float) * count);
+        memcpy(lanes + count, projectiles->y, sizeof(float) * count);
+        memcpy(lanes + 2 * count, projectiles->velocityX, sizeof(float) * count);
+        memcpy(lanes + 3 * count, projectiles->velocityY, sizeof(float) * count);
+        memcpy(lanes + 4 * count, projectiles->monsterIndex, sizeof(int) * count);
+        memcpy((unsigned char*)(lanes + 5 * count), projectiles->owner, count);
+
+        header->projectileSnapshotId = atomic_fetch_add(&g_nextSnapshotId, 1);
+        projectiles->snapshotId = header->projectileSnapshotId;
+    }
+
+    memcpy(snapshot->data + layout.hitEffects, game->hitEffects.items, sizeof(HitEffect) * (size_t)game->hitEffects.count);
+    memcpy(snapshot->data + layout.deathExplosions, game->deathExplosions.items,
+        sizeof(DeathExplosion) * (size_t)game->deathExplosions.count);
+
+    snapshot->size = layout.size;
+    return true;
+}
+
+bool RestoreGameSnapshot(const GameSnapshot* snapshot, GameState* game)
+{
+    if (snapshot->size < sizeof(SnapshotHeader))
+        return false;
+
+    const SnapshotHeader* header = (const SnapshotHeader*)snapshot->data;
+    if (header->monsterCount != game->scenario.monsterCount)
+        return false;
+
+    const SnapshotLayout layout = GetSnapshotLayout(header->monsterCount, header->projectileCount,
+        header->hitEffectCount, header->deathExplosionCount);
+
+    ProjectileStore* projectiles = &game->projectiles;
+    if (projectiles->snapshotId != header->projectileSnapshotId)
+    {
+        if (!ReserveProjectiles(projectiles, header->projectileCount))
+            return false;
+
+        const size_t count = (size_t)header->projectileCount;
+        const float* lanes = (const float*)(snapshot->data + layout.projectiles);
+        memcpy(projectiles->x, lanes, sizeof(float) * count);
+        memcpy(projectiles->y, lanes + count, sizeof(float) * count);
+        memcpy(projectiles->velocityX, lanes + 2 * count, sizeof(float) * count);
+        memcpy(projectiles->velocityY, lanes + 3 * count, sizeof(float) * count);
+        memcpy(projectiles->monsterIndex, lanes + 4 * count, sizeof(int) * count);
+        memcpy(projectiles->owner, (const unsigned char*)(lanes + 5 * count), count);
+        projectiles->count = header->projectileCount;
+        projectiles->playerCount = header->playerProjectileCount;
+        projectiles->snapshotId = header->projectileSnapshotId;
+    }
+
+    if (!AssignEffects(&game->hitEffects, snapshot->data + layout.hitEffects, header->hitEffectCount) ||
+        !AssignEffects(&game->deathExplosions, snapshot->data + layout.deathExplosions, header->deathExplosionCount))
+        return false;
+
+    game->score = header->score;
+    game->gameTime = header->gameTime;
+    game->newProjectileCount = 0;
+    game->worldRandom = header->worldRandom;
+    game->aiRandom = header->aiRandom;
+    game->lastInput = header->lastInput;
+    RestorePlayer(&game->player, &header->player);
+
+    const SnapshotMonster* monsters = (const SnapshotMonster*)(snapshot->data + layout.monsters);
+    for (int m = 0; m < header->monsterCount; m++)
+    {
+        RestoreMonster(&game->monsters[m], &monsters[m]);
+    }
+    return true;
+}
+
+bool CopyGameSnapshot(GameSnapshot* destination, const GameSnapshot* source)
+{
+    if (!ReserveSnapshot(destination, source->size))
+        return false;
+
+    memcpy(destination->data, source->data, source->size);
+    destination->size = source->size;
+    return true;
+}
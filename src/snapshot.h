@@ -0,0 +1,33 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "main.h"
+
+// Copies of the simulation state for AIs and tools that fork the world, play it forward and go back.
+//
+// A snapshot holds what UpdateGameState reads and writes: score and time, the random generators, the player,
+// the monsters, the projectiles and the effect pools. Sprites, the AI hooks, the profiler and the per-tick scratch
+// structures are left out; restoring keeps whatever the target GameState has for them. Everything lives in one
+// block addressed by offsets, so a snapshot can be copied with memcpy, sent to another thread or written to disk.
+//
+// Projectiles are restored incrementally: a GameState remembers the snapshot its projectiles were last captured
+// into or restored from (ProjectileStore.snapshotId), and while nothing has moved, added or removed one since,
+// capturing and restoring skip the projectile lanes.
+typedef struct GameSnapshot
+{
+    unsigned char* data;    // Header followed by the sections, never reallocated once large enough
+    size_t size;
+    size_t capacity;
+} GameSnapshot;
+
+void InitGameSnapshot(GameSnapshot* snapshot);
+void FreeGameSnapshot(GameSnapshot* snapshot);
+
+// Both only allocate when the snapshot or the game's stores have to grow. Capturing takes a non-const game
+// because it tags the projectile store with the snapshot's id.
+bool CaptureGameSnapshot(GameSnapshot* snapshot, GameState* game);
+// The game must have been set up for the same scenario (monster count) as the captured one
+bool RestoreGameSnapshot(const GameSnapshot* snapshot, GameState* game);
+bool CopyGameSnapshot(GameSnapshot* destination, const GameSnapshot* source);
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,200 @@
+#include "sprite_batch.h"
+#include "rlgl.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Transparent gap between atlas regions so bilinear filtering never bleeds one sprite into another
+#define SPRITE_ATLAS_PADDING 2
+#define SPRITE_ATLAS_WHITE_SIZE 4
+
+bool LoadSpriteAtlas(SpriteAtlas* atlas, const char* playerPath, const char* monsterPath)
+{
+    memset(atlas, 0, sizeof(SpriteAtlas));
+
+    Image images[2] = { LoadImage(playerPath), LoadImage(monsterPath) };
+    Sprite* sprites[2] = { &atlas->player, &atlas->monster };
+
+    int width = SPRITE_ATLAS_WHITE_SIZE;
+    int height = SPRITE_ATLAS_WHITE_SIZE;
+    for (int i = 0; i < 2; i++)
+    {
+        if (images[i].data == NULL)
+            continue;
+        width += SPRITE_ATLAS_PADDING + images[i].width;
+        if (images[i].height > height)
+            height = images[i].height;
+    }
+
+    // Regions are laid out left to right: the white block, then each sprite that could be loaded
+    Image atlasImage = GenImageColor(width, height, BLANK);
+    ImageDrawRectangle(&atlasImage, 0, 0, SPRITE_ATLAS_WHITE_SIZE, SPRITE_ATLAS_WHITE_SIZE, WHITE);
+
+    Rectangle regions[2] = { 0 };
+    int x = SPRITE_ATLAS_WHITE_SIZE;
+    for (int i = 0; i < 2; i++)
+    {
+        if (images[i].data == NULL)
+            continue;
+        x += SPRITE_ATLAS_PADDING;
+        regions[i] = (Rectangle){ (float)x, 0, (float)images[i].width, (float)images[i].height };
+        ImageDraw(&atlasImage, images[i], (Rectangle){ 0, 0, (float)images[i].width, (float)images[i].height }, regions[i], WHITE);
+        x += images[i].width;
+    }
+
+    atlas->texture = LoadTextureFromImage(atlasImage);
+    UnloadImage(atlasImage);
+    if (atlas->texture.id == 0)
+    {
+        UnloadImage(images[0]);
+        UnloadImage(images[1]);
+        return false;
+    }
+
+    // Sample the middle of the white block so filtering never reaches the padding
+    atlas->white = (Sprite){ atlas->texture, { 1, 1, SPRITE_ATLAS_WHITE_SIZE - 2, SPRITE_ATLAS_WHITE_SIZE - 2 } };
+    for (int i = 0; i < 2; i++)
+    {
+        if (images[i].data != NULL)
+            *sprites[i] = (Sprite){ atlas->texture, regions[i] };
+        UnloadImage(images[i]);
+    }
+
+    return true;
+}
+
+void UnloadSpriteAtlas(SpriteAtlas* atlas)
+{
+    UnloadTexture(atlas->texture);
+    memset(atlas, 0, sizeof(SpriteAtlas));
+}
+
+bool InitSpriteBatch(SpriteBatch* batch, const SpriteAtlas* atlas, const int capacity)
+{
+    memset(batch, 0, sizeof(SpriteBatch));
+    batch->quads = (SpriteQuad*)malloc(sizeof(SpriteQuad) * (size_t)capacity);
+    if (!batch->quads)
+        return false;
+
+    batch->capacity = capacity;
+    batch->blendMode = BLEND_ALPHA;
+    batch->white = atlas->white;
+    return true;
+}
+
+void FreeSpriteBatch(SpriteBatch* batch)
+{
+    free(batch->quads);
+    memset(batch, 0, sizeof(SpriteBatch));
+}
+
+void SetSpriteBatchBlendMode(SpriteBatch* batch, const int blendMode)
+{
+    batch->blendMode = blendMode;
+}
+
+void DrawSpriteQuad(SpriteBatch* batch, const Texture2D texture, const Rectangle source, const Rectangle dest,
+                    const Vector2 origin, const float rotation, const Color tint)
+{
+    if (batch->count == batch->capacity)
+    {
+        const int capacity = batch->capacity > 0 ? batch->capacity * 2 : 64;
+        SpriteQuad* quads = (SpriteQuad*)realloc(batch->quads, sizeof(SpriteQuad) * (size_t)capacity);
+        if (!quads)
+            return;
+        batch->quads = quads;
+        batch->capacity = capacity;
+    }
+
+    batch->quads[batch->count] = (SpriteQuad){
+        texture, batch->blendMode, batch->count, source, dest, origin, rotation, tint
+    };
+    batch->count++;
+}
+
+void DrawSpriteRectangle(SpriteBatch* batch, const Rectangle rectangle, const Color color)
+{
+    DrawSpriteQuad(batch, batch->white.texture, batch->white.source, rectangle, (Vector2){ 0, 0 }, 0.0f, color);
+}
+
+int CompareSpriteQuads(const void* a, const void* b)
+{
+    const SpriteQuad* first = (const SpriteQuad*)a;
+    const SpriteQuad* second = (const SpriteQuad*)b;
+
+    if (first->blendMode != second->blendMode)
+        return first->blendMode < second->blendMode ? -1 : 1;
+    if (first->texture.id != second->texture.id)
+        return first->texture.id < second->texture.id ? -1 : 1;
+    return first->order - second->order;
+}
+
+// Same corner placement as DrawTexturePro
+void EmitSpriteQuad(const SpriteQuad* quad)
+{
+    const float width = (float)quad->texture.width;
+    const float height = (float)quad->texture.height;
+    const float left = quad->source.x / width;
+    const float right = (quad->source.x + quad->source.width) / width;
+    const float top = quad->source.y / height;
+    const float bottom = (quad->source.y + quad->source.height) / height;
+
+    const float sine = sinf(quad->rotation * DEG2RAD);
+    const float cosine = cosf(quad->rotation * DEG2RAD);
+    const float x = quad->dest.x;
+    const float y = quad->dest.y;
+    const float dx = -quad->origin.x;
+    const float dy = -quad->origin.y;
+    const float dw = dx + quad->dest.width;
+    const float dh = dy + quad->dest.height;
+
+    rlColor4ub(quad->tint.r, quad->tint.g, quad->tint.b, quad->tint.a);
+
+    rlTexCoord2f(left, top);
+    rlVertex2f(x + dx * cosine - dy * sine, y + dx * sine + dy * cosine);
+    rlTexCoord2f(left, bottom);
+    rlVertex2f(x + dx * cosine - dh * sine, y + dx * sine + dh * cosine);
+    rlTexCoord2f(right, bottom);
+    rlVertex2f(x + dw * cosine - dh * sine, y + dw * sine + dh * cosine);
+    rlTexCoord2f(right, top);
+    rlVertex2f(x + dw * cosine - dy * sine, y + dw * sine + dy * cosine);
+}
+
+void FlushSpriteBatch(SpriteBatch* batch)
+{
+    batch->drawCalls = 0;
+    if (batch->count == 0)
+        return;
+
+    qsort(batch->quads, (size_t)batch->count, sizeof(SpriteQuad), CompareSpriteQuads);
+
+    int runStart = 0;
+    while (runStart < batch->count)
+    {
+        const SpriteQuad* first = &batch->quads[runStart];
+        int runEnd = runStart + 1;
+        while (runEnd < batch->count &&
+               batch->quads[runEnd].blendMode == first->blendMode &&
+               batch->quads[runEnd].texture.id == first->texture.id)
+        {
+            runEnd++;
+        }
+
+        BeginBlendMode(first->blendMode);
+        rlSetTexture(first->texture.id);
+        rlBegin(RL_QUADS);
+        for (int i = runStart; i < runEnd; i++)
+        {
+            rlCheckRenderBatchLimit(4);
+            EmitSpriteQuad(&batch->quads[i]);
+        }
+        rlEnd();
+        rlSetTexture(0);
+        EndBlendMode();
+
+        batch->drawCalls++;
+        runStart = runEnd;
+    }
+
+    batch->count = 0;
+}
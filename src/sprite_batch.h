@@ -0,0 +1,59 @@
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include "raylib.h"
+
+// A region of a texture, usually of the sprite atlas. texture.id == 0 means there is no image to draw.
+typedef struct Sprite
+{
+    Texture2D texture;
+    Rectangle source;
+} Sprite;
+
+// Every entity sprite packed into one texture at load time, plus a white block for flat-colored quads
+typedef struct SpriteAtlas
+{
+    Texture2D texture;
+    Sprite player;
+    Sprite monster;
+    Sprite white;
+} SpriteAtlas;
+
+typedef struct SpriteQuad
+{
+    Texture2D texture;
+    int blendMode;
+    int order;          // Submission order, keeps the sort stable
+    Rectangle source;
+    Rectangle dest;
+    Vector2 origin;
+    float rotation;
+    Color tint;
+} SpriteQuad;
+
+// Collects the quads of one layer and draws them sorted by blend mode and texture, so a layer costs
+// one draw call per distinct (blend mode, texture) pair instead of one per sprite. Quads sharing both
+// keep the order they were submitted in.
+typedef struct SpriteBatch
+{
+    SpriteQuad* quads;
+    int count;
+    int capacity;
+    int blendMode;      // Applied to quads submitted from now on
+    Sprite white;       // Used by DrawSpriteRectangle
+    int drawCalls;      // Runs drawn by the last flush
+} SpriteBatch;
+
+bool LoadSpriteAtlas(SpriteAtlas* atlas, const char* playerPath, const char* monsterPath);
+void UnloadSpriteAtlas(SpriteAtlas* atlas);
+
+bool InitSpriteBatch(SpriteBatch* batch, const SpriteAtlas* atlas, int capacity);
+void FreeSpriteBatch(SpriteBatch* batch);
+void SetSpriteBatchBlendMode(SpriteBatch* batch, int blendMode);
+
+// Same parameters as DrawTexturePro, but the quad is only queued until FlushSpriteBatch
+void DrawSpriteQuad(SpriteBatch* batch, Texture2D texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint);
+void DrawSpriteRectangle(SpriteBatch* batch, Rectangle rectangle, Color color);
+void FlushSpriteBatch(SpriteBatch* batch);
+
+#endif // SPRITE_BATCH_H
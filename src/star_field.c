@@ -0,0 +1,93 @@
+#include "star_field.h"
+#include "main.h"
+#include "config.h"
+#include <math.h>
+#include <stddef.h>
+
+// Larger arenas are baked at a reduced scale; their stars end up smaller than a pixel on screen anyway
+#define STAR_FIELD_MAX_TEXTURE_SIZE 2048
+
+#ifdef PLATFORM_WEB
+static const char* g_starFieldFragmentShader =
+    "#version 100\n"
+    "precision mediump float;\n"
+    "varying vec2 fragTexCoord;\n"
+    "uniform sampler2D texture0;\n"
+    "uniform float time;\n"
+    "uniform vec3 blink;\n"
+    "void main()\n"
+    "{\n"
+    "    float stored = texture2D(texture0, fragTexCoord).a * 255.0;\n"
+    "    if (stored < 0.5) discard;\n"
+    "    float phase = (stored - 1.0) / 254.0 * 6.2831853;\n"
+    "    float factor = (sin(time * blink.x + phase) + 1.0) / 2.0;\n"
+    "    gl_FragColor = vec4(1.0, 1.0, 1.0, mix(blink.y, blink.z, factor));\n"
+    "}\n";
+#else
+static const char* g_starFieldFragmentShader =
+    "#version 330\n"
+    "in vec2 fragTexCoord;\n"
+    "uniform sampler2D texture0;\n"
+    "uniform float time;\n"
+    "uniform vec3 blink;\n"
+    "out vec4 finalColor;\n"
+    "void main()\n"
+    "{\n"
+    "    float stored = texture(texture0, fragTexCoord).a * 255.0;\n"
+    "    if (stored < 0.5) discard;\n"
+    "    float phase = (stored - 1.0) / 254.0 * 6.2831853;\n"
+    "    float factor = (sin(time * blink.x + phase) + 1.0) / 2.0;\n"
+    "    finalColor = vec4(1.0, 1.0, 1.0, mix(blink.y, blink.z, factor));\n"
+    "}\n";
+#endif
+
+// Alpha 0 marks empty sky, so phases are stored in 1..255
+unsigned char EncodeStarPhase(const float phase)
+{
+    float turns = phase / (2.0f * PI);
+    turns -= floorf(turns);
+    return (unsigned char)(1.0f + turns * 254.0f + 0.5f);
+}
+
+void LoadStarField(StarField* field, const GameState* game)
+{
+    const float arenaWidth = game->scenario.arenaWidth;
+    const float arenaHeight = game->scenario.arenaHeight;
+    const float scale = fminf(1.0f, STAR_FIELD_MAX_TEXTURE_SIZE / fmaxf(arenaWidth, arenaHeight));
+
+    Image image = GenImageColor((int)ceilf(arenaWidth * scale), (int)ceilf(arenaHeight * scale), BLANK);
+    for (int i = 0; i < game->scenario.starCount; i++)
+    {
+        const Star* star = &game->stars[i];
+        const int size = (int)fmaxf(1.0f, star->size * scale);
+        const Color color = { 255, 255, 255, EncodeStarPhase(star->phase) };
+        ImageDrawRectangle(&image, (int)(star->position.x * scale), (int)(star->position.y * scale), size, size, color);
+    }
+
+    field->texture = LoadTextureFromImage(image);
+    SetTextureFilter(field->texture, TEXTURE_FILTER_POINT);   // Phases must not be blended between stars
+    UnloadImage(image);
+
+    field->area = (Rectangle){ 0, 0, arenaWidth, arenaHeight };
+
+    field->shader = LoadShaderFromMemory(NULL, g_starFieldFragmentShader);
+    field->timeLocation = GetShaderLocation(field->shader, "time");
+    const float blink[3] = { STAR_BLINK_SPEED, STAR_OPACITY_MIN / 255.0f, STAR_OPACITY_MAX / 255.0f };
+    SetShaderValue(field->shader, GetShaderLocation(field->shader, "blink"), blink, SHADER_UNIFORM_VEC3);
+}
+
+void UnloadStarField(StarField* field)
+{
+    UnloadShader(field->shader);
+    UnloadTexture(field->texture);
+}
+
+void DrawStarField(const StarField* field, const float gameTime)
+{
+    SetShaderValue(field->shader, field->timeLocation, &gameTime, SHADER_UNIFORM_FLOAT);
+
+    const Rectangle source = { 0, 0, (float)field->texture.width, (float)field->texture.height };
+    BeginShaderMode(field->shader);
+    DrawTexturePro(field->texture, source, field->area, (Vector2){ 0, 0 }, 0.0f, WHITE);
+    EndShaderMode();
+}
@@ -0,0 +1,23 @@
+#ifndef STAR_FIELD_H
+#define STAR_FIELD_H
+
+#include "raylib.h"
+
+typedef struct GameState GameState;
+
+// The star background baked once into a texture. Each star pixel stores its twinkle phase in the
+// alpha channel and a fragment shader turns it into an opacity, so drawing the whole field is a
+// single textured quad whatever the star count.
+typedef struct StarField
+{
+    Texture2D texture;
+    Shader shader;
+    int timeLocation;
+    Rectangle area;     // Arena rectangle the texture is stretched over
+} StarField;
+
+void LoadStarField(StarField* field, const GameState* game);
+void UnloadStarField(StarField* field);
+void DrawStarField(const StarField* field, float gameTime);
+
+#endif // STAR_FIELD_H
@@ -3,30 +3,9 @@
 #include "config.h"
 #include "player.h"
 #include "monster.h"
+#include "replay.h"
 #include <math.h>
 
-void DrawStars(const GameState* game)
-{
-    for (int i = 0; i < STAR_COUNT; i++)
-    {
-        const Star* star = &game->stars[i];
-        
-        float blinkFactor = sinf(game->gameTime * STAR_BLINK_SPEED + star->phase);
-        blinkFactor = (blinkFactor + 1.0f) / 2.0f;
-
-        const int opacity = STAR_OPACITY_MIN + (int)(blinkFactor * (STAR_OPACITY_MAX - STAR_OPACITY_MIN));
-        const Color starColor = (Color){255, 255, 255, (unsigned char)opacity};
-        
-        for (int py = 0; py < star->size; py++)
-        {
-            for (int px = 0; px < star->size; px++)
-            {
-                DrawPixel((int)star->position.x + px, (int)star->position.y + py, starColor);
-            }
-        }
-    }
-}
-
 void DrawPlayerHealthBar(Player* player)
 {
     if (IsPlayerDead(player))
@@ -107,7 +86,11 @@ void DrawMonsterHealthBars(Monster* monsters, int monsterCount)
         {
             const int barWidth = 150;
             const int barHeight = 15;
-            const int barX = SCREEN_WIDTH - barWidth - 10;
+            const int barX = GetScreenWidth() - barWidth - 10;
+
+            // Large scenarios only list as many monsters as fit on screen
+            if (barY + barHeight > GetScreenHeight())
+                break;
             
             DrawRectangle(barX, barY, barWidth, barHeight, (Color){50, 50, 50, 200});
 
@@ -129,17 +112,20 @@ void DrawMonsterHealthBars(Monster* monsters, int monsterCount)
 
 void DrawGameOverScreen(int score)
 {
-    DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, (Color){0, 0, 0, 180});
+    const int screenWidth = GetScreenWidth();
+    const int screenHeight = GetScreenHeight();
+
+    DrawRectangle(0, 0, screenWidth, screenHeight, (Color){0, 0, 0, 180});
     
     const char* gameOverText = "Game Over";
     const int gameOverSize = 80;
     const int gameOverWidth = MeasureText(gameOverText, gameOverSize);
-    DrawText(gameOverText, (SCREEN_WIDTH - gameOverWidth) / 2, SCREEN_HEIGHT / 2 - 60, gameOverSize, RED);
+    DrawText(gameOverText, (screenWidth - gameOverWidth) / 2, screenHeight / 2 - 60, gameOverSize, RED);
     
     const char* scoreText = TextFormat("Score: %d", score);
     const int scoreSize = 40;
     const int scoreWidth = MeasureText(scoreText, scoreSize);
-    DrawText(scoreText, (SCREEN_WIDTH - scoreWidth) / 2, SCREEN_HEIGHT / 2 + 40, scoreSize, WHITE);
+    DrawText(scoreText, (screenWidth - scoreWidth) / 2, screenHeight / 2 + 40, scoreSize, WHITE);
 }
 
 bool AreAllMonstersFullyExploded(Monster* monsters, int monsterCount)
@@ -156,12 +142,15 @@ bool AreAllMonstersFullyExploded(Monster* monsters, int monsterCount)
 
 void DrawVictoryScreen(const int score, const float gameTime)
 {
-    DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, (Color){0, 0, 0, 180});
+    const int screenWidth = GetScreenWidth();
+    const int screenHeight = GetScreenHeight();
+
+    DrawRectangle(0, 0, screenWidth, screenHeight, (Color){0, 0, 0, 180});
     
     const char* victoryText = "Victory!";
     const int victorySize = 80;
     const int victoryWidth = MeasureText(victoryText, victorySize);
-    DrawText(victoryText, (SCREEN_WIDTH - victoryWidth) / 2, SCREEN_HEIGHT / 2 - 150, victorySize, GREEN);
+    DrawText(victoryText, (screenWidth - victoryWidth) / 2, screenHeight / 2 - 150, victorySize, GREEN);
 
     const int minutes = (int)(gameTime / 60.0f);
     const int seconds = (int)gameTime % 60;
@@ -169,12 +158,61 @@ void DrawVictoryScreen(const int score, const float gameTime)
     const char* timeText = TextFormat("%02d:%02d.%03d", minutes, seconds, milliseconds);
     const int timeSize = 70;
     const int timeWidth = MeasureText(timeText, timeSize);
-    DrawText(timeText, (SCREEN_WIDTH - timeWidth) / 2, SCREEN_HEIGHT / 2 - 50, timeSize, YELLOW);
+    DrawText(timeText, (screenWidth - timeWidth) / 2, screenHeight / 2 - 50, timeSize, YELLOW);
     
     const char* scoreText = TextFormat("Score: %d", score);
     const int scoreSize = 40;
     const int scoreWidth = MeasureText(scoreText, scoreSize);
-    DrawText(scoreText, (SCREEN_WIDTH - scoreWidth) / 2, SCREEN_HEIGHT / 2 + 60, scoreSize, WHITE);
+    DrawText(scoreText, (screenWidth - scoreWidth) / 2, screenHeight / 2 + 60, scoreSize, WHITE);
+}
+
+void DrawProfilerOverlay(const Profiler* profiler)
+{
+    const int x = 10;
+    const int y = 10 + 20 + 5 + 8 + 10 + 80;
+    const int rowHeight = 14;
+    const int fontSize = 12;
+    const int averageX = x + 130;
+    const int p99X = x + 200;
+
+    DrawRectangle(x - 5, y - 5, 260, (PROFILE_PHASE_COUNT + 2) * rowHeight + 10, (Color){0, 0, 0, 180});
+    DrawText("phase (us)", x, y, fontSize, LIGHTGRAY);
+    DrawText("avg", averageX, y, fontSize, LIGHTGRAY);
+    DrawText("p99", p99X, y, fontSize, LIGHTGRAY);
+
+    // The whole frame comes last, under the phases it contains
+    for (int phase = 0; phase <= PROFILE_PHASE_COUNT; phase++)
+    {
+        const ProfilerStats stats = GetProfilerStats(profiler, phase);
+        const int rowY = y + (phase + 1) * rowHeight;
+        const Color color = phase == PROFILE_PHASE_COUNT ? YELLOW : WHITE;
+        DrawText(GetProfilerPhaseName(phase), x, rowY, fontSize, color);
+        DrawText(TextFormat("%.1f", stats.averageMs * 1000.0f), averageX, rowY, fontSize, color);
+        DrawText(TextFormat("%.1f", stats.p99Ms * 1000.0f), p99X, rowY, fontSize, color);
+    }
+}
+
+void DrawReplayBar(const ReplayPlayer* player, const float speed, const bool paused)
+{
+    const int barHeight = 8;
+    const int x = 10;
+    const int width = GetScreenWidth() - 2 * x;
+    const int barY = GetScreenHeight() - barHeight - 10;
+    const int textY = barY - 20;
+    const long tickCount = player->replay->tickCount;
+
+    DrawRectangle(x, barY, width, barHeight, (Color){50, 50, 50, 200});
+    if (tickCount > 0)
+        DrawRectangle(x, barY, (int)((float)width * (float)player->tick / (float)tickCount), barHeight, SKYBLUE);
+    DrawRectangleLines(x, barY, width, barHeight, WHITE);
+
+    DrawText(TextFormat("Replay  tick %ld / %ld  x%g%s", player->tick, tickCount, speed, paused ? "  paused" : ""),
+        x, textY, 16, WHITE);
+    if (player->divergedTick >= 0)
+        DrawText(TextFormat("diverged from the recording at tick %ld", player->divergedTick), x + 360, textY, 16, RED);
+
+    const char* help = "Space pause  Left/Right seek  Home/End  Up/Down speed";
+    DrawText(help, x + width - MeasureText(help, 12), textY + 4, 12, LIGHTGRAY);
 }
 
 void DrawUI(GameState* game)
@@ -182,10 +220,13 @@ void DrawUI(GameState* game)
     DrawPlayerHealthBar(&game->player);
     DrawPlayerCooldownBar(&game->player);
     DrawGameInfo(game->score, game->gameTime);
-    DrawMonsterHealthBars(game->monsters, MONSTER_COUNT);
+    DrawMonsterHealthBars(game->monsters, game->scenario.monsterCount);
+
+    if (game->profiler && game->profiler->overlayVisible)
+        DrawProfilerOverlay(game->profiler);
     
     if (IsPlayerFullyExploded(&game->player))
         DrawGameOverScreen(game->score);
-    else if (AreAllMonstersFullyExploded(game->monsters, MONSTER_COUNT))
+    else if (AreAllMonstersFullyExploded(game->monsters, game->scenario.monsterCount))
         DrawVictoryScreen(game->score, game->gameTime);
 }
@@ -4,8 +4,9 @@
 #include "raylib.h"
 
 typedef struct GameState GameState;
+typedef struct ReplayPlayer ReplayPlayer;
 
 void DrawUI(GameState* game);
-void DrawStars(const GameState* game);
+void DrawReplayBar(const ReplayPlayer* player, float speed, bool paused);
 
 #endif // UI_H
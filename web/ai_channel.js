@@ -0,0 +1,46 @@
+// Layout of the SharedArrayBuffer channel between the game page and player_ai_worker.js, in 32-bit words.
+// Contexts are double-buffered (the page writes slot sequence % 2, then publishes the sequence) and so are
+// commands (the worker writes the slot that is not published, then flips COMMAND_PUBLISHED).
+const AIChannel = {
+    CONTEXT_SEQUENCE: 0,    // Newest context published by the page
+    COMMAND_PUBLISHED: 1,   // Command slot holding the newest commands
+    COMMAND_SEQUENCE: 2,    // Number of command sets published by the worker
+    COMMAND_SLOTS: 8,       // Two slots of COMMAND_WORDS words
+    COMMAND_WORDS: 8,       // contextSequence, flags, left thruster, right thruster, shoot direction
+    CONTEXT_SLOTS: 24,      // Two context slots of `capacity` words each
+
+    // Context block layout, see WebAIContextBlock in player_ai_web.c
+    HEADER_WORDS: 16,
+    MONSTER_WORDS: 8,
+    VISIBLE_MONSTER_COUNT: 6,
+    COMMAND_FLAGS: 8,
+    LEFT_THRUSTER: 9,
+    RIGHT_THRUSTER: 10,
+    SHOOT_DIRECTION: 11,
+
+    create(capacity) {
+        return AIChannel.wrap(new SharedArrayBuffer(4 * (AIChannel.CONTEXT_SLOTS + 2 * capacity)));
+    },
+
+    wrap(shared) {
+        return {
+            shared: shared,
+            ints: new Int32Array(shared),
+            floats: new Float32Array(shared),
+            capacity: (shared.byteLength / 4 - AIChannel.CONTEXT_SLOTS) / 2
+        };
+    },
+
+    contextOffset(channel, sequence) {
+        return AIChannel.CONTEXT_SLOTS + (sequence % 2) * channel.capacity;
+    },
+
+    commandOffset(slot) {
+        return AIChannel.COMMAND_SLOTS + slot * AIChannel.COMMAND_WORDS;
+    },
+
+    // Words of a context block actually in use for the given number of visible monsters
+    usedWords(monsterCount) {
+        return AIChannel.HEADER_WORDS + monsterCount * AIChannel.MONSTER_WORDS;
+    }
+};
@@ -0,0 +1,288 @@
+// Hosts the player's Python AI off the main thread, so a slow on_player_update never stalls rendering or input.
+// Messages from the page:
+//   {type: 'load', code}          run the user's code          -> {type: 'loaded', ok, error}
+//   {type: 'bind', shared}        SharedArrayBuffer channel (see ai_channel.js)
+//   {type: 'tick'}                run once on the newest context in the channel, then publish commands there
+//   {type: 'context', sequence, words}
+//                                 fallback when SharedArrayBuffer is unavailable -> {type: 'commands', ...}
+// Python errors are reported as {type: 'error', message}.
+importScripts('https://cdn.jsdelivr.net/pyodide/v0.24.1/full/pyodide.js', 'ai_channel.js');
+
+const bridgeSource = `
+import math
+import sys
+import js
+from types import ModuleType
+
+# Redirect Python print to JavaScript console.log
+class JSConsole:
+    def write(self, text):
+        if text and text.strip():
+            js.console.log(text.rstrip())
+    def flush(self):
+        pass
+
+sys.stdout = JSConsole()
+sys.stderr = JSConsole()
+
+# Binary context bridge. Every tick the game fills a fixed-layout block (WebAIContextBlock in player_ai_web.c),
+# which this worker copies into a local buffer that Python reads in place through typed-array views; commands are
+# written back into the same buffer. The context object is reused from tick to tick and is only valid during
+# on_player_update.
+_HEADER_WORDS = 16
+_MONSTER_WORDS = 8
+_VISIBLE_MONSTER_COUNT = 6
+_COMMAND_FLAGS = 8
+_LEFT_THRUSTER = 9
+_RIGHT_THRUSTER = 10
+_SHOOT_DIRECTION = 11
+_COMMAND_THRUSTERS = 1
+_COMMAND_SHOOT = 2
+_PROJECTILE_SIZE = 10.0     # PROJECTILE_SIZE and PROJECTILE_SPEED in config.h
+_PROJECTILE_SPEED = 400.0
+
+class _Block:
+    floats = None
+    ints = None
+
+_block = _Block()
+
+class _Vector:
+    __slots__ = ('_index',)
+    def __init__(self, index):
+        self._index = index
+    def __getitem__(self, key):
+        if key == 'x':
+            return _block.floats[self._index]
+        if key == 'y':
+            return _block.floats[self._index + 1]
+        raise KeyError(key)
+
+class _Monster:
+    __slots__ = ('_base',)
+    def __init__(self, base):
+        self._base = base
+    def __getitem__(self, key):
+        if key == 'position':
+            return _Vector(self._base)
+        if key == 'size':
+            return _block.floats[self._base + 2]
+        if key == 'health':
+            return _block.floats[self._base + 3]
+        if key == 'invincible':
+            return _block.floats[self._base + 4] != 0.0
+        if key == 'distance':
+            return _block.floats[self._base + 5]
+        if key == 'bearing':
+            return _block.floats[self._base + 6]
+        if key == 'relativeAngle':
+            return _block.floats[self._base + 7]
+        raise KeyError(key)
+
+class _Monsters:
+    def __len__(self):
+        return _block.ints[_VISIBLE_MONSTER_COUNT]
+    def __getitem__(self, index):
+        count = len(self)
+        if index < 0:
+            index += count
+        if not 0 <= index < count:
+            raise IndexError(index)
+        return _Monster(_HEADER_WORDS + index * _MONSTER_WORDS)
+    def __iter__(self):
+        for index in range(len(self)):
+            yield self[index]
+
+class _Context:
+    _fields = ('playerPosition', 'playerVelocity', 'playerRotation', 'deltaTime', 'visibleMonsterCount', 'visibleMonsters')
+    def __init__(self):
+        self._monsters = _Monsters()
+    def __getitem__(self, key):
+        if key == 'playerPosition':
+            return _Vector(0)
+        if key == 'playerVelocity':
+            return _Vector(2)
+        if key == 'playerRotation':
+            return _block.floats[4]
+        if key == 'deltaTime':
+            return _block.floats[5]
+        if key == 'visibleMonsterCount':
+            return _block.ints[_VISIBLE_MONSTER_COUNT]
+        if key == 'visibleMonsters':
+            return self._monsters
+        raise KeyError(key)
+    def __contains__(self, key):
+        return key in self._fields
+    def get(self, key, default=None):
+        return self[key] if key in self._fields else default
+
+_context = _Context()
+
+def _bind_context_block(floats, ints):
+    _block.floats = floats
+    _block.ints = ints
+
+def _run_player_update():
+    on_player_update(_context)
+
+# Create player_ai_c module
+player_ai_c_module = ModuleType('player_ai_c')
+def shoot(direction):
+    _block.ints[_SHOOT_DIRECTION] = int(direction)
+    _block.ints[_COMMAND_FLAGS] = _block.ints[_COMMAND_FLAGS] | _COMMAND_SHOOT
+def set_thrusters(left_power, right_power):
+    _block.floats[_LEFT_THRUSTER] = float(left_power)
+    _block.floats[_RIGHT_THRUSTER] = float(right_power)
+    _block.ints[_COMMAND_FLAGS] = _block.ints[_COMMAND_FLAGS] | _COMMAND_THRUSTERS
+# Same slab test as line_of_fire.c, against the monsters in the block
+def _cast_ray(angle):
+    floats = _block.floats
+    origin_x = floats[0]
+    origin_y = floats[1]
+    radians = math.radians(angle)
+    direction_x = math.cos(radians)
+    direction_y = math.sin(radians)
+    inverse_x = 1.0 / direction_x if abs(direction_x) >= 1e-12 else math.copysign(1e12, direction_x)
+    inverse_y = 1.0 / direction_y if abs(direction_y) >= 1e-12 else math.copysign(1e12, direction_y)
+    best = None
+    best_distance = math.inf
+    for index in range(_block.ints[_VISIBLE_MONSTER_COUNT]):
+        base = _HEADER_WORDS + index * _MONSTER_WORDS
+        if floats[base + 4] != 0.0:
+            continue
+        half = (floats[base + 2] + _PROJECTILE_SIZE) / 2
+        x1 = (floats[base] - half - origin_x) * inverse_x
+        x2 = (floats[base] + half - origin_x) * inverse_x
+        y1 = (floats[base + 1] - half - origin_y) * inverse_y
+        y2 = (floats[base + 1] + half - origin_y) * inverse_y
+        entry = max(min(x1, x2), min(y1, y2), 0.0)
+        if entry <= min(max(x1, x2), max(y1, y2)) and entry < best_distance:
+            best = index
+            best_distance = entry
+    if best is None:
+        return {'monster': None, 'distance': 0.0, 'timeToImpact': -1.0}
+    return {'monster': best, 'distance': best_distance, 'timeToImpact': best_distance / _PROJECTILE_SPEED}
+def cast_rays(angles):
+    return [_cast_ray(float(angle)) for angle in angles]
+def cast_shots():
+    rotation = _block.floats[4]
+    return cast_rays((rotation, rotation - 90.0, rotation + 90.0))
+# The forecast plays the engine's own rules, which live on the page rather than in this worker
+def forecast(commands):
+    raise NotImplementedError('player_ai_c.forecast is only available on desktop')
+player_ai_c_module.shoot = shoot
+player_ai_c_module.set_thrusters = set_thrusters
+player_ai_c_module.cast_rays = cast_rays
+player_ai_c_module.cast_shots = cast_shots
+player_ai_c_module.forecast = forecast
+sys.modules['player_ai_c'] = player_ai_c_module
+`;
+
+let pyodide = null;
+let runPlayerUpdate = null;
+let bindContextBlock = null;
+let channel = null;
+let local = null;   // Worker-side copy of the context block that Python reads and writes
+
+function reserveLocalWords(wordCount) {
+    if (local && local.ints.length >= wordCount) return;
+    const buffer = new ArrayBuffer(4 * Math.max(wordCount, local ? local.ints.length * 2 : 1024));
+    local = { ints: new Int32Array(buffer), floats: new Float32Array(buffer) };
+    bindContextBlock(local.floats, local.ints);
+}
+
+// Runs the user's update on the local copy and returns the commands it issued
+function runUpdate(contextSequence) {
+    local.ints[AIChannel.COMMAND_FLAGS] = 0;
+    try {
+        runPlayerUpdate();
+    } catch (error) {
+        local.ints[AIChannel.COMMAND_FLAGS] = 0;
+        postMessage({ type: 'error', message: error.message });
+    }
+    return {
+        contextSequence: contextSequence,
+        flags: local.ints[AIChannel.COMMAND_FLAGS],
+        left: local.floats[AIChannel.LEFT_THRUSTER],
+        right: local.floats[AIChannel.RIGHT_THRUSTER],
+        direction: local.ints[AIChannel.SHOOT_DIRECTION]
+    };
+}
+
+// Copies the newest context out of the shared channel. The page only ever overwrites the slot it is not
+// publishing, so the copy is clean unless two more contexts were published meanwhile; then it is retried.
+function copySharedContext() {
+    for (;;) {
+        const sequence = Atomics.load(channel.ints, AIChannel.CONTEXT_SEQUENCE);
+        const offset = AIChannel.contextOffset(channel, sequence);
+        const monsterCount = channel.ints[offset + AIChannel.VISIBLE_MONSTER_COUNT];
+        const maxMonsters = (channel.capacity - AIChannel.HEADER_WORDS) / AIChannel.MONSTER_WORDS;
+        const used = AIChannel.usedWords(Math.max(0, Math.min(monsterCount, maxMonsters)));
+
+        reserveLocalWords(used);
+        local.ints.set(channel.ints.subarray(offset, offset + used));
+
+        if (Atomics.load(channel.ints, AIChannel.CONTEXT_SEQUENCE) - sequence < 2) {
+            return sequence;
+        }
+    }
+}
+
+function publishCommands(commands) {
+    const slot = 1 - Atomics.load(channel.ints, AIChannel.COMMAND_PUBLISHED);
+    const offset = AIChannel.commandOffset(slot);
+    channel.ints[offset] = commands.contextSequence;
+    channel.ints[offset + 1] = commands.flags;
+    channel.floats[offset + 2] = commands.left;
+    channel.floats[offset + 3] = commands.right;
+    channel.ints[offset + 4] = commands.direction;
+    Atomics.store(channel.ints, AIChannel.COMMAND_PUBLISHED, slot);
+    Atomics.add(channel.ints, AIChannel.COMMAND_SEQUENCE, 1);
+}
+
+const ready = (async function () {
+    pyodide = await loadPyodide();
+    pyodide.runPython(bridgeSource);
+    bindContextBlock = pyodide.globals.get('_bind_context_block');
+    runPlayerUpdate = pyodide.globals.get('_run_player_update');
+    reserveLocalWords(1024);
+})();
+
+ready.then(
+    () => postMessage({ type: 'ready' }),
+    (error) => postMessage({ type: 'failed', message: error.message })
+);
+
+onmessage = async function (event) {
+    const message = event.data;
+    await ready;
+
+    switch (message.type) {
+        case 'load':
+            try {
+                pyodide.runPython(message.code);
+                const hasFunc = pyodide.runPython(`'on_player_update' in globals() and callable(on_player_update)`);
+                if (!hasFunc) {
+                    throw new Error('Code must define on_player_update(context) function');
+                }
+                postMessage({ type: 'loaded', ok: true });
+            } catch (error) {
+                postMessage({ type: 'loaded', ok: false, error: error.message });
+            }
+            break;
+        case 'bind':
+            channel = AIChannel.wrap(message.shared);
+            break;
+        case 'tick':
+            if (channel) {
+                const sequence = copySharedContext();
+                publishCommands(runUpdate(sequence));
+            }
+            break;
+        case 'context':
+            reserveLocalWords(message.words.length);
+            local.ints.set(message.words);
+            postMessage(Object.assign({ type: 'commands' }, runUpdate(message.sequence)));
+            break;
+    }
+};
@@ -0,0 +1,20 @@
+"""Serves the web build with the cross-origin isolation headers that SharedArrayBuffer requires.
+
+Without them the page still works, but the Python AI worker falls back to message copies.
+Usage: python serve.py [port]
+"""
+import http.server
+import sys
+
+
+class IsolatedRequestHandler(http.server.SimpleHTTPRequestHandler):
+    def end_headers(self):
+        self.send_header("Cross-Origin-Opener-Policy", "same-origin")
+        # credentialless (rather than require-corp) keeps the CDN scripts loadable
+        self.send_header("Cross-Origin-Embedder-Policy", "credentialless")
+        super().end_headers()
+
+
+if __name__ == "__main__":
+    port = int(sys.argv[1]) if len(sys.argv) > 1 else 8000
+    http.server.ThreadingHTTPServer(("", port), IsolatedRequestHandler).serve_forever()
@@ -8,10 +8,26 @@ set_languages("c11")
 add_requires("raylib 5.5")
 
 option("ai_backend")
-    set_values("c")
-    set_description("Choose the player AI backend (c or python)")
+    set_default("c")
+    set_values("c", "python")
+    set_showmenu(true)
+    set_description("Choose the desktop and headless player AI backend (c or python, which embeds CPython)")
 option_end()
 
+if is_config("ai_backend", "python") and not is_arch("wasm", "wasm32") then
+    add_requires("python 3.x", {system = true})
+end
+
+option("avx")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Build the SIMD simulation kernels for AVX instead of SSE2 (the binary then requires an AVX CPU)")
+option_end()
+
+if has_config("avx") and not is_arch("wasm", "wasm32") then
+    add_vectorexts("avx")
+end
+
 target("espace-confiote", function()
     set_kind("binary")
 
@@ -22,6 +38,7 @@ target("espace-confiote", function()
     
     if is_web then
         add_defines("USE_PYTHON_AI", "PLATFORM_WEB")
+        add_cflags("-msimd128", {force = true})
         add_files("src/*.c", {excludes = {"src/player_ai_backend/*.c"}})
         add_files("src/player_ai_backend/player_ai_web.c")
 
@@ -31,8 +48,9 @@ target("espace-confiote", function()
         add_ldflags("-sALLOW_MEMORY_GROWTH=1", {force = true})
         add_ldflags("-sASYNCIFY", {force = true})
         add_ldflags("-sEXPORTED_RUNTIME_METHODS=['ccall','cwrap']", {force = true})
-        add_ldflags("-sEXPORTED_FUNCTIONS=['_main','_malloc','_free','_web_player_shoot','_web_player_set_thrusters']", {force = true})
+        add_ldflags("-sEXPORTED_FUNCTIONS=['_main','_malloc','_free']", {force = true})
         add_ldflags("-O2", {force = true})
+        add_ldflags("-msimd128", {force = true})
 
         -- Resource preloading during linking
         on_load(function (target)
@@ -73,19 +91,112 @@ target("espace-confiote", function()
             if os.isfile("$(projectdir)/web/index.html") then
                 os.cp("$(projectdir)/web/index.html", "$(projectdir)/build/web/")
             end
+            os.cp("$(projectdir)/web/*.js", "$(projectdir)/build/web/")
+            os.cp("$(projectdir)/web/serve.py", "$(projectdir)/build/web/")
         end)
     else
         add_files("src/*.c", {excludes = {"src/player_ai_backend/*.c"}})
         
-        local ai_backend = get_config("ai_backend")
+        if is_config("ai_backend", "python") then
+            add_files("src/player_ai_backend/player_ai_python.c")
+            add_defines("USE_PYTHON_AI")
+            add_packages("python")
+        else
+            add_files("src/player_ai_backend/player_ai_c.c")
+            add_defines("USE_C_AI")
+        end
 
-        add_files("src/player_ai_backend/player_ai_c.c")
-        add_defines("USE_C_AI")
+        -- AI libraries loaded with --ai call back into the player API of the executable
+        if is_plat("linux", "bsd") then
+            add_ldflags("-rdynamic")
+            add_syslinks("dl")
+        end
 
         set_targetdir("$(projectdir)/build")
         
         after_build(function (target)
             os.cp("$(projectdir)/resources", "$(projectdir)/build/")
+            if is_config("ai_backend", "python") then
+                os.cp("$(projectdir)/player_ai.py", "$(projectdir)/build/")
+            end
         end)
     end
-end)
\ No newline at end of file
+end)
+
+-- Headless simulation: the game logic without a window, textures or GL context.
+-- Links against a stand-in raylib.h (src/headless) so it does not need raylib at all.
+if not is_arch("wasm", "wasm32") then
+    target("espace-confiote-headless-core", function()
+        set_kind("static")
+
+        add_defines("HEADLESS", {public = true})
+        add_includedirs("src/headless", {public = true})
+        add_files("src/game.c", "src/scenario.c", "src/effect_pool.c", "src/frame_arena.c", "src/line_of_fire.c", "src/forecast.c", "src/environment.c", "src/profiler.c", "src/replay.c", "src/random.c", "src/snapshot.c", "src/projectile_store.c", "src/collision_grid.c", "src/player.c", "src/monster.c")
+
+        if is_plat("linux", "bsd") then
+            add_syslinks("m", {public = true})
+        end
+    end)
+
+    target("espace-confiote-headless", function()
+        set_kind("binary")
+        add_deps("espace-confiote-headless-core")
+
+        add_files("src/headless/headless_main.c", "src/headless/tournament.c", "src/player_ai_library.c")
+        if is_config("ai_backend", "python") then
+            add_files("src/player_ai_backend/player_ai_python.c")
+            add_defines("USE_PYTHON_AI")
+            add_packages("python")
+        else
+            add_files("src/player_ai_backend/player_ai_c.c")
+            add_defines("USE_C_AI")
+        end
+
+        if is_plat("linux", "bsd", "macosx") then
+            add_syslinks("pthread")
+        end
+        if is_plat("linux", "bsd") then
+            add_ldflags("-rdynamic")
+            add_syslinks("dl")
+        end
+
+        set_targetdir("$(projectdir)/build")
+    end)
+
+    -- The C AI as a shared library, for --ai: rebuild it while the game runs and the game picks it up.
+    -- Built against the raylib.h stand-in so it does not link a second copy of raylib.
+    target("player_ai", function()
+        set_kind("shared")
+        set_symbols("hidden")
+
+        add_defines("HEADLESS")
+        add_includedirs("src/headless")
+        add_files("src/player_ai_backend/player_ai_c.c")
+
+        if is_plat("macosx") then
+            add_shflags("-undefined dynamic_lookup")
+        elseif is_plat("linux", "bsd") then
+            add_syslinks("m")
+        end
+
+        set_targetdir("$(projectdir)/build")
+    end)
+
+    -- Micro-benchmarks of the simulation kernels, printed as JSON lines
+    target("bench", function()
+        set_kind("binary")
+        set_default(false)
+        add_deps("espace-confiote-headless-core")
+
+        add_files("src/bench/*.c")
+        add_files("src/player_ai_backend/player_ai_c.c")
+
+        -- Counts the game's heap allocations by routing them through src/bench/bench_allocations.c
+        if is_plat("linux") then
+            add_defines("BENCH_COUNT_ALLOCATIONS")
+            add_ldflags("-Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc", {force = true})
+        end
+
+        set_targetdir("$(projectdir)/build")
+    end)
+end